@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include "hash.hpp"
 #include "type.hpp"
 #include "qual_type.hpp"
 #include <cassert>
@@ -36,12 +37,14 @@ public:
     array_or_vector_type(type_t * b, uint64_t sz):
     base_{b}, size_{sz} {
         assert(base_ && "Array element type should not be null");
-        base_->add_use(this);
+        base_->add_use(this, base_use_link_);
     }
 
     /// Destructor, removes use of element type
     ~array_or_vector_type() override {
-        base_->remove_use(this);
+        if (!entity_teardown_scope::active()) {
+            base_->remove_use(base_use_link_);
+        }
     }
 
     /// Returns type of array or vector element
@@ -65,8 +68,9 @@ public:
     }
 
 private:
-    type_t * base_;         ///< Type of array element
-    uint64_t size_;         ///< Array size
+    type_t * base_;                     ///< Type of array element
+    uint64_t size_;                     ///< Array size
+    entity_use_link base_use_link_;     ///< Link in the list of uses of element type
 };
 
 
@@ -76,8 +80,7 @@ struct array_or_vector_type_id_hash {
     using result_type = size_t;
     result_type operator()(argument_type arg) const {
         auto res = static_cast<size_t>(reinterpret_cast<intptr_t>(arg.type));
-        res |= arg.size;
-        return res;
+        return hash_combine(res, arg.size);
     }
 };
 
@@ -20,8 +20,11 @@ using array_type_id = array_or_vector_type_id;
 
 
 /// Represents array type in code model
-class array_type: public array_or_vector_type {
+class array_type final: public array_or_vector_type {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::array_type; }
+
     /// Constructor, makes array type with specified element
     /// type and size
     array_type(type_t * b, uint64_t sz):
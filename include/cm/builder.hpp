@@ -680,49 +680,17 @@ public:
     }
 
     /// Gets existing or creates new source file object in code model
-    const source_file * source(const std::string & nm) {
+    const source_file * source(std::string_view nm) {
         return cm_.source(nm);
     }
 
 
     // Builtin type accessors
 
-#define CM_BUILDER_BT_ACCESSOR(name) \
+#define CM_BUILDER_BT_ACCESSOR(name, str) \
     builtin_type * bt_##name() const { return cm_.bt_##name(); }
 
-    CM_BUILDER_BT_ACCESSOR(void)
-    CM_BUILDER_BT_ACCESSOR(bool)
-    CM_BUILDER_BT_ACCESSOR(char)
-    CM_BUILDER_BT_ACCESSOR(short)
-    CM_BUILDER_BT_ACCESSOR(int)
-    CM_BUILDER_BT_ACCESSOR(long)
-    CM_BUILDER_BT_ACCESSOR(long_long)
-    CM_BUILDER_BT_ACCESSOR(unsigned_char)
-    CM_BUILDER_BT_ACCESSOR(unsigned_short)
-    CM_BUILDER_BT_ACCESSOR(unsigned_int)
-    CM_BUILDER_BT_ACCESSOR(unsigned_long)
-    CM_BUILDER_BT_ACCESSOR(unsigned_long_long)
-    CM_BUILDER_BT_ACCESSOR(float)
-    CM_BUILDER_BT_ACCESSOR(double)
-    CM_BUILDER_BT_ACCESSOR(long_double)
-
-    CM_BUILDER_BT_ACCESSOR(wchar_t)
-    CM_BUILDER_BT_ACCESSOR(char16_t)
-    CM_BUILDER_BT_ACCESSOR(char32_t)
-
-    CM_BUILDER_BT_ACCESSOR(complex_char)
-    CM_BUILDER_BT_ACCESSOR(complex_short)
-    CM_BUILDER_BT_ACCESSOR(complex_int)
-    CM_BUILDER_BT_ACCESSOR(complex_long)
-    CM_BUILDER_BT_ACCESSOR(complex_long_long)
-    CM_BUILDER_BT_ACCESSOR(complex_unsigned_char)
-    CM_BUILDER_BT_ACCESSOR(complex_unsigned_short)
-    CM_BUILDER_BT_ACCESSOR(complex_unsigned_int)
-    CM_BUILDER_BT_ACCESSOR(complex_unsigned_long)
-    CM_BUILDER_BT_ACCESSOR(complex_unsigned_long_long)
-    CM_BUILDER_BT_ACCESSOR(complex_float)
-    CM_BUILDER_BT_ACCESSOR(complex_double)
-    CM_BUILDER_BT_ACCESSOR(complex_long_double)
+    CM_BUILTIN_TYPES(CM_BUILDER_BT_ACCESSOR)
 
 #undef CM_BUILDER_BT_ACCESSOR
 
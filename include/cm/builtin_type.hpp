@@ -10,6 +10,9 @@
 #pragma once
 
 #include "type.hpp"
+#include <cassert>
+#include <cstddef>
+#include <iterator>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -18,125 +21,142 @@
 namespace cm {
 
 
+/// List of builtin types in order of their kinds. Invokes macro X with
+/// kind of builtin type without trailing underscore and name of builtin type
+/// for each builtin type. Kinds, names and accessors of builtin types are
+/// generated from this list.
+#define CM_BUILTIN_TYPES(X) \
+    X(void,                        "void") \
+    X(bool,                        "bool") \
+    X(char,                        "char") \
+    X(short,                       "short") \
+    X(int,                         "int") \
+    X(long,                        "long") \
+    X(long_long,                   "long long") \
+    X(int128,                      "int128") \
+    X(signed_char,                 "signed char") \
+    X(unsigned_char,               "unsigned char") \
+    X(unsigned_short,              "unsigned short") \
+    X(unsigned_int,                "unsigned int") \
+    X(unsigned_long,               "unsigned long") \
+    X(unsigned_long_long,          "unsigned long long") \
+    X(uint128,                     "uint128") \
+    X(float,                       "float") \
+    X(double,                      "double") \
+    X(long_double,                 "long double") \
+    X(wchar_t,                     "wchar_t") \
+    X(char8_t,                     "char8_t") \
+    X(char16_t,                    "char16_t") \
+    X(char32_t,                    "char32_t") \
+    X(nullptr_t,                   "nullptr_t") \
+    X(complex_char,                "char complex") \
+    X(complex_short,               "short complex") \
+    X(complex_int,                 "int complex") \
+    X(complex_long,                "long complex") \
+    X(complex_long_long,           "long long complex") \
+    X(complex_unsigned_char,       "unsigned char complex") \
+    X(complex_unsigned_short,      "unsigned short complex") \
+    X(complex_unsigned_int,        "unsigned int complex") \
+    X(complex_unsigned_long,       "unsigned long complex") \
+    X(complex_unsigned_long_long,  "unsigned long long complex") \
+    X(complex_float,               "float complex") \
+    X(complex_double,              "double complex") \
+    X(complex_long_double,         "long double complex") \
+    X(arm_sve_int8x1,              "svint8x1") \
+    X(arm_sve_int8x2,              "svint8x2") \
+    X(arm_sve_int8x3,              "svint8x3") \
+    X(arm_sve_int8x4,              "svint8x4") \
+    X(arm_sve_int16x1,             "svint16x1") \
+    X(arm_sve_int16x2,             "svint16x2") \
+    X(arm_sve_int16x3,             "svint16x3") \
+    X(arm_sve_int16x4,             "svint16x4") \
+    X(arm_sve_int32x1,             "svint32x1") \
+    X(arm_sve_int32x2,             "svint32x2") \
+    X(arm_sve_int32x3,             "svint32x3") \
+    X(arm_sve_int32x4,             "svint32x4") \
+    X(arm_sve_int64x1,             "svint64x1") \
+    X(arm_sve_int64x2,             "svint64x2") \
+    X(arm_sve_int64x3,             "svint64x3") \
+    X(arm_sve_int64x4,             "svint64x4") \
+    X(arm_sve_uint8x1,             "svuint8x1") \
+    X(arm_sve_uint8x2,             "svuint8x2") \
+    X(arm_sve_uint8x3,             "svuint8x3") \
+    X(arm_sve_uint8x4,             "svuint8x4") \
+    X(arm_sve_uint16x1,            "svuint16x1") \
+    X(arm_sve_uint16x2,            "svuint16x2") \
+    X(arm_sve_uint16x3,            "svuint16x3") \
+    X(arm_sve_uint16x4,            "svuint16x4") \
+    X(arm_sve_uint32x1,            "svuint32x1") \
+    X(arm_sve_uint32x2,            "svuint32x2") \
+    X(arm_sve_uint32x3,            "svuint32x3") \
+    X(arm_sve_uint32x4,            "svuint32x4") \
+    X(arm_sve_uint64x1,            "svuint64x1") \
+    X(arm_sve_uint64x2,            "svuint64x2") \
+    X(arm_sve_uint64x3,            "svuint64x3") \
+    X(arm_sve_uint64x4,            "svuint64x4") \
+    X(arm_sve_float16x1,           "svfloat16x1") \
+    X(arm_sve_float16x2,           "svfloat16x2") \
+    X(arm_sve_float16x3,           "svfloat16x3") \
+    X(arm_sve_float16x4,           "svfloat16x4") \
+    X(arm_sve_float32x1,           "svfloat32x1") \
+    X(arm_sve_float32x2,           "svfloat32x2") \
+    X(arm_sve_float32x3,           "svfloat32x3") \
+    X(arm_sve_float32x4,           "svfloat32x4") \
+    X(arm_sve_float64x1,           "svfloat64x1") \
+    X(arm_sve_float64x2,           "svfloat64x2") \
+    X(arm_sve_float64x3,           "svfloat64x3") \
+    X(arm_sve_float64x4,           "svfloat64x4") \
+    X(arm_sve_bfloat16x1,          "svbfloat16x1") \
+    X(arm_sve_bfloat16x2,          "svbfloat16x2") \
+    X(arm_sve_bfloat16x3,          "svbfloat16x3") \
+    X(arm_sve_bfloat16x4,          "svbfloat16x4") \
+    X(arm_sve_boolx1,              "svboolx1") \
+    X(arm_sve_boolx2,              "svboolx2") \
+    X(arm_sve_boolx4,              "svboolx4") \
+    X(arm_sve_count,               "svcount")
+
+
 /// Builtin type
-class builtin_type: public type_t {
+class builtin_type final: public type_t {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::builtin_type; }
+
     /// Kind of builtin type
     enum class kind_t {
-        void_,
-        bool_,
-        char_,
-        short_,
-        int_,
-        long_,
-        long_long_,
-        int128_,
-        signed_char_,
-        unsigned_char_,
-        unsigned_short_,
-        unsigned_int_,
-        unsigned_long_,
-        unsigned_long_long_,
-        uint128_,
-        float_,
-        double_,
-        long_double_,
-
-        wchar_t_,
-        char8_t_,
-        char16_t_,
-        char32_t_,
-
-        nullptr_t_,
-
-        complex_char_,
-        complex_short_,
-        complex_int_,
-        complex_long_,
-        complex_long_long_,
-        complex_unsigned_char_,
-        complex_unsigned_short_,
-        complex_unsigned_int_,
-        complex_unsigned_long_,
-        complex_unsigned_long_long_,
-        complex_float_,
-        complex_double_,
-        complex_long_double_,
-
-        // ARM SVE
-
-        arm_sve_int8x1_,
-        arm_sve_int8x2_,
-        arm_sve_int8x3_,
-        arm_sve_int8x4_,
-        arm_sve_int16x1_,
-        arm_sve_int16x2_,
-        arm_sve_int16x3_,
-        arm_sve_int16x4_,
-        arm_sve_int32x1_,
-        arm_sve_int32x2_,
-        arm_sve_int32x3_,
-        arm_sve_int32x4_,
-        arm_sve_int64x1_,
-        arm_sve_int64x2_,
-        arm_sve_int64x3_,
-        arm_sve_int64x4_,
-
-        arm_sve_uint8x1_,
-        arm_sve_uint8x2_,
-        arm_sve_uint8x3_,
-        arm_sve_uint8x4_,
-        arm_sve_uint16x1_,
-        arm_sve_uint16x2_,
-        arm_sve_uint16x3_,
-        arm_sve_uint16x4_,
-        arm_sve_uint32x1_,
-        arm_sve_uint32x2_,
-        arm_sve_uint32x3_,
-        arm_sve_uint32x4_,
-        arm_sve_uint64x1_,
-        arm_sve_uint64x2_,
-        arm_sve_uint64x3_,
-        arm_sve_uint64x4_,
-
-        arm_sve_float16x1_,
-        arm_sve_float16x2_,
-        arm_sve_float16x3_,
-        arm_sve_float16x4_,
-        arm_sve_float32x1_,
-        arm_sve_float32x2_,
-        arm_sve_float32x3_,
-        arm_sve_float32x4_,
-        arm_sve_float64x1_,
-        arm_sve_float64x2_,
-        arm_sve_float64x3_,
-        arm_sve_float64x4_,
-
-        arm_sve_bfloat16x1_,
-        arm_sve_bfloat16x2_,
-        arm_sve_bfloat16x3_,
-        arm_sve_bfloat16x4_,
-
-        arm_sve_boolx1_,
-        arm_sve_boolx2_,
-        arm_sve_boolx4_,
-
-        arm_sve_count_,
+#define CM_BUILTIN_TYPE_KIND(knd, nm) knd##_,
+        CM_BUILTIN_TYPES(CM_BUILTIN_TYPE_KIND)
+#undef CM_BUILTIN_TYPE_KIND
 
         num_types_
     };
 
+    /// Number of kinds of builtin types
+    static constexpr std::size_t num_kinds = static_cast<std::size_t>(kind_t::num_types_);
+
+    /// Returns name of builtin type of specified kind
+    static const std::string & kind_name(kind_t k) {
+        static const std::string names[] = {
+#define CM_BUILTIN_TYPE_NAME(knd, nm) nm,
+            CM_BUILTIN_TYPES(CM_BUILTIN_TYPE_NAME)
+#undef CM_BUILTIN_TYPE_NAME
+        };
+
+        static_assert(std::size(names) == num_kinds, "name is required for each builtin type");
+        assert(static_cast<std::size_t>(k) < num_kinds && "invalid kind of builtin type");
+        return names[static_cast<std::size_t>(k)];
+    }
 
-    /// Constructor, makes builtin type with specified kind and name
-    builtin_type(kind_t k, const std::string & nm):
-        kind_{k}, name_{nm} {}
+    /// Constructor, makes builtin type with specified kind
+    explicit builtin_type(kind_t k):
+        kind_{k} {}
 
     /// Move constructor
     builtin_type(builtin_type && bt) = default;
 
     /// Copy constructor, makes copy of builtin type
     builtin_type(const builtin_type & bt):
-        kind_{bt.kind_}, name_{bt.name_} {
+        kind_{bt.kind_} {
     }
 
     /// Returns kind of builtin type
@@ -145,18 +165,17 @@ public:
     }
 
     /// Returns name of builtin type
-    const auto & name() const {
-        return name_;
+    const std::string & name() const {
+        return kind_name(kind_);
     }
 
     /// Prints type description to output stream
     void print_desc(std::ostream & str) const override {
-        str << name_;
+        str << name();
     }
 
 private:
     kind_t kind_;        ///< Kind of builtin type
-    std::string name_;   ///< Name of builtin type
 };
 
 
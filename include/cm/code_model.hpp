@@ -24,6 +24,7 @@
 #include "lvalue_reference_type.hpp"
 #include "rvalue_reference_type.hpp"
 #include "source_file.hpp"
+#include "source_location_table.hpp"
 #include "template_method.hpp"
 #include "template_function.hpp"
 #include "template_record.hpp"
@@ -32,21 +33,28 @@
 #include "typedef_type.hpp"
 #include "variable.hpp"
 #include "vector_type.hpp"
+#include <algorithm>
 #include <ranges>
 #include <array>
 #include <filesystem>
+#include <memory_resource>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <tuple>
+#include <vector>
 
 
 namespace cm {
 
 
-/// Hash function for filesystem path
-/// NOTE: We need this because of problems with std::hash<path> in libc++
-struct fs_path_hash {
-    auto operator()(const std::filesystem::path & p) const noexcept {
-        return std::filesystem::hash_value(p);
+/// Transparent hash of source file paths allowing lookup by string view
+struct source_path_hash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view p) const noexcept {
+        return std::hash<std::string_view>{}(p);
     }
 };
 
@@ -54,25 +62,49 @@ struct fs_path_hash {
 /// Map of composite types in code model such as arrays/functions/pointers
 template <typename TypeDesc, typename Type>
 class composite_type_map {
-    using map_type = std::unordered_map<TypeDesc, std::unique_ptr<Type>>;
+    using map_type = std::unordered_map<TypeDesc,
+                                        std::unique_ptr<Type>,
+                                        std::hash<TypeDesc>,
+                                        std::equal_to<>>;
 
 public:
+    /// Constructs empty map. Types are allocated from specified memory
+    /// resource or with global operator new if resource is nullptr
+    explicit composite_type_map(std::pmr::memory_resource * res):
+        mem_res_{res} {}
+
     /// Gets previously created composite type or creates new
     /// using specified parameters
     template <typename ... TypeParams>
     Type * get_or_create(TypeParams && ... params) {
-        // creating type description
-        TypeDesc desc{params...};
+        return get_or_create_by_key(TypeDesc{params...}, std::forward<TypeParams>(params)...);
+    }
 
+    /// Gets previously created composite type with description equal to
+    /// specified key or creates new using specified parameters. Key may be
+    /// of any type supported by hash of type descriptions, which allows
+    /// searching for types without constructing type descriptions
+    template <typename Key, typename ... TypeParams>
+    Type * get_or_create_by_key(const Key & key, TypeParams && ... params) {
         // looking for existing type
-        auto & res = types_[desc];
-        if (res) {
-            return res.get();
+        auto it = types_.find(key);
+        if (it != types_.end()) {
+            return it->second.get();
         }
 
         // creating new type
-        res.reset(new Type{params...});
-        return res.get();
+        std::unique_ptr<Type> res{new (mem_res_) Type{params...}};
+        auto res_ptr = res.get();
+        types_.emplace(res_ptr->type_id(), std::move(res));
+        return res_ptr;
+    }
+
+    /// Returns existing composite type with description equal to specified
+    /// key or nullptr if type does not exist
+    template <typename Key>
+    Type * find(const Key & key) const {
+        auto it = types_.find(key);
+        return it != types_.end() ? it->second.get() : nullptr;
     }
 
     /// Removes specified type from map
@@ -149,180 +181,172 @@ public:
 private:
     /// Map of types
     map_type types_;
+
+    /// Memory resource for allocating types
+    std::pmr::memory_resource * mem_res_;
 };
 
 
 /// Macro for defining builtin type accessors
-#define CM_CODE_MODEL_DEF_BT_ACCESSOR(bt_name) \
+#define CM_CODE_MODEL_DEF_BT_ACCESSOR(bt_name, bt_str) \
     const builtin_type * bt_##bt_name() const { \
-        return &builtin_types_[static_cast<int>(builtin_type::kind_t::bt_name##_)]; \
+        return &bt_types_[static_cast<int>(builtin_type::kind_t::bt_name##_)]; \
     } \
     \
     builtin_type * bt_##bt_name() { \
-        return &builtin_types_[static_cast<int>(builtin_type::kind_t::bt_name##_)]; \
+        return &bt_types_[static_cast<int>(builtin_type::kind_t::bt_name##_)]; \
     }
 
 
-/// Code model
+/// Code model.
+///
+/// Code model may be forked into lightweight derived code model, which shares
+/// all entities of base code model and contains only new entities. Forking
+/// freezes base code model permanently. It's a hard precondition that frozen
+/// code model is not modified and outlives its forks, violations are checked
+/// by assertions only and are undefined behavior in release builds. Entities
+/// of fork may use entities of base code model, but these uses are not
+/// tracked in lists of uses of frozen entities. Fork allocates entities from
+/// memory resource of base code model and encodes source locations in its
+/// own location table.
+///
+/// Fork resolves qualified names, builtin, composite types and source files
+/// in its own entities first and then in base code model, so entities of
+/// fork with the same qualified names as entities of base code model shadow
+/// them. Only these lookups fall through to base code model. Fork is a
+/// separate root namespace, so its namespaces and context API, e.g.
+/// find_namespace() and find_named_entity(), see only entities created in
+/// fork. Entities of base code model are found in fork by qualified names
+/// with resolve(). Namespaces of base code model are changed by creating
+/// namespaces with the same names in fork with fork_namespace(), entities of
+/// base code model are removed from fork by hiding them.
 class code_model: public namespace_ {
 public:
-    /// Constructor, initializes code model
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::code_model; }
+
+    /// Constructor, initializes code model. Entities are allocated with
+    /// global operator new
     code_model();
 
+    /// Constructor, initializes code model. Entities and interned names are
+    /// allocated from specified memory resource, which must outlive code model
+    explicit code_model(std::pmr::memory_resource * res);
+
     /// Deleted copy constructor
     code_model(const code_model &) = delete;
 
     /// Deleted move constructor
     code_model(code_model &&) = delete;
 
-    /// Destroys code model and removes all its contents
+    /// Destroys code model and removes all its contents. Code model must
+    /// have no forks, it's a hard precondition checked only by assertion
     virtual ~code_model();
 
+    /// Freezes code model and all its entities. Frozen code model must not be
+    /// modified, model can't be unfrozen. Freezing loads contents of all
+    /// contexts and visits all entities, so it takes time proportional to
+    /// size of code model. Locations in source files of frozen code model are
+    /// encoded as invalid locations unless they are in already encoded lines
+    void freeze();
+
+    /// Returns true if code model is frozen
+    bool frozen() const { return frozen_; }
+
+    /// Creates fork of code model. Freezes code model if it's not frozen yet,
+    /// creating fork of frozen code model takes constant time. Fork uses
+    /// memory resource of code model, code model must outlive fork
+    std::unique_ptr<code_model> fork();
+
+    /// Returns pointer to base code model of fork or nullptr if code model
+    /// is not a fork
+    code_model * base() { return base_; }
+
+    /// Returns const pointer to base code model of fork or nullptr if code
+    /// model is not a fork
+    const code_model * base() const { return base_; }
+
+    /// Hides entity of base code model in fork, so qualified names of entity
+    /// and its nested entities are not resolved in fork
+    void hide(const context_entity * ent) {
+        assert(base_ && "only entities of base code model can be hidden");
+        hidden_.insert(ent);
+    }
+
+    /// Gets or creates namespace of fork with the same qualified name as
+    /// specified namespace of base code model
+    namespace_ * fork_namespace(const namespace_ * ns);
+
+    /// Registers loader of contents of contexts of code model. Loader must be
+    /// unregistered before it's destroyed
+    void add_loader(context_loader * loader) {
+        assert(!frozen_ && "can't load contents of frozen code model");
+        loaders_.push_back(loader);
+    }
+
+    /// Unregisters loader of contents of contexts of code model
+    void remove_loader(context_loader * loader) {
+        auto it = std::ranges::find(loaders_, loader);
+        assert(it != loaders_.end() && "loader is not registered in code model");
+        loaders_.erase(it);
+    }
+
+    /// Loads contents of all contexts of code model which contents are not
+    /// loaded yet by registered loaders
+    void load_all();
+
     // Builtin type accessors
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(void)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(bool)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(char)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(short)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(int)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(long)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(long_long)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(int128)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(signed_char)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(unsigned_char)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(unsigned_short)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(unsigned_int)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(unsigned_long)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(unsigned_long_long)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(uint128)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(float)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(double)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(long_double)
-
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(wchar_t)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(char8_t)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(char16_t)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(char32_t)
-
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(complex_char)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(complex_short)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(complex_int)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(complex_long)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(complex_long_long)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(complex_unsigned_char)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(complex_unsigned_short)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(complex_unsigned_int)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(complex_unsigned_long)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(complex_unsigned_long_long)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(complex_float)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(complex_double)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(complex_long_double)
-
-    // ARM SVE
-
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_int8x1)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_int8x2)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_int8x3)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_int8x4)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_int16x1)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_int16x2)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_int16x3)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_int16x4)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_int32x1)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_int32x2)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_int32x3)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_int32x4)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_int64x1)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_int64x2)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_int64x3)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_int64x4)
-
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_uint8x1)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_uint8x2)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_uint8x3)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_uint8x4)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_uint16x1)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_uint16x2)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_uint16x3)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_uint16x4)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_uint32x1)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_uint32x2)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_uint32x3)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_uint32x4)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_uint64x1)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_uint64x2)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_uint64x3)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_uint64x4)
-
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_float16x1)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_float16x2)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_float16x3)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_float16x4)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_float32x1)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_float32x2)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_float32x3)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_float32x4)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_float64x1)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_float64x2)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_float64x3)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_float64x4)
-
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_bfloat16x1)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_bfloat16x2)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_bfloat16x3)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_bfloat16x4)
-
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_boolx1)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_boolx2)
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_boolx4)
-
-    CM_CODE_MODEL_DEF_BT_ACCESSOR(arm_sve_count)
+    CM_BUILTIN_TYPES(CM_CODE_MODEL_DEF_BT_ACCESSOR)
 
     /// Returns pointer to builtin type of specified kind
-    const auto bt_type(builtin_type::kind_t kind) const {
-        return &builtin_types_[static_cast<int>(kind)];
+    const builtin_type * bt_type(builtin_type::kind_t kind) const {
+        assert(static_cast<std::size_t>(kind) < builtin_type::num_kinds && "invalid kind of builtin type");
+        return &bt_types_[static_cast<std::size_t>(kind)];
     }
 
     /// Returns pointer to builtin type of specified kind
-    auto bt_type(builtin_type::kind_t kind) {
-        return &builtin_types_[static_cast<int>(kind)];
+    builtin_type * bt_type(builtin_type::kind_t kind) {
+        assert(static_cast<std::size_t>(kind) < builtin_type::num_kinds && "invalid kind of builtin type");
+        return &bt_types_[static_cast<std::size_t>(kind)];
     }
 
     /// Returns pointer to opaque type
-    auto * opaque_type() { return &opaque_type_; }
+    record_type * opaque_type() { return base_ ? base_->opaque_type() : &opaque_type_; }
 
     /// Returns pointer to opaque type
-    auto * opaque_type() const { return &opaque_type_; }
+    const record_type * opaque_type() const { return base_ ? base_->opaque_type() : &opaque_type_; }
 
     /// Returns or creates new pointer to type
     pointer_type * get_or_create_ptr_type(const qual_type & pointee) {
-        return ptr_types_.get_or_create(pointee);
+        return get_or_create_composite(&code_model::ptr_types_, const_qual_type{pointee}, pointee);
     }
 
     /// Returns existing or creates new array type
     array_type * get_or_create_arr_type(type_t * base, uint64_t sz) {
-        return arr_types_.get_or_create(base, sz);
+        return get_or_create_composite(&code_model::arr_types_, array_type_id{base, sz}, base, sz);
     }
 
     /// Returns existing or creates new vector type
     vector_type * get_or_create_vec_type(builtin_type * base, uint64_t sz) {
-        return vec_types_.get_or_create(base, sz);
+        return get_or_create_composite(&code_model::vec_types_, vector_type_id{base, sz}, base, sz);
     }
 
     /// Returns or creates new lvalue reference type
     lvalue_reference_type * get_or_create_lvalue_ref_type(const qual_type & pointee) {
-        return lvalue_ref_types_.get_or_create(pointee);
+        return get_or_create_composite(&code_model::lvalue_ref_types_, const_qual_type{pointee}, pointee);
     }
 
     /// Returns or creates new rvalue reference type
     rvalue_reference_type * get_or_create_rvalue_ref_type(const qual_type & pointee) {
-        return rvalue_ref_types_.get_or_create(pointee);
+        return get_or_create_composite(&code_model::rvalue_ref_types_, const_qual_type{pointee}, pointee);
     }
 
     /// Gets existing or creates new function type with specified return type
     /// and range of parameter type
     template <typename Params>
     function_type * get_or_create_func_type_r(const qual_type & ret, Params && params) {
-        return func_types_.get_or_create(ret, std::forward<Params>(params));
+        function_type_key<std::remove_cvref_t<Params>> key{ret, params};
+        return get_or_create_composite(&code_model::func_types_, key, ret, params);
     }
 
     /// Gets existing or creates new function type with specified return type
@@ -346,7 +370,9 @@ public:
     /// Gets existing or creates new pointer to member type
     mem_ptr_type * get_or_create_mem_ptr_type(record_type * obj_type,
                                               const qual_type & mem_type) {
-        return mem_ptr_types_.get_or_create(obj_type, mem_type);
+        return get_or_create_composite(&code_model::mem_ptr_types_,
+                                       mem_ptr_type_id{obj_type, mem_type},
+                                       obj_type, mem_type);
     }
 
     /// Replaces all uses of type with another type
@@ -355,7 +381,8 @@ public:
     /// Removes all unused composite types
     void remove_unused_composite_types();
 
-    /// Returns range of all pointer types
+    /// Returns range of all pointer types. Ranges of composite types of fork
+    /// don't include types of base code model
     auto ptr_types() { return ptr_types_.types(); }
 
     /// Returns range of all lvalue reference types
@@ -401,40 +428,167 @@ public:
     /// Removes specified type. Type must have no uses
     void remove_type(type_t * type);
 
+    /// Resolves fully qualified name of entity such as ns1::ns2::rec::nested.
+    /// Returns pointer to the first found entity of specified class with this
+    /// name or nullptr if entity is not found. Members of anonymous namespaces
+    /// are resolved by names qualified with enclosing namespace.
+    template <std::derived_from<named_entity> Entity = named_entity>
+    Entity * resolve(std::string_view qname) {
+        auto cthis = const_cast<const code_model*>(this);
+        return const_cast<Entity*>(cthis->resolve<Entity>(qname));
+    }
+
+    /// Resolves fully qualified name of entity such as ns1::ns2::rec::nested.
+    /// Returns const pointer to the first found entity of specified class with
+    /// this name or nullptr if entity is not found. Fork resolves names of
+    /// entities of base code model that are not hidden in fork.
+    template <std::derived_from<named_entity> Entity = named_entity>
+    const Entity * resolve(std::string_view qname) const {
+        const Entity * res = nullptr;
+        for (auto cm = this; cm && !res; cm = cm->base_) {
+            cm->qname_index_.find(cm->names_, qname, [&](const context_entity * ent) {
+                res = entity_cast<const Entity>(ent);
+                if (res && cm != this && is_hidden(ent, cm)) {
+                    res = nullptr;
+                }
+
+                return res != nullptr;
+            });
+        }
+
+        // entity may be nested in context which contents are not loaded yet
+        if (!res && !loaders_.empty() && load_enclosing_context(qname)) {
+            return resolve<Entity>(qname);
+        }
+
+        return res;
+    }
+
+    /// Searches for existing source file with specified path. Returns null if
+    /// not found. If find_name is true and path is a file name, searches for
+    /// source file with matching file name. Fork returns source file of base
+    /// code model if it doesn't have its own source file with the path
+    const source_file * find_source(std::string_view p, bool find_name = false) const;
+
     /// Searches for existing source file with specified path. Returns null if not found.
-    const source_file * find_source(const std::filesystem::path & p, bool find_name = false) const;
+    template <std::same_as<std::filesystem::path> Path>
+    const source_file * find_source(const Path & p, bool find_name = false) const {
+        return find_source(std::string_view{p.native()}, find_name);
+    }
 
-    /// Gets existing or creates new source file object with specified path
-    const source_file * source(const std::filesystem::path & p) {
-        auto & res = sources_[p];
-        if (!res) {
-            res = std::make_unique<source_file>(p);
+    /// Gets existing or creates new source file object with specified path.
+    /// Fork creates its own source file for source file of base code model,
+    /// so locations created by fork don't modify base code model
+    const source_file * source(std::string_view p) {
+        auto it = sources_.find(p);
+        if (it == sources_.end()) {
+            assert(!frozen_ && "can't create source file in frozen code model");
+            auto origin = base_ ? base_->find_source(p) : nullptr;
+            auto src = std::make_unique<source_file>(p, locations_, origin);
+            it = sources_.emplace(src->path().native(), std::move(src)).first;
         }
 
-        return res.get();
+        return it->second.get();
     }
 
+    /// Gets existing or creates new source file object with specified path
+    template <std::same_as<std::filesystem::path> Path>
+    const source_file * source(const Path & p) {
+        return source(std::string_view{p.native()});
+    }
+
+    /// Returns index of entities by owning source files
+    const source_entity_index & source_entities() const { return src_index_; }
+
+    /// Returns table of locations in source files created by code model
+    const source_location_table & locations() const { return locations_; }
+
+    /// Removes all entities owned by source file together with their uses, so
+    /// changed source file can be converted to code model again. Entities
+    /// using removed entities are removed too, including entities owned by
+    /// other source files. Returns other source files owning removed or
+    /// changed entities, they must be converted again for restoring them
+    std::vector<const source_file*> remove_source_entities(const source_file * src);
+
     /// Dumps code model to output stream
     void dump(std::ostream & str,
               const dump_options & opts = {},
               unsigned int indent = 0) const override;
 
 private:
-    /// Recursively removes all base records for all record types in decl context
-    /// and itss nested decl contexts
-    void remove_decl_context_base_records(context * ctx);
+    /// Constructor, initializes code model with memory resource for entities
+    /// and optional base code model
+    code_model(std::pmr::memory_resource * res, code_model * base);
+
+    /// Returns existing composite type from specified map of this code model
+    /// or base code models or creates new type in this code model
+    template <typename Map, typename Key, typename ... TypeParams>
+    auto get_or_create_composite(Map code_model::* map, const Key & key, TypeParams && ... params)
+        -> decltype((this->*map).find(key)) {
+        for (auto cm = base_; cm; cm = cm->base_) {
+            if (auto res = (cm->*map).find(key)) {
+                return res;
+            }
+        }
+
+        auto & types = this->*map;
+        assert((!frozen_ || types.find(key)) && "can't create type in frozen code model");
+        return types.get_or_create_by_key(key, std::forward<TypeParams>(params)...);
+    }
+
+    /// Returns true if entity of specified base code model is hidden in this
+    /// fork or in forks between this fork and base code model
+    bool is_hidden(const context_entity * ent, const code_model * base) const;
 
-    /// Recursively removes all base records for all record types in namespace
-    /// and its nested decl contexts and namespaces
-    void remove_namespace_base_records(namespace_ * ns);
+    /// Loads contents of context enclosing entity with specified qualified
+    /// name. Returns false if context is not found or its contents are
+    /// already loaded
+    bool load_enclosing_context(std::string_view qname) const;
 
-    /// Recursively removes entity and all its uses
-    void remove_entity_and_uses(entity * ent);
+    /// Recursively freezes entities and nested namespaces of namespace
+    static void freeze_namespace(namespace_ * ns);
 
-    /// Recursively removes all entities in namespace
-    void remove_namespace_entities(namespace_ * ns);
+    /// Recursively freezes entities of context
+    static void freeze_context(context * ctx);
+
+    /// Recursively removes all uses of entity and its nested entities. Entities
+    /// that use removed entities are removed with their uses. Adds source
+    /// files owning removed or changed entities to owners if it's not null
+    void remove_entity_uses(entity * ent, std::vector<const source_file*> * owners = nullptr);
+
+    /// Recursively removes entity and all its uses. Adds source files owning
+    /// removed or changed entities to owners if it's not null
+    void remove_entity_and_uses(entity * ent, std::vector<const source_file*> * owners = nullptr);
+
+    /// Destroys all entities and nested namespaces of namespace. Must be
+    /// called inside teardown scope, uses of entities are not removed
+    void destroy_namespace_entities(namespace_ * ns);
+
+    code_model * base_;                     ///< Base code model of fork or nullptr
+    std::size_t num_forks_ = 0;             ///< Number of existing forks
+    bool frozen_ = false;                   ///< Code model is frozen
+
+    /// Entities of base code models hidden in fork
+    std::unordered_set<const context_entity*> hidden_;
+
+    /// Loaders of contents of contexts
+    std::vector<context_loader*> loaders_;
+
+    /// Table of names of all entities in code model
+    name_table names_;
+
+    /// Index of all named entities in code model by qualified names
+    qualified_name_index qname_index_;
+
+    /// Index of entities by owning source files
+    source_entity_index src_index_;
+
+    /// Predefined builtin types indexed by kinds
+    std::array<builtin_type, builtin_type::num_kinds> builtin_types_;
+
+    /// Pointer to builtin types of code model or of root base code model of fork
+    builtin_type * bt_types_;
 
-    std::vector<builtin_type> builtin_types_;       ///< Predefined builtin types
     record_type opaque_type_;                       ///< Opaque type
 
     /// Map of pointer types
@@ -458,8 +612,12 @@ private:
     /// Map of pointer to member types
     composite_type_map<mem_ptr_type_id, mem_ptr_type> mem_ptr_types_;
 
-    /// Map os source file objects
-    std::unordered_map<std::filesystem::path, std::unique_ptr<source_file>, fs_path_hash> sources_;
+    /// Table of locations in source files of code model
+    source_location_table locations_;
+
+    /// Map of source file objects by path. Paths are compared as strings
+    std::unordered_map<std::string, std::unique_ptr<source_file>,
+                       source_path_hash, std::equal_to<>> sources_;
 };
 
 
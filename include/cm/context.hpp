@@ -10,14 +10,21 @@
 #pragma once
 
 #include "context_entity.hpp"
+#include "context_entity_list.hpp"
+#include "context_loader.hpp"
+#include "entity_kind_index.hpp"
 #include "enum_type.hpp"
 #include "function_type.hpp"
+#include "name_table.hpp"
+#include "qualified_name_index.hpp"
 #include "record_kind.hpp"
+#include "source_entity_index.hpp"
 #include "typedef_type.hpp"
 #include "variable.hpp"
 #include <ranges>
 #include <unordered_map>
 #include <sstream>
+#include <string_view>
 
 
 namespace cm {
@@ -38,6 +45,9 @@ class template_record_instantiation_type;
 
 /// Represents context in code model that contains code model entities
 class context: virtual public context_entity {
+    friend class context_entity;
+    friend class qualified_name_index;
+
 public:
     /// Exception that is thrown in case of type cast errors
     struct type_cast_error: public std::runtime_error {
@@ -46,20 +56,76 @@ public:
     };
 
 protected:
-    /// Constructs context with specified optional parent context
+    /// Constructs context with specified parent context. Entities are
+    /// allocated from memory resource of parent context and names are
+    /// interned in name table of parent context. Qualified names are added
+    /// to index of parent context when context gets qualified name. Owners
+    /// of entities are tracked in index of parent context. Root contexts
+    /// are constructed with their own name tables.
     context(context * p):
-        context_entity(p) {}
+        context_entity(p),
+        src_index_{p->src_index_},
+        entity_res_{p->entity_res_},
+        names_{p->names_},
+        qname_index_{p->qname_index_} {}
+
+    /// Constructs root context with specified memory resource for allocating
+    /// entities, table of names, which must outlive context, optional index
+    /// of qualified names and optional index of entities by owning source files
+    context(std::pmr::memory_resource * res,
+            name_table * names,
+            qualified_name_index * qname_index,
+            source_entity_index * src_index = nullptr):
+        context_entity(nullptr), src_index_{src_index},
+        entity_res_{res}, names_{names}, qname_index_{qname_index},
+        qname_key_{qname_index ? qualified_name_index::root_key : 0} {
+        assert(names && "root context must have name table");
+    }
 
 public:
-    /// Default destructor
-    virtual ~context() = default;
+    /// Destroys context. Cancels loading of contents of context
+    virtual ~context() {
+        if (loader_) {
+            loader_->cancel(this);
+        }
+    }
 
     /// Returns true if context_entity context is root (has no parent)
     bool is_root() const { return ctx() == nullptr; }
 
+    /// Returns memory resource for allocating entities of context or nullptr
+    /// if entities are allocated with global operator new
+    std::pmr::memory_resource * entity_resource() const { return entity_res_; }
+
+    /// Returns table of names of entities in context
+    name_table & names() const { return *names_; }
+
     /// Returns default access level for this context
     virtual access_level default_access_level() const = 0;
 
+    /// Returns true if contents of context are loaded
+    bool is_loaded() const { return loader_ == nullptr; }
+
+    /// Sets loader creating contents of context on first access to entities
+    /// of context. Resets loader without loading contents if loader is nullptr
+    void set_loader(context_loader * loader) {
+        assert((!loader || !is_frozen()) && "can't load contents of frozen context");
+        loader_ = loader;
+    }
+
+    /// Loads contents of context if they are not loaded yet. Loading contents
+    /// may add entities to other contexts, e.g. template instantiations used
+    /// in contents are added to contexts of templates. Const accessors such
+    /// as entities(), find_named_entity() and function::params() call load(),
+    /// so reading context with loader modifies code model. Concurrent readers
+    /// of code model which is not frozen must be synchronized while contents
+    /// of contexts are not loaded
+    void load() const {
+        if (loader_) [[unlikely]] {
+            load_contents();
+        }
+    }
+
 
     //////////////////////////////////////////////////////////////////////
     // Enetities
@@ -69,20 +135,23 @@ public:
     template <typename Entity = context_entity>
     auto entities() const {
         static_assert(std::derived_from<Entity, context_entity>, "invalid entity filter type");
+        load();
 
         if constexpr (std::same_as<Entity, context_entity>) {
-            auto transform_fn = [](auto && ptr) { return const_cast<const context_entity*>(ptr.get()); };
-            return entities_ | std::ranges::views::transform(transform_fn);
+            return entities_.entities();
+        } else if constexpr (entity_kind_traits<Entity>::has_kinds) {
+            // visiting only entities of matching kinds
+            return kind_index_.entities<const Entity>();
         } else {
-            auto transform_fn = [](auto && ptr) {
-                return dynamic_cast<const Entity*>(ptr.get());
+            auto transform_fn = [](const context_entity * ent) {
+                return entity_cast<const Entity>(ent);
             };
 
             auto filter_fn = [](const Entity * ent) {
                 return ent != nullptr;
             };
 
-            return entities_
+            return entities_.entities()
                 | std::ranges::views::transform(transform_fn)
                 | std::ranges::views::filter(filter_fn);
         }
@@ -92,20 +161,23 @@ public:
     template <typename Entity = context_entity>
     auto entities() {
         static_assert(std::derived_from<Entity, context_entity>, "invalid entity filter type");
+        load();
 
         if constexpr (std::same_as<Entity, context_entity>) {
-            auto transform_fn = [](auto && ptr) { return ptr.get(); };
-            return entities_ | std::ranges::views::transform(transform_fn);
+            return entities_.entities();
+        } else if constexpr (entity_kind_traits<Entity>::has_kinds) {
+            // visiting only entities of matching kinds
+            return kind_index_.entities<Entity>();
         } else {
-            auto transform_fn = [](auto && ptr) {
-                return dynamic_cast<Entity*>(ptr.get());
+            auto transform_fn = [](context_entity * ent) {
+                return entity_cast<Entity>(ent);
             };
 
             auto filter_fn = [](Entity * ent) {
                 return ent != nullptr;
             };
 
-            return entities_
+            return entities_.entities()
                 | std::ranges::views::transform(transform_fn)
                 | std::ranges::views::filter(filter_fn);
         }
@@ -114,13 +186,28 @@ public:
     /// Removes entity from context. The entity must have no uses
     virtual void remove_entity(context_entity * ent);
 
+    /// Sets source file owning entity in this context. Context must belong
+    /// to code model. Namespaces are shared by source files and can't be
+    /// owned by them
+    void set_entity_owner(context_entity * ent, const source_file * src);
+
+    /// Removes all entities from context. Entities must have no uses
+    void clear();
+
     /// Returns pointer to existing named entity of specified type in context
     /// or nullptr if entity does not exist
     template <typename Entity = named_context_entity>
-    Entity * find_named_entity(const std::string & name) {
+    Entity * find_named_entity(std::string_view name) {
         static_assert(std::derived_from<Entity, named_context_entity>, "invalid named entity type");
+        load();
+
+        // name that is not in table is not a name of any entity
+        auto sym = names_->find(name);
+        if (!sym) {
+            return nullptr;
+        }
 
-        auto it = named_entities_.find(name);
+        auto it = named_entities_.find(*sym);
         if (it == named_entities_.end()) {
             return nullptr;
         }
@@ -128,17 +215,24 @@ public:
         if constexpr (std::same_as<Entity, named_context_entity>) {
             return it->second;
         } else {
-            return dynamic_cast<Entity*>(it->second);
+            return entity_cast<Entity>(it->second);
         }
     }
 
     /// Returns const pointer to existing named entity of specified type in context
     /// or nullptr if entity does not exist
     template <typename Entity = named_context_entity>
-    const Entity * find_named_entity(const std::string & name) const {
+    const Entity * find_named_entity(std::string_view name) const {
         static_assert(std::derived_from<Entity, named_context_entity>, "invalid named entity type");
+        load();
+
+        // name that is not in table is not a name of any entity
+        auto sym = names_->find(name);
+        if (!sym) {
+            return nullptr;
+        }
 
-        auto it = named_entities_.find(name);
+        auto it = named_entities_.find(*sym);
         if (it == named_entities_.end()) {
             return nullptr;
         }
@@ -146,10 +240,35 @@ public:
         if constexpr (std::same_as<Entity, named_context_entity>) {
             return it->second;
         } else {
-            return dynamic_cast<const Entity*>(it->second);
+            return entity_cast<const Entity>(it->second);
         }
     }
 
+    /// Returns pointer to the first named entity of specified type in context
+    /// for which predicate returns true or nullptr if entity does not exist.
+    /// Used for choosing one of entities with the same name, e.g. overloaded
+    /// functions
+    template <typename Entity = named_context_entity, typename Pred>
+    Entity * find_named_entity_if(std::string_view name, Pred && pred) {
+        static_assert(std::derived_from<Entity, named_context_entity>, "invalid named entity type");
+        load();
+
+        // name that is not in table is not a name of any entity
+        auto sym = names_->find(name);
+        if (!sym) {
+            return nullptr;
+        }
+
+        auto [first, last] = named_entities_.equal_range(*sym);
+        for (; first != last; ++first) {
+            if (auto ent = entity_cast<Entity>(first->second); ent && pred(ent)) {
+                return ent;
+            }
+        }
+
+        return nullptr;
+    }
+
     /// Creates entity in this context
     template <typename Entity, typename ... Args>
     Entity * create_entity(Args && ... args) {
@@ -165,17 +284,7 @@ public:
     }
 
     /// Renames named entity in this context
-    template <typename String>
-    requires (std::assignable_from<std::string &, String>)
-    void rename_entity(named_context_entity * ent, String && str) {
-        if (ent->name() == str) {
-            return;
-        }
-
-        remove_named_entity_from_map(ent);
-        named_entities_.emplace(str, ent);
-        ent->set_name_impl(std::forward<String>(str));
-    }
+    void rename_entity(named_context_entity * ent, std::string_view str);
 
 
     //////////////////////////////////////////////////////////////////////
@@ -194,10 +303,10 @@ public:
     auto named_types() { return entities<named_type>(); }
 
     /// Searches for named type in context. Returns pointer to type or null if type not found
-    const named_type * find_named_type(const std::string & name) const;
+    const named_type * find_named_type(std::string_view name) const;
 
     /// Searches for named type in context. Returns pointer to type or null if type not found
-    named_type * find_named_type(const std::string & name);
+    named_type * find_named_type(std::string_view name);
 
 
     //////////////////////////////////////////////////////////////////////
@@ -227,10 +336,10 @@ public:
     auto named_records();
 
     /// Searches for record with specified name
-    named_record_type * find_named_record(const std::string & name);
+    named_record_type * find_named_record(std::string_view name);
 
     /// Searches for record with specified name
-    const named_record_type * find_named_record(const std::string & name) const;
+    const named_record_type * find_named_record(std::string_view name) const;
 
     /// Creates named record in context
     named_record_type * create_named_record(const std::string & name,
@@ -247,10 +356,10 @@ public:
     auto typedefs() { return entities<typedef_type>(); }
 
     /// Searches for typedef with specified name. Returns null if typedef not found
-    const typedef_type * find_typedef(const std::string & name) const;
+    const typedef_type * find_typedef(std::string_view name) const;
 
     /// Searches for typedef with specified name. Returns null if typedef not found
-    typedef_type * find_typedef(const std::string & name);
+    typedef_type * find_typedef(std::string_view name);
 
     /// Creates nested typedef type in this context
     typedef_type * create_typedef(const std::string & name, const qual_type & base);
@@ -266,10 +375,10 @@ public:
     auto enums() { return entities<enum_type>(); }
 
     /// Searches for enum type with specified name. Returns null if enum not found
-    const enum_type * find_enum(const std::string & name) const;
+    const enum_type * find_enum(std::string_view name) const;
 
     /// Searches for enum type with specified name. Returns null if enum not found
-    enum_type * find_enum(const std::string & name);
+    enum_type * find_enum(std::string_view name);
 
     /// Creates enum in context
     enum_type * create_enum(const std::string & name, builtin_type * base);
@@ -285,7 +394,10 @@ public:
     auto vars() { return entities<variable>(); }
 
     /// Finds variable with specified name. Returns nullptr if variable not found.
-    variable * find_var(const std::string & name);
+    const variable * find_var(std::string_view name) const;
+
+    /// Finds variable with specified name. Returns nullptr if variable not found.
+    variable * find_var(std::string_view name);
 
     /// Creates variable with specified name and type in context
     virtual variable * create_var(const std::string & name, const qual_type & type);
@@ -311,10 +423,10 @@ public:
     auto named_functions();
 
     /// Searches for function with specified name. Returns null if function not found
-    const named_function * find_function(const std::string & nm) const;
+    const named_function * find_function(std::string_view nm) const;
 
     /// Searches for function with specified name. Returns null if function not found
-    named_function * find_function(const std::string & nm);
+    named_function * find_function(std::string_view nm);
 
     /// Creates function with specified name
     named_function * create_function(const std::string & name);
@@ -332,10 +444,10 @@ public:
     auto templates();
 
     /// Searches for template with specified name. Returns nullptr if templte not found.
-    const template_ * find_template(const std::string & name) const;
+    const template_ * find_template(std::string_view name) const;
 
     /// Searches for template with specified name. Returns nullptr if templte not found.
-    template_ * find_template(const std::string & name);
+    template_ * find_template(std::string_view name);
 
 
     //////////////////////////////////////////////////////////////////////
@@ -350,10 +462,10 @@ public:
     auto template_functions();
 
     /// Searches for template function with specified name. Returns nullptr if not found.
-    const template_function * find_template_function(const std::string & name) const;
+    const template_function * find_template_function(std::string_view name) const;
 
     /// Searches for template function with specified name. Returns nullptr if not found.
-    template_function * find_template_function(const std::string & name);
+    template_function * find_template_function(std::string_view name);
 
     /// Creates template function in this context
     template_function * create_template_function(const std::string & name);
@@ -371,10 +483,10 @@ public:
     auto template_records();
 
     /// Searches for template record with specified name. Return null if not found.
-    const template_record * find_template_record(const std::string & name) const;
+    const template_record * find_template_record(std::string_view name) const;
 
     /// Searches for template record with specified name. Return null if not found.
-    template_record * find_template_record(const std::string & name);
+    template_record * find_template_record(std::string_view name);
 
     /// Creates template record with specified name, kind, parameter pack flag, and parameters list
     template <typename ... Params>
@@ -402,9 +514,11 @@ protected:
     /// Creates entity in context with custom context type and dds it into list of entities
     template <typename Entity, typename Context, typename ... Args>
     Entity * create_entity_impl(Context * ctx, Args && ... args) {
-        auto ent = std::make_unique<Entity>(ctx, std::forward<Args>(args)...);
+        assert(!is_frozen() && "can't modify frozen context");
+        auto ent = make_entity<Entity>(entity_res_, ctx, std::forward<Args>(args)...);
         auto res = ent.get();
         entities_.push_back(std::move(ent));
+        kind_index_.push_back(res);
         return res;
     }
 
@@ -414,11 +528,31 @@ protected:
         static_assert(std::is_base_of<named_context_entity, Entity>::value,
                       "T should be derived from named_entity");
         auto res = create_entity_impl<Entity>(ctx, name, std::forward<Args>(args)...);
-        named_entities_.emplace(name, res);
+        named_entities_.emplace(res->name_symbol(), res);
+        add_qualified_name(res, res->name_symbol());
         return res;
     }
 
+    /// Adds entity with specified name nested in this context to index of
+    /// qualified names. If entity is a context, adds qualified names of its
+    /// nested entities too
+    void add_qualified_name(context_entity * ent, symbol name);
+
+    /// Removes entity with specified name nested in this context from index
+    /// of qualified names. If entity is a context, removes qualified names
+    /// of its nested entities too
+    void remove_qualified_name(context_entity * ent, symbol name);
+
+    /// Adds qualified names of all nested entities to index
+    virtual void add_nested_qualified_names();
+
+    /// Removes qualified names of all nested entities from index
+    virtual void remove_nested_qualified_names();
+
 private:
+    /// Loads contents of context with its loader
+    void load_contents() const;
+
     /// Removes named entity from map of named entities
     void remove_named_entity_from_map(named_context_entity * ent);
 
@@ -426,11 +560,38 @@ private:
     static template_record_instantiation_type *
     dynamic_cast_template_record_instantiation_type(template_instantiation * inst);
 
-    /// Vector of entities in context
-    std::vector<std::unique_ptr<context_entity>> entities_;
+    /// Index of entities by owning source files or nullptr if context doesn't
+    /// belong to code model. Declared before entities, so it's available
+    /// when entities are destroyed
+    source_entity_index * src_index_;
+
+    /// List of entities in context
+    context_entity_list entities_;
+
+    /// Index of entities in context by entity kind
+    entity_kind_index kind_index_;
 
     /// Map of named entities in context
-    std::unordered_multimap<std::string, named_context_entity*> named_entities_;
+    std::unordered_multimap<symbol, named_context_entity*> named_entities_;
+
+    /// Memory resource for allocating entities
+    std::pmr::memory_resource * entity_res_;
+
+    /// Table of names of entities
+    name_table * names_;
+
+    /// Index of qualified names or nullptr if context doesn't belong to code model
+    qualified_name_index * qname_index_;
+
+    /// Key of qualified name of context in index or 0 if context has no
+    /// qualified name (e. g. anonymous record)
+    std::size_t qname_key_ = 0;
+
+    /// Name of context used for computing key of its qualified name
+    symbol qname_name_;
+
+    /// Loader of contents of context or nullptr if contents are loaded
+    mutable context_loader * loader_ = nullptr;
 };
 
 
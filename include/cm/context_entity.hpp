@@ -17,6 +17,7 @@ namespace cm {
 
 
 class context;
+class source_file;
 
 
 /// Context entity access level
@@ -29,6 +30,10 @@ enum class access_level {
 
 /// Represents abstract entity in code model located inside some context
 class context_entity: virtual public entity {
+    friend class context;
+    friend class context_entity_list;
+    friend class entity_kind_index;
+
 public:
     /// Constructs entity with specified pointer to context and access level
     explicit context_entity(context * ctx, access_level acc_lev):
@@ -38,8 +43,9 @@ public:
     /// default access level for context
     explicit context_entity(context * ctx);
 
-    /// Default destructor
-    virtual ~context_entity() = default;
+    /// Destroys entity. Removes entity from index of entities by owning
+    /// source files unless it's destroyed inside teardown scope
+    virtual ~context_entity();
 
     /// Returns pointer to context
     auto ctx() { return entity_ctx_; }
@@ -56,6 +62,10 @@ public:
     /// Dumps location to output stream
     void dump_loc(std::ostream & str, const dump_options & opts) const;
 
+    /// Returns source file that introduced entity into code model or nullptr
+    /// if entity is not owned by source file
+    const source_file * owner_source() const { return owner_src_; }
+
     /// Returns entity access level
     access_level access_lev() const { return acc_lev_; }
 
@@ -64,8 +74,11 @@ public:
 
 private:
     context * entity_ctx_;      ///< Pointer to parent context
+    const source_file * owner_src_ = nullptr;   ///< Source file owning entity
     source_location loc_;       ///< Location in source code
     access_level acc_lev_;      ///< Access level
+    std::size_t list_slot_ = 0; ///< Index of entity in list of entities of context
+    std::size_t kind_slot_ = 0; ///< Index of entity in kind index of context
 };
 
 
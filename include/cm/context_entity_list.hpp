@@ -0,0 +1,175 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file context_entity_list.hpp
+/// Contains definition of the context_entity_list class.
+
+#pragma once
+
+#include "context_entity.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <vector>
+
+
+namespace cm {
+
+
+/// List of entities owned by context. Keeps entities in order of insertion.
+/// Each entity stores its slot in the list, so removal of entity takes
+/// constant time: slot of removed entity becomes empty, empty slots are
+/// compacted when list grows. Removing entities does not move other entities,
+/// so entities may be removed while iterating list.
+class context_entity_list {
+public:
+    /// Iterator over entities skipping empty slots
+    template <typename T>
+    class iterator {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T *;
+        using difference_type = std::ptrdiff_t;
+
+        /// Constructs empty iterator
+        iterator() = default;
+
+        /// Constructs iterator pointing to the first non empty slot in range
+        iterator(const std::unique_ptr<context_entity> * cur,
+                 const std::unique_ptr<context_entity> * end):
+        cur_{cur}, end_{end} {
+            skip_empty();
+        }
+
+        /// Returns pointer to entity
+        T * operator*() const { return cur_->get(); }
+
+        /// Moves iterator to the next entity
+        iterator & operator++() {
+            ++cur_;
+            skip_empty();
+            return *this;
+        }
+
+        /// Moves iterator to the next entity
+        iterator operator++(int) {
+            auto res = *this;
+            ++*this;
+            return res;
+        }
+
+        /// Compares iterators
+        bool operator==(const iterator & other) const { return cur_ == other.cur_; }
+
+    private:
+        /// Moves iterator to the first non empty slot
+        void skip_empty() {
+            while (cur_ != end_ && !*cur_) {
+                ++cur_;
+            }
+        }
+
+        const std::unique_ptr<context_entity> * cur_ = nullptr;     ///< Current slot
+        const std::unique_ptr<context_entity> * end_ = nullptr;     ///< End of slots
+    };
+
+    /// View of entities in list. Iterators are obtained from list on each call
+    /// of begin, so view stays valid after adding and removing entities.
+    template <typename T>
+    class view: public std::ranges::view_interface<view<T>> {
+    public:
+        /// Constructs empty view
+        view() = default;
+
+        /// Constructs view of specified list
+        explicit view(const context_entity_list & list): list_{&list} {}
+
+        /// Returns iterator to the first entity
+        iterator<T> begin() const {
+            auto data = list_->slots_.data();
+            return {data + list_->first_, data + list_->slots_.size()};
+        }
+
+        /// Returns iterator past the last entity
+        iterator<T> end() const {
+            auto end = list_->slots_.data() + list_->slots_.size();
+            return {end, end};
+        }
+
+    private:
+        const context_entity_list * list_ = nullptr;    ///< Pointer to list
+    };
+
+    /// Returns view of const entities
+    view<const context_entity> entities() const { return view<const context_entity>{*this}; }
+
+    /// Returns view of entities
+    view<context_entity> entities() { return view<context_entity>{*this}; }
+
+    /// Returns true if list has no entities
+    bool empty() const { return slots_.size() == first_; }
+
+    /// Adds entity to the end of list
+    void push_back(std::unique_ptr<context_entity> ent) {
+        // compacting slots if there are more empty slots than entities
+        if (num_empty_ > slots_.size() / 2) {
+            compact();
+        }
+
+        ent->list_slot_ = slots_.size();
+        slots_.push_back(std::move(ent));
+    }
+
+    /// Removes entity from list and destroys it
+    void erase(context_entity * ent) {
+        auto slot = ent->list_slot_;
+        assert(slot < slots_.size() && slots_[slot].get() == ent &&
+               "context entity not found in list");
+
+        slots_[slot].reset();
+        ++num_empty_;
+
+        // updating position of the first entity
+        while (first_ != slots_.size() && !slots_[first_]) {
+            ++first_;
+        }
+    }
+
+    /// Destroys all entities in list
+    void clear() {
+        slots_.clear();
+        first_ = 0;
+        num_empty_ = 0;
+    }
+
+private:
+    /// Removes empty slots, updates slots of entities
+    void compact() {
+        std::erase(slots_, nullptr);
+
+        for (std::size_t i = 0; i < slots_.size(); ++i) {
+            slots_[i]->list_slot_ = i;
+        }
+
+        first_ = 0;
+        num_empty_ = 0;
+    }
+
+    std::vector<std::unique_ptr<context_entity>> slots_;    ///< Slots of entities
+    std::size_t first_ = 0;                                 ///< Slot of the first entity
+    std::size_t num_empty_ = 0;                             ///< Number of empty slots
+};
+
+
+}
+
+
+/// Views of context_entity_list don't own entities, iterators stay valid after destroying view
+template <typename T>
+inline constexpr bool std::ranges::enable_borrowed_range<cm::context_entity_list::view<T>> = true;
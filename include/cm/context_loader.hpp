@@ -0,0 +1,42 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file context_loader.hpp
+/// Contains definition of the context_loader class.
+
+#pragma once
+
+
+namespace cm {
+
+
+class context;
+
+
+/// Interface of loader of contents of contexts on demand. Loader is set to
+/// contexts which contents are not created yet, contents are created by
+/// loader on first access to entities of context. Loaders of code model are
+/// registered in code model, so all contents are loaded before freezing code
+/// model.
+class context_loader {
+public:
+    /// Default destructor
+    virtual ~context_loader() = default;
+
+    /// Creates contents of context. Called once on first access to entities
+    /// of context, loader of context is reset before call
+    virtual void load(context * ctx) = 0;
+
+    /// Forgets context destroyed before loading its contents
+    virtual void cancel(context * ctx) = 0;
+
+    /// Loads contents of all contexts with this loader. Returns true if
+    /// contents of some contexts were loaded
+    virtual bool load_all() = 0;
+};
+
+
+}
@@ -11,20 +11,70 @@
 
 #include "../../cm.hpp"
 #include "../../context_entity.hpp"
+#include "../../context_loader.hpp"
+#include "../../pointer_map.hpp"
 #include "../../record_type.hpp"
+#include "../../source_file.hpp"
 #include "../../template.hpp"
+#include "source_location_cache.hpp"
 #include <clang/AST/Decl.h>
 #include <clang/AST/DeclCXX.h>
 #include <clang/AST/DeclTemplate.h>
 #include <clang/AST/TypeLoc.h>
 #include <clang/AST/ASTContext.h>
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 
 namespace cm::clang {
 
 
-/// clang AST to code model converter
-class ast_converter {
+/// Set of headers already converted to code model. Shared by AST converters
+/// of translation units merged into the same code model, so declarations
+/// from headers included by many translation units are converted once.
+/// Headers are identified by source files and hashes of their contents.
+class converted_headers {
+public:
+    /// Returns true if header with specified hash of content is converted
+    bool contains(const source_file * file, std::size_t content_hash) const {
+        auto it = headers_.find(file);
+        return it != headers_.end() && it->second == content_hash;
+    }
+
+    /// Returns true if header is converted with content different from
+    /// content with specified hash
+    bool changed(const source_file * file, std::size_t content_hash) const {
+        auto it = headers_.find(file);
+        return it != headers_.end() && it->second != content_hash;
+    }
+
+    /// Adds header with specified hash of content to set of converted
+    /// headers. Replaces hash of previously converted content of header
+    void insert(const source_file * file, std::size_t content_hash) {
+        headers_.insert_or_assign(file, content_hash);
+    }
+
+    /// Removes header from set of converted headers, so it's converted again
+    void erase(const source_file * file) {
+        headers_.erase(file);
+    }
+
+    /// Returns number of converted headers
+    std::size_t size() const { return headers_.size(); }
+
+private:
+    /// Hashes of contents of converted headers by header files
+    std::unordered_map<const source_file*, std::size_t> headers_;
+};
+
+
+/// clang AST to code model converter. In lazy mode contents of records,
+/// signatures of functions and specializations of templates are converted
+/// on first access to them through code model, so clang AST context must
+/// outlive converter.
+class ast_converter: public context_loader {
     /// Helper class for settings current declaration contexts and restoring them
     /// at scope exit
     struct context_setter {
@@ -90,11 +140,20 @@ class ast_converter {
 
 public:
     /// Constructs AST converter with specified reference to global code model
-    /// and clang AST context
-    ast_converter(code_model & mdl): mdl_{mdl} {}
+    /// and optional set of converted headers. Declarations from converted
+    /// headers are skipped, headers converted by this converter are added to
+    /// set after conversion of translation unit. Lazy converter is registered
+    /// in code model as loader of contents of contexts.
+    ast_converter(code_model & mdl, converted_headers * headers = nullptr, bool lazy = false):
+        mdl_{mdl}, headers_{headers}, lazy_{lazy}, locs_{mdl} {
+        if (lazy_) {
+            mdl_.add_loader(this);
+        }
+    }
 
-    /// Default destructor
-    ~ast_converter() = default;
+    /// Destroys converter. Contents of contexts which are not loaded yet
+    /// stay empty
+    ~ast_converter() override;
 
     /// Deleted copy constructor
     ast_converter(const ast_converter &) = delete;
@@ -102,12 +161,42 @@ public:
     /// Deleted copy assignment operator
     ast_converter & operator=(const ast_converter &) = delete;
 
-    /// Default move constructor
-    ast_converter(ast_converter &&) = default;
+    /// Deleted move constructor, lazy converter is referenced by contexts
+    ast_converter(ast_converter &&) = delete;
 
     /// Converts AST context to code model
     void convert(const ::clang::ASTContext & ctx);
 
+    /// Returns number of converted top level and namespace level declarations
+    std::size_t converted_decls() const { return converted_decls_; }
+
+    /// Returns number of top level and namespace level declarations skipped
+    /// because they are declared in converted headers
+    std::size_t skipped_decls() const { return skipped_decls_; }
+
+    /// Returns headers with declarations included into translation unit
+    const std::vector<const source_file*> & included_headers() const { return included_headers_; }
+
+    /// Returns changed headers converted again and source files which
+    /// entities were removed together with entities of changed headers.
+    /// Translation units including them must be converted again
+    const std::vector<const source_file*> & removed_sources() const { return removed_sources_; }
+
+    /// Returns true if converter converts contents of contexts on demand
+    bool lazy() const { return lazy_; }
+
+    /// Returns number of contexts which contents are not converted yet
+    std::size_t pending_contexts() const { return pending_.size(); }
+
+    /// Converts contents of context on demand
+    void load(context * ctx) override;
+
+    /// Forgets context destroyed before converting its contents
+    void cancel(context * ctx) override;
+
+    /// Converts contents of all contexts which contents are not converted yet
+    bool load_all() override;
+
 
     //////////////////////////////////////////////////////////////////////
     // Types conversion
@@ -206,7 +295,9 @@ public:
     // Entities
 
     /// Finds code model entity associated with clang declaration.
-    /// First gets canonical declaration of clang declaration.
+    /// First gets canonical declaration of clang declaration. Declarations
+    /// from headers converted by other AST converters are associated with
+    /// existing entities on first lookup.
     /// Returns nullptr if associated context_entity not found
     context_entity * get_cm_entity(const ::clang::Decl * clang_decl);
 
@@ -230,11 +321,55 @@ public:
 
 private:
     /// Converts source location
-    source_location convert_loc(const ::clang::SourceLocation & loc) const;
+    source_location convert_loc(const ::clang::SourceLocation & loc);
+
+    /// Returns source file containing declaration or expansion of macro with
+    /// declaration. Returns nullptr for declarations from buffers without files
+    const source_file * decl_source(const ::clang::Decl * clang_decl);
+
+    /// Returns true if top level or namespace level declaration is declared
+    /// in header already converted by another AST converter. Updates counters
+    /// of converted and skipped declarations.
+    bool skip_converted_decl(const ::clang::Decl * clang_decl);
+
+    /// Returns true if declaration is declared in header already converted
+    /// by another AST converter. Removes entities converted from previous
+    /// content of header when changed header is found first time
+    bool is_skipped_decl(const ::clang::Decl * clang_decl);
+
+    /// Returns existing code model entity for declaration from header
+    /// converted by another AST converter. Entity is resolved by name in
+    /// context of parent declaration, template instantiations missing in
+    /// code model are converted. Returns nullptr if entity is not found
+    context_entity * resolve_skipped_decl(const ::clang::Decl * clang_decl);
+
+    /// Returns existing partial specialization of template for declaration
+    /// from header converted by another AST converter. Partial specialization
+    /// is found by template arguments. Returns nullptr if partial
+    /// specialization is not found
+    template_record_partial_specialization * resolve_skipped_partial_specialization(
+            const ::clang::ClassTemplatePartialSpecializationDecl * clang_decl);
+
+    /// Returns true if code model function has parameters of clang function
+    bool function_params_match(function * func, const ::clang::FunctionDecl * clang_func);
 
-    /// Converts all record contents and adds it to code model record
+    /// Converts all record contents and adds it to code model record. In lazy
+    /// mode contents are converted on first access to record
     void fill_record_contents(cm::record * rec, const ::clang::RecordDecl * clang_record_decl);
 
+    /// Converts all record contents immediately
+    void convert_record_contents(cm::record * rec, const ::clang::RecordDecl * clang_record_decl);
+
+    /// Defers conversion of contents of context until first access to
+    /// context. Contents is a record declaration of record or function
+    /// declaration of function, specs is a template declaration which
+    /// specializations are converted. Both declarations may be null
+    void defer_contents(context * ctx, const ::clang::Decl * contents, const ::clang::Decl * specs);
+
+    /// Converts contents of code model context enclosing clang declaration
+    /// if they are not converted yet. Returns true if contents are converted
+    bool load_decl_context(const ::clang::Decl * clang_decl);
+
     /// Converts and adds template parameters from clang AST to code model template
     void convert_template_params(templated_entity * templ,
                                  const ::clang::TemplateParameterList * clang_params);
@@ -273,7 +408,44 @@ private:
     const ::clang::ASTContext * clang_ast_ctx_ = nullptr;
 
     /// Map from clang canonical declarations to code model entities
-    std::map<const ::clang::Decl *, context_entity *> decls_;
+    pointer_map<::clang::Decl, context_entity> decls_;
+
+    /// Set of headers converted by other AST converters or nullptr
+    converted_headers * headers_;
+
+    /// Map from hash values of clang file IDs to flags indicating that
+    /// declarations from files are skipped
+    std::unordered_map<unsigned int, bool> skipped_files_;
+
+    /// Header file and hash of its content
+    using header = std::pair<const source_file*, std::size_t>;
+
+    /// Headers converted by this converter with hashes of their contents
+    std::vector<header> new_headers_;
+
+    /// Headers with declarations included into translation unit
+    std::vector<const source_file*> included_headers_;
+
+    /// Changed headers and source files which entities were removed with them
+    std::vector<const source_file*> removed_sources_;
+
+    std::size_t converted_decls_ = 0;       ///< Number of converted declarations
+    std::size_t skipped_decls_ = 0;         ///< Number of skipped declarations
+
+    /// Contents of context are converted on first access to context
+    bool lazy_;
+
+    /// Clang declarations of contents of context not converted yet
+    struct pending_decls {
+        const ::clang::Decl * contents = nullptr;   ///< Record or function declaration
+        const ::clang::Decl * specs = nullptr;      ///< Template declaration with specializations
+    };
+
+    /// Contexts which contents are not converted yet
+    std::unordered_map<context *, pending_decls> pending_;
+
+    /// Source files and lines of files of converted AST
+    source_location_cache locs_;
 };
 
 
@@ -10,17 +10,186 @@
 #pragma once
 
 #include "../../code_model.hpp"
+#include <clang-c/Index.h>
+#include <cstddef>
 #include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 
 namespace cm::clang {
 
 
+class ast_converter;
+class converted_headers;
+
+
 /// Parses code model from source file
 void parse_source_file(code_model & mdl,
                        const std::filesystem::path & path,
                        const std::vector<std::string> & args);
 
 
+/// Command for parsing source file
+struct parse_command {
+    std::filesystem::path path;             ///< Path to source file
+    std::vector<std::string> args;          ///< Command line arguments
+};
+
+
+/// Returns command for parsing source file from compile command with
+/// specified working directory, source file and command line starting with
+/// compiler name. Removes compiler name, source file, -c and options of
+/// output and dependency files from command line, adds working directory
+/// of command. Relative source file is relative to working directory.
+parse_command make_parse_command(const std::filesystem::path & dir,
+                                 const std::filesystem::path & file,
+                                 const std::vector<std::string> & cmd_line);
+
+
+/// Times of parsing and converting source file
+struct parse_timing {
+    std::filesystem::path path;             ///< Path to source file
+    double parse_ms = 0;                    ///< Time of parsing in milliseconds
+    double convert_ms = 0;                  ///< Time of converting to code model in milliseconds
+    std::size_t converted_decls = 0;        ///< Number of converted top level declarations
+    std::size_t skipped_decls = 0;          ///< Number of declarations skipped in converted headers
+};
+
+
+/// Parses code model from multiple source files with command line arguments
+/// specified for each source file. Source files are parsed in parallel by
+/// specified number of threads or by number of hardware threads if number of
+/// threads is 0. Parsed translation units are converted to code model one by
+/// one in order of commands, so resulting code model doesn't depend on number
+/// of threads. Declarations from headers already converted while parsing
+/// previous source files are skipped. If some source file can't be parsed,
+/// source files following it are not converted and exception is thrown. If
+/// timings is not null, it's filled with times of parsing and converting of
+/// source files in order of commands.
+void parse_source_files(code_model & mdl,
+                        const std::vector<parse_command> & cmds,
+                        unsigned int threads = 0,
+                        std::vector<parse_timing> * timings = nullptr);
+
+
+/// Parses code model from multiple source files with the same command line
+/// arguments in parallel
+void parse_source_files(code_model & mdl,
+                        const std::vector<std::filesystem::path> & paths,
+                        const std::vector<std::string> & args,
+                        unsigned int threads = 0);
+
+
+/// Options of parsing source files in parser session
+struct parse_options {
+    /// Precompile preambles of source files (includes at the beginning of
+    /// source files) on first parse and reuse them when reparsing source files
+    bool precompiled_preamble = true;
+
+    /// Skip parsing of function bodies. Code model doesn't contain function
+    /// bodies, but template instantiations used only in function bodies are
+    /// not converted to code model when bodies are skipped
+    bool skip_function_bodies = false;
+
+    /// Convert contents of records, signatures of functions and
+    /// specializations of templates on first access to them through code
+    /// model. Translation units are kept in session until their contents
+    /// are converted. First access through const accessors such as
+    /// context::entities(), context::find_named_entity() and
+    /// function::params() converts contents and modifies code model, so
+    /// code model can't be read concurrently until all contents are
+    /// converted or code model is frozen
+    bool lazy_conversion = false;
+};
+
+
+/// Long lived session of parsing source files into code model. Session keeps
+/// clang index and translation units of parsed source files, so edited source
+/// files are reparsed reusing precompiled preambles. Declarations from headers
+/// converted by previous parses in session are skipped. Entities using
+/// entities removed by reparsing source file or converting changed header
+/// are removed too, source files owning them are reparsed. In lazy conversion
+/// mode contents not converted yet are converted before reparsing or removing
+/// source files and destroying session. Session is not thread safe.
+class parser_session {
+public:
+    /// Constructs parser session for parsing source files into specified
+    /// code model with specified options. Code model must outlive session
+    explicit parser_session(code_model & mdl, const parse_options & opts = {});
+
+    // non copyable / non moveable
+    parser_session(const parser_session &) = delete;
+    parser_session(parser_session &&) = delete;
+    parser_session & operator=(const parser_session &) = delete;
+    parser_session & operator=(parser_session &&) = delete;
+
+    /// Destroys session with all translation units and clang index
+    ~parser_session();
+
+    /// Parses source file with specified command line arguments and converts
+    /// it to code model. Translation unit of source file is kept in session
+    /// for reparsing. Throws exception if source file can't be parsed
+    void parse(const std::filesystem::path & path, const std::vector<std::string> & args);
+
+    /// Reparses source file parsed in session with the same command line
+    /// arguments and converts it to code model. Reuses precompiled preamble
+    /// if included files are not changed. Entities converted from previous
+    /// version of source file are removed, declarations from unchanged
+    /// headers refer to entities already in code model. Throws exception if
+    /// source file was not parsed in session or can't be reparsed
+    void reparse(const std::filesystem::path & path);
+
+    /// Returns true if source file is parsed in session
+    bool is_parsed(const std::filesystem::path & path) const {
+        return tus_.contains(path.string());
+    }
+
+    /// Removes translation unit of source file from session
+    void remove(const std::filesystem::path & path);
+
+private:
+    /// Returns options of parsing translation units
+    unsigned int tu_options() const;
+
+    /// Reparses translation unit of source file and converts it to code model
+    void reparse_tu(const std::string & path, std::vector<std::string> & updated);
+
+    /// Removes entities converted from previous version of source file and
+    /// converts translation unit of source file. Source files which entities
+    /// were removed with entities of source file or changed headers are
+    /// reparsed unless they are in list of updated source files. Adds
+    /// paths of converted source files to list of updated source files.
+    /// Contents of other translation units not converted yet are converted
+    /// before removing entities
+    void update(const std::string & path, CXTranslationUnit tu, std::vector<std::string> & updated);
+
+    /// Converts translation unit of source file to code model. Returns
+    /// changed headers and source files which entities were removed with them
+    std::vector<const source_file*> convert(const std::string & path, CXTranslationUnit tu);
+
+    /// Converts contents of code model not converted yet from translation
+    /// unit of source file in lazy conversion mode
+    void finish_conversion(const std::string & path);
+
+    code_model & mdl_;                          ///< Code model
+    parse_options opts_;                        ///< Parse options
+    CXIndex index_;                             ///< Clang index
+
+    /// Headers converted to code model in session
+    std::unique_ptr<converted_headers> headers_;
+
+    /// Translation units of parsed source files by paths
+    std::unordered_map<std::string, CXTranslationUnit> tus_;
+
+    /// Converters of translation units in lazy conversion mode by paths
+    std::unordered_map<std::string, std::unique_ptr<ast_converter>> converters_;
+
+    /// Headers with declarations included into translation units by paths
+    std::unordered_map<std::string, std::vector<const source_file*>> included_headers_;
+};
+
+
 }
@@ -0,0 +1,92 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file source_location_cache.hpp
+/// Contains definition of the source_location_cache class.
+
+#pragma once
+
+#include "../../code_model.hpp"
+#include "../../line_table.hpp"
+#include "../../source_file.hpp"
+#include "../../source_location.hpp"
+#include <clang/Basic/SourceLocation.h>
+#include <clang/Basic/SourceManager.h>
+#include <unordered_map>
+
+
+namespace cm::clang {
+
+
+/// Converts clang source locations to code model source locations. Source
+/// files and line tables are cached by clang file IDs, so converting
+/// locations doesn't look up source files by paths in code model. Locations
+/// in files with line directives are converted to presumed locations by
+/// clang source manager.
+class source_location_cache {
+public:
+    /// Constructs cache for code model without source manager
+    explicit source_location_cache(code_model & mdl): mdl_{mdl} {}
+
+    // non copyable / non moveable
+    source_location_cache(const source_location_cache &) = delete;
+    source_location_cache(source_location_cache &&) = delete;
+    source_location_cache & operator=(const source_location_cache &) = delete;
+    source_location_cache & operator=(source_location_cache &&) = delete;
+
+    /// Sets source manager of converted AST and clears cache. File IDs are
+    /// specific to source manager, so cache is cleared for each AST
+    void reset(const ::clang::SourceManager * sm) {
+        sm_ = sm;
+        files_.clear();
+        last_fid_ = {};
+        last_file_ = nullptr;
+    }
+
+    /// Converts source location to code model source location. Returns
+    /// invalid location for invalid source locations
+    source_location convert(::clang::SourceLocation loc) {
+        auto res = presumed(loc);
+        return source_location{res.file, res.line, res.column};
+    }
+
+    /// Returns source file, line and column of source location without
+    /// encoding them in source location table. Returns location without file
+    /// for invalid source locations
+    decoded_source_location presumed(::clang::SourceLocation loc);
+
+    /// Returns source file with specified file ID or nullptr for invalid
+    /// file IDs and buffers without files
+    const source_file * file(::clang::FileID fid);
+
+private:
+    /// Cached information about file
+    struct file_info {
+        const source_file * file = nullptr;     ///< Source file or nullptr for buffers without files
+        const source_file * presumed = nullptr; ///< Source file of presumed locations
+        bool line_directives = false;           ///< File contains line directives
+        bool has_lines = false;                 ///< Line table is built
+        line_table lines;                       ///< Table of lines of file
+    };
+
+    /// Returns cached information about valid file ID
+    file_info & info(::clang::FileID fid);
+
+    /// Converts source location with presumed location from source manager
+    decoded_source_location convert_presumed(::clang::SourceLocation loc);
+
+    code_model & mdl_;                                  ///< Reference to code model
+    const ::clang::SourceManager * sm_ = nullptr;       ///< Source manager of converted AST
+
+    /// Files by hash values of clang file IDs
+    std::unordered_map<unsigned int, file_info> files_;
+
+    ::clang::FileID last_fid_;                          ///< File ID of last converted location
+    file_info * last_file_ = nullptr;                   ///< Information about last converted file
+};
+
+
+}
@@ -18,6 +18,9 @@ namespace cm {
 /// Represents type declared with the decltype(...) C++ keyword
 class decltype_type: virtual public context_type {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::decltype_type; }
+
     /// Constructs dependent type
     explicit decltype_type(context * ctx):
         context_type{ctx},
@@ -18,6 +18,9 @@ namespace cm {
 /// Represents C++ dependent name type (i.e. typename T::nested)
 class dependent_type: virtual public context_type {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::dependent_type; }
+
     /// Constructs dependent type
     explicit dependent_type(context * ctx):
         context_type{ctx},
@@ -9,12 +9,17 @@
 
 #pragma once
 
+#include "entity_kind.hpp"
+#include "entity_use_list.hpp"
 #include <cassert>
+#include <concepts>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <ranges>
-#include <set>
 #include <sstream>
+#include <type_traits>
 
 
 namespace cm {
@@ -25,9 +30,135 @@ class entity_use {
 public:
     /// Default virtual destructor
     virtual ~entity_use() = default;
+
+    /// Returns kind of the most derived entity class. Returns unknown kind
+    /// for classes defined outside of code model library.
+    virtual entity_kind ent_kind() const { return entity_kind::unknown; }
+
+    /// Allocates memory for object with global operator new
+    static void * operator new(std::size_t size) {
+        return allocate(size, nullptr);
+    }
+
+    /// Allocates memory for object from specified memory resource. Memory
+    /// resource must outlive object
+    static void * operator new(std::size_t size, std::pmr::memory_resource * res) {
+        return allocate(size, res);
+    }
+
+    /// Deallocates memory of object. Returns memory to resource it was allocated from
+    static void operator delete(void * ptr) {
+        deallocate(ptr);
+    }
+
+    /// Deallocates memory of object if constructor throws exception
+    static void operator delete(void * ptr, std::pmr::memory_resource *) {
+        deallocate(ptr);
+    }
+
+private:
+    /// Header of memory block of object, stores memory resource for deallocation
+    struct alloc_header {
+        std::pmr::memory_resource * res;        ///< Memory resource or nullptr for global operator new
+        std::size_t size;                       ///< Size of memory block including header
+    };
+
+    /// Alignment of memory blocks of objects
+    static constexpr std::size_t alloc_align = alignof(std::max_align_t);
+
+    /// Size of header rounded up to alignment of objects
+    static constexpr std::size_t alloc_header_size =
+        (sizeof(alloc_header) + alloc_align - 1) / alloc_align * alloc_align;
+
+    /// Allocates memory block with header for object of specified size
+    static void * allocate(std::size_t size, std::pmr::memory_resource * res) {
+        auto block_size = alloc_header_size + size;
+        auto block = res ? res->allocate(block_size, alloc_align) : ::operator new(block_size);
+        new (block) alloc_header{res, block_size};
+        return static_cast<char*>(block) + alloc_header_size;
+    }
+
+    /// Deallocates memory block of object
+    static void deallocate(void * ptr) {
+        if (!ptr) {
+            return;
+        }
+
+        auto block = static_cast<char*>(ptr) - alloc_header_size;
+        auto hdr = *reinterpret_cast<alloc_header*>(block);
+        if (hdr.res) {
+            hdr.res->deallocate(block, hdr.size, alloc_align);
+        } else {
+            ::operator delete(block);
+        }
+    }
 };
 
 
+/// Creates object derived from entity use in memory allocated from specified
+/// memory resource
+template <std::derived_from<entity_use> T, typename ... Args>
+std::unique_ptr<T> make_entity(std::pmr::memory_resource * res, Args && ... args) {
+    return std::unique_ptr<T>{new (res) T(std::forward<Args>(args)...)};
+}
+
+
+/// Casts pointer to entity use to pointer to specified entity class. Uses
+/// entity kind for rejecting invalid casts and for casting to final classes,
+/// falls back to dynamic_cast otherwise. Returns nullptr if cast is not possible.
+template <typename T, std::derived_from<entity_use> U>
+T * entity_cast(U * ptr) {
+    using class_t = std::remove_cv_t<T>;
+
+    if constexpr (std::derived_from<U, class_t>) {
+        return ptr;
+    } else {
+        if (!ptr) {
+            return nullptr;
+        }
+
+        if constexpr (entity_kind_traits<class_t>::has_kinds) {
+            auto knd = ptr->ent_kind();
+            if (knd != entity_kind::unknown) {
+                if (!entity_kind_traits<class_t>::kinds.contains(knd)) {
+                    assert(!dynamic_cast<T*>(ptr) && "invalid entity kind");
+                    return nullptr;
+                }
+
+                if constexpr (std::is_final_v<class_t>) {
+                    // kind of final class matches, pointer to the most derived
+                    // object is pointer to the class itself
+                    using void_t = std::conditional_t<std::is_const_v<U>, const void, void>;
+                    auto res = static_cast<T*>(dynamic_cast<void_t*>(ptr));
+                    assert(res == dynamic_cast<T*>(ptr) && "invalid entity kind");
+                    return res;
+                }
+            }
+        }
+
+        return dynamic_cast<T*>(ptr);
+    }
+}
+
+
+/// Checks if pointer to entity use points to object of specified entity class
+template <typename T, std::derived_from<entity_use> U>
+bool entity_isa(const U * ptr) {
+    if constexpr (entity_kind_traits<T>::has_kinds && !std::derived_from<U, T>) {
+        if (ptr) {
+            auto knd = ptr->ent_kind();
+            if (knd != entity_kind::unknown) {
+                bool res = entity_kind_traits<T>::kinds.contains(knd);
+                assert(res == (dynamic_cast<const T*>(ptr) != nullptr) && "invalid entity kind");
+                return res;
+            }
+        }
+    }
+
+    return entity_cast<const T>(ptr) != nullptr;
+}
+
+
 /// Options for dumping entities
 struct dump_options {
     bool builtins = false;
@@ -38,22 +169,24 @@ struct dump_options {
 /// Base class for all code model entities
 class entity: virtual public entity_use {
 public:
-    /// Destroys entity. Checks that entity has no uses.
+    /// Destroys entity. Checks that entity has no uses unless it's
+    /// destroyed inside teardown scope.
     virtual ~entity() {
-        assert(uses_.empty() && "can't delete entity with uses");
+        assert((uses_.empty() || entity_teardown_scope::active()) &&
+               "can't delete entity with uses");
     }
 
-    /// Performs dynamic cast to specified type
+    /// Casts entity to specified type
     template <typename T>
-    T * cast() { return dynamic_cast<T*>(this); }
+    T * cast() { return entity_cast<T>(this); }
 
-    /// Performs dynamic cast to specified type
+    /// Casts entity to specified type
     template <typename T>
-    const T * cast() const { return dynamic_cast<const T*>(this); }
+    const T * cast() const { return entity_cast<const T>(this); }
 
     /// Checks if type can be casted to another type
     template <typename T>
-    bool is() const { return cast<T>() != nullptr; }
+    bool is() const { return entity_isa<T>(this); }
 
     /// Returns const range of entity uses
     auto uses() const {
@@ -71,7 +204,7 @@ public:
     template <typename UseType>
     auto uses() const {
         auto transform_fn = [](const entity_use * use) {
-            return dynamic_cast<const UseType*>(use);
+            return entity_cast<const UseType>(use);
         };
 
         auto filter_fn = [](const UseType * use) {
@@ -87,7 +220,7 @@ public:
     template <typename UseType>
     auto uses() {
         auto transform_fn = [](entity_use * use) {
-            return dynamic_cast<UseType*>(use);
+            return entity_cast<UseType>(use);
         };
 
         auto filter_fn = [](UseType * use) {
@@ -99,16 +232,30 @@ public:
             | std::ranges::views::filter(filter_fn);
     }
 
-    /// Adds use of type
-    void add_use(entity_use * use) {
-        uses_.insert(use);
+    /// Returns number of entity uses
+    std::size_t uses_count() const { return uses_.size(); }
+
+    /// Adds use of entity via specified link owned by the use
+    void add_use(entity_use * use, entity_use_link & link) {
+        uses_.push_back(link, use);
+    }
+
+    /// Removes use of entity added via specified link
+    void remove_use(entity_use_link & link) {
+        uses_.erase(link);
     }
 
-    /// Removes use of type
-    void remove_use(entity_use * use) {
-        auto it = uses_.find(use);
-        assert(it != uses_.end() && "use does not exist");
-        uses_.erase(it);
+    /// Returns true if entity is frozen
+    bool is_frozen() const { return uses_.frozen(); }
+
+    /// Freezes entity. Uses of frozen entity added after freezing are not
+    /// tracked, frozen entity must not be modified
+    void freeze() { uses_.freeze(); }
+
+    /// Drops all uses of entity without unlinking them. Allowed only inside
+    /// teardown scope for entities which outlive destroyed uses
+    void drop_uses() {
+        uses_.drop();
     }
 
     /// Returns true if entity is builtin entity (defined by language or compiler)
@@ -152,7 +299,7 @@ public:
     }
 
 private:
-    std::multiset<entity_use*> uses_;               ///< Set of uses of entity
+    entity_use_list uses_;                          ///< List of uses of entity
 };
 
 
@@ -171,9 +318,12 @@ public:
     entity_use_impl & operator=(const entity_use_impl &) = delete;
     entity_use_impl & operator=(entity_use_impl &&) = delete;
 
-    /// Destroys use of entity. Removes this instance from the list of entity uses.
+    /// Destroys use of entity. Removes this instance from the list of entity
+    /// uses unless it's destroyed inside teardown scope.
     ~entity_use_impl() override {
-        do_remove_use();
+        if (!entity_teardown_scope::active()) {
+            do_remove_use();
+        }
     }
 
     /// Returns pointer to used entity
@@ -194,18 +344,19 @@ private:
     /// Adds this use to the list of uses of current entity if it's not null
     void do_add_use() {
         if (used_entity_) {
-            used_entity_->add_use(this);
+            used_entity_->add_use(this, use_link_);
         }
     }
 
     /// Removes this use from the list of uses of current used entity if it's not null
     void do_remove_use() {
         if (used_entity_) {
-            used_entity_->remove_use(this);
+            used_entity_->remove_use(use_link_);
         }
     }
 
     Entity * used_entity_;          ///< Pointer to used entity
+    entity_use_link use_link_;      ///< Link in the list of uses of used entity
 };
 
 
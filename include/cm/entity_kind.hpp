@@ -0,0 +1,479 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file entity_kind.hpp
+/// Contains definition of the entity_kind enum and sets of entity kinds
+/// for all entity classes.
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+
+namespace cm {
+
+
+class array_or_vector_type;
+class array_type;
+class builtin_type;
+class code_model;
+class context;
+class context_entity;
+class context_type;
+class decltype_type;
+class dependent_type;
+class enum_type;
+class field;
+class function;
+class function_parameter;
+class function_type;
+class lvalue_reference_type;
+class mem_ptr_type;
+class method;
+class named_context_entity;
+class named_entity;
+class named_function;
+class named_function_parameter;
+class named_method;
+class named_record_type;
+class named_type;
+class namespace_;
+class pointer_type;
+class ptr_or_ref_type;
+class record;
+class record_type;
+class rvalue_reference_type;
+class single_type_use;
+class static_record_function;
+class static_record_variable;
+class template_;
+class template_argument;
+class template_dependent_instantiation;
+class template_function;
+class template_function_instantiation;
+class template_instantiation;
+class template_method;
+class template_method_instantiation;
+class template_name;
+class template_parameter;
+class template_record;
+class template_record_dependent_instantiation_type;
+class template_record_instantiation_type;
+class template_record_partial_specialization;
+class template_record_specialization_type;
+class template_record_substitution;
+class template_record_type;
+class template_specialization;
+class template_substitution;
+class templated_entity;
+class type_t;
+class type_template_argument;
+class type_template_parameter;
+class typedef_type;
+class value_template_argument;
+class value_template_parameter;
+class variable;
+class vector_type;
+
+
+/// Kind of the most derived class of code model entity. Used for fast
+/// checking of entity class instead of dynamic_cast through the virtual
+/// inheritance lattice.
+enum class entity_kind: unsigned char {
+    unknown,            ///< Class defined outside of code model library
+
+    // types
+    builtin_type,
+    function_type,
+    mem_ptr_type,
+    pointer_type,
+    lvalue_reference_type,
+    rvalue_reference_type,
+    array_type,
+    vector_type,
+
+    // context types
+    decltype_type,
+    dependent_type,
+    typedef_type,
+    enum_type,
+    record_type,
+    named_record_type,
+    template_record_type,
+    template_record_instantiation_type,
+    template_record_specialization_type,
+    template_record_dependent_instantiation_type,
+
+    // template parameters
+    type_template_parameter,
+    value_template_parameter,
+
+    // variables
+    variable,
+    field,
+    static_record_variable,
+
+    // functions
+    function_parameter,
+    named_function_parameter,
+    named_function,
+    named_method,
+    template_function,
+    template_method,
+    template_function_instantiation,
+    template_method_instantiation,
+
+    // templates
+    template_record,
+    template_record_partial_specialization,
+    type_template_argument,
+    value_template_argument,
+
+    // namespaces
+    namespace_,
+    code_model,
+
+    last_ = code_model
+};
+
+
+/// Set of entity kinds
+class entity_kind_set {
+    static_assert(static_cast<unsigned int>(entity_kind::last_) < 64,
+                  "too many entity kinds for entity kind set");
+
+public:
+    /// Constructs set of entity kinds from list of kinds
+    constexpr entity_kind_set(std::initializer_list<entity_kind> kinds) {
+        for (auto k : kinds) {
+            bits_ |= std::uint64_t{1} << static_cast<unsigned int>(k);
+        }
+    }
+
+    /// Returns true if set contains specified kind
+    constexpr bool contains(entity_kind k) const {
+        return (bits_ >> static_cast<unsigned int>(k)) & 1;
+    }
+
+    /// Returns number of kinds in set
+    constexpr std::size_t size() const {
+        return std::popcount(bits_);
+    }
+
+private:
+    std::uint64_t bits_ = 0;        ///< Bit mask of kinds
+};
+
+
+/// Contains set of kinds of the class and all its derived classes. Classes
+/// without specialization have no kind information, checking of such classes
+/// is done with dynamic_cast.
+template <typename T>
+struct entity_kind_traits {
+    static constexpr bool has_kinds = false;
+};
+
+
+/// Macro for defining set of entity kinds for entity class
+#define CM_DEF_ENTITY_KINDS(cls, ...) \
+    template <> \
+    struct entity_kind_traits<cls> { \
+        static constexpr bool has_kinds = true; \
+        static constexpr entity_kind_set kinds{__VA_ARGS__}; \
+    };
+
+
+/// Macro for defining set of entity kinds for final entity class
+#define CM_DEF_FINAL_ENTITY_KIND(cls) CM_DEF_ENTITY_KINDS(cls, entity_kind::cls)
+
+
+// Entity kinds for classes that have no derived classes
+
+CM_DEF_FINAL_ENTITY_KIND(builtin_type)
+CM_DEF_FINAL_ENTITY_KIND(function_type)
+CM_DEF_FINAL_ENTITY_KIND(mem_ptr_type)
+CM_DEF_FINAL_ENTITY_KIND(pointer_type)
+CM_DEF_FINAL_ENTITY_KIND(lvalue_reference_type)
+CM_DEF_FINAL_ENTITY_KIND(rvalue_reference_type)
+CM_DEF_FINAL_ENTITY_KIND(array_type)
+CM_DEF_FINAL_ENTITY_KIND(vector_type)
+CM_DEF_FINAL_ENTITY_KIND(decltype_type)
+CM_DEF_FINAL_ENTITY_KIND(dependent_type)
+CM_DEF_FINAL_ENTITY_KIND(typedef_type)
+CM_DEF_FINAL_ENTITY_KIND(enum_type)
+CM_DEF_FINAL_ENTITY_KIND(named_record_type)
+CM_DEF_FINAL_ENTITY_KIND(template_record_type)
+CM_DEF_FINAL_ENTITY_KIND(template_record_specialization_type)
+CM_DEF_FINAL_ENTITY_KIND(template_record_dependent_instantiation_type)
+CM_DEF_FINAL_ENTITY_KIND(type_template_parameter)
+CM_DEF_FINAL_ENTITY_KIND(value_template_parameter)
+CM_DEF_FINAL_ENTITY_KIND(field)
+CM_DEF_FINAL_ENTITY_KIND(static_record_variable)
+CM_DEF_FINAL_ENTITY_KIND(named_function_parameter)
+CM_DEF_FINAL_ENTITY_KIND(template_method)
+CM_DEF_FINAL_ENTITY_KIND(template_method_instantiation)
+CM_DEF_FINAL_ENTITY_KIND(template_record)
+CM_DEF_FINAL_ENTITY_KIND(template_record_partial_specialization)
+CM_DEF_FINAL_ENTITY_KIND(type_template_argument)
+CM_DEF_FINAL_ENTITY_KIND(value_template_argument)
+CM_DEF_FINAL_ENTITY_KIND(code_model)
+
+
+// Entity kinds for classes that have derived classes
+
+CM_DEF_ENTITY_KINDS(type_t,
+                    entity_kind::builtin_type,
+                    entity_kind::function_type,
+                    entity_kind::mem_ptr_type,
+                    entity_kind::pointer_type,
+                    entity_kind::lvalue_reference_type,
+                    entity_kind::rvalue_reference_type,
+                    entity_kind::array_type,
+                    entity_kind::vector_type,
+                    entity_kind::decltype_type,
+                    entity_kind::dependent_type,
+                    entity_kind::typedef_type,
+                    entity_kind::enum_type,
+                    entity_kind::record_type,
+                    entity_kind::named_record_type,
+                    entity_kind::template_record_type,
+                    entity_kind::template_record_instantiation_type,
+                    entity_kind::template_record_specialization_type,
+                    entity_kind::template_record_dependent_instantiation_type,
+                    entity_kind::type_template_parameter)
+
+CM_DEF_ENTITY_KINDS(ptr_or_ref_type,
+                    entity_kind::pointer_type,
+                    entity_kind::lvalue_reference_type,
+                    entity_kind::rvalue_reference_type)
+
+CM_DEF_ENTITY_KINDS(array_or_vector_type,
+                    entity_kind::array_type,
+                    entity_kind::vector_type)
+
+CM_DEF_ENTITY_KINDS(context_type,
+                    entity_kind::decltype_type,
+                    entity_kind::dependent_type,
+                    entity_kind::typedef_type,
+                    entity_kind::enum_type,
+                    entity_kind::record_type,
+                    entity_kind::named_record_type,
+                    entity_kind::template_record_type,
+                    entity_kind::template_record_instantiation_type,
+                    entity_kind::template_record_specialization_type,
+                    entity_kind::template_record_dependent_instantiation_type)
+
+CM_DEF_ENTITY_KINDS(named_type,
+                    entity_kind::typedef_type,
+                    entity_kind::enum_type,
+                    entity_kind::named_record_type)
+
+CM_DEF_ENTITY_KINDS(context_entity,
+                    entity_kind::decltype_type,
+                    entity_kind::dependent_type,
+                    entity_kind::typedef_type,
+                    entity_kind::enum_type,
+                    entity_kind::record_type,
+                    entity_kind::named_record_type,
+                    entity_kind::template_record_type,
+                    entity_kind::template_record_instantiation_type,
+                    entity_kind::template_record_specialization_type,
+                    entity_kind::template_record_dependent_instantiation_type,
+                    entity_kind::type_template_parameter,
+                    entity_kind::value_template_parameter,
+                    entity_kind::variable,
+                    entity_kind::field,
+                    entity_kind::static_record_variable,
+                    entity_kind::named_function,
+                    entity_kind::named_method,
+                    entity_kind::template_function,
+                    entity_kind::template_method,
+                    entity_kind::template_function_instantiation,
+                    entity_kind::template_method_instantiation,
+                    entity_kind::template_record,
+                    entity_kind::template_record_partial_specialization,
+                    entity_kind::namespace_,
+                    entity_kind::code_model)
+
+CM_DEF_ENTITY_KINDS(named_entity,
+                    entity_kind::typedef_type,
+                    entity_kind::enum_type,
+                    entity_kind::named_record_type,
+                    entity_kind::type_template_parameter,
+                    entity_kind::value_template_parameter,
+                    entity_kind::variable,
+                    entity_kind::field,
+                    entity_kind::static_record_variable,
+                    entity_kind::named_function_parameter,
+                    entity_kind::named_function,
+                    entity_kind::named_method,
+                    entity_kind::template_function,
+                    entity_kind::template_method,
+                    entity_kind::template_record,
+                    entity_kind::namespace_,
+                    entity_kind::code_model)
+
+CM_DEF_ENTITY_KINDS(named_context_entity,
+                    entity_kind::typedef_type,
+                    entity_kind::enum_type,
+                    entity_kind::named_record_type,
+                    entity_kind::type_template_parameter,
+                    entity_kind::value_template_parameter,
+                    entity_kind::variable,
+                    entity_kind::field,
+                    entity_kind::static_record_variable,
+                    entity_kind::named_function,
+                    entity_kind::named_method,
+                    entity_kind::template_function,
+                    entity_kind::template_method,
+                    entity_kind::template_record)
+
+CM_DEF_ENTITY_KINDS(context,
+                    entity_kind::record_type,
+                    entity_kind::named_record_type,
+                    entity_kind::template_record_instantiation_type,
+                    entity_kind::template_record_specialization_type,
+                    entity_kind::named_function,
+                    entity_kind::named_method,
+                    entity_kind::template_function,
+                    entity_kind::template_method,
+                    entity_kind::template_function_instantiation,
+                    entity_kind::template_method_instantiation,
+                    entity_kind::template_record,
+                    entity_kind::template_record_partial_specialization,
+                    entity_kind::namespace_,
+                    entity_kind::code_model)
+
+CM_DEF_ENTITY_KINDS(namespace_,
+                    entity_kind::namespace_,
+                    entity_kind::code_model)
+
+CM_DEF_ENTITY_KINDS(record,
+                    entity_kind::record_type,
+                    entity_kind::named_record_type,
+                    entity_kind::template_record_instantiation_type,
+                    entity_kind::template_record_specialization_type,
+                    entity_kind::template_record,
+                    entity_kind::template_record_partial_specialization)
+
+CM_DEF_ENTITY_KINDS(record_type,
+                    entity_kind::record_type,
+                    entity_kind::named_record_type,
+                    entity_kind::template_record_instantiation_type,
+                    entity_kind::template_record_specialization_type)
+
+CM_DEF_ENTITY_KINDS(single_type_use,
+                    entity_kind::variable,
+                    entity_kind::field,
+                    entity_kind::static_record_variable,
+                    entity_kind::function_parameter,
+                    entity_kind::named_function_parameter)
+
+CM_DEF_ENTITY_KINDS(variable,
+                    entity_kind::variable,
+                    entity_kind::field,
+                    entity_kind::static_record_variable)
+
+CM_DEF_ENTITY_KINDS(function_parameter,
+                    entity_kind::function_parameter,
+                    entity_kind::named_function_parameter)
+
+CM_DEF_ENTITY_KINDS(function,
+                    entity_kind::named_function,
+                    entity_kind::named_method,
+                    entity_kind::template_function,
+                    entity_kind::template_method,
+                    entity_kind::template_function_instantiation,
+                    entity_kind::template_method_instantiation)
+
+// template_method contains two named_function base subobjects (via
+// template_function and named_method), so it can't be casted to named_function
+CM_DEF_ENTITY_KINDS(named_function,
+                    entity_kind::named_function,
+                    entity_kind::named_method,
+                    entity_kind::template_function)
+
+CM_DEF_ENTITY_KINDS(method,
+                    entity_kind::named_method,
+                    entity_kind::template_method,
+                    entity_kind::template_method_instantiation)
+
+CM_DEF_ENTITY_KINDS(named_method,
+                    entity_kind::named_method,
+                    entity_kind::template_method)
+
+CM_DEF_ENTITY_KINDS(static_record_function)
+
+CM_DEF_ENTITY_KINDS(template_name,
+                    entity_kind::template_function,
+                    entity_kind::template_method,
+                    entity_kind::template_record)
+
+CM_DEF_ENTITY_KINDS(template_,
+                    entity_kind::template_function,
+                    entity_kind::template_method,
+                    entity_kind::template_record)
+
+CM_DEF_ENTITY_KINDS(templated_entity,
+                    entity_kind::template_function,
+                    entity_kind::template_method,
+                    entity_kind::template_record,
+                    entity_kind::template_record_partial_specialization)
+
+CM_DEF_ENTITY_KINDS(template_function,
+                    entity_kind::template_function,
+                    entity_kind::template_method)
+
+CM_DEF_ENTITY_KINDS(template_parameter,
+                    entity_kind::type_template_parameter,
+                    entity_kind::value_template_parameter)
+
+CM_DEF_ENTITY_KINDS(template_argument,
+                    entity_kind::type_template_argument,
+                    entity_kind::value_template_argument)
+
+CM_DEF_ENTITY_KINDS(template_substitution,
+                    entity_kind::template_record_instantiation_type,
+                    entity_kind::template_record_specialization_type,
+                    entity_kind::template_record_dependent_instantiation_type,
+                    entity_kind::template_function_instantiation,
+                    entity_kind::template_method_instantiation,
+                    entity_kind::template_record_partial_specialization)
+
+CM_DEF_ENTITY_KINDS(template_instantiation,
+                    entity_kind::template_record_instantiation_type,
+                    entity_kind::template_record_specialization_type,
+                    entity_kind::template_function_instantiation,
+                    entity_kind::template_method_instantiation)
+
+CM_DEF_ENTITY_KINDS(template_specialization,
+                    entity_kind::template_record_specialization_type)
+
+CM_DEF_ENTITY_KINDS(template_dependent_instantiation,
+                    entity_kind::template_record_dependent_instantiation_type)
+
+CM_DEF_ENTITY_KINDS(template_record_substitution,
+                    entity_kind::template_record_instantiation_type,
+                    entity_kind::template_record_specialization_type,
+                    entity_kind::template_record_dependent_instantiation_type)
+
+CM_DEF_ENTITY_KINDS(template_record_instantiation_type,
+                    entity_kind::template_record_instantiation_type,
+                    entity_kind::template_record_specialization_type)
+
+CM_DEF_ENTITY_KINDS(template_function_instantiation,
+                    entity_kind::template_function_instantiation,
+                    entity_kind::template_method_instantiation)
+
+
+#undef CM_DEF_FINAL_ENTITY_KIND
+#undef CM_DEF_ENTITY_KINDS
+
+
+}
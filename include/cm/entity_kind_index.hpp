@@ -0,0 +1,263 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file entity_kind_index.hpp
+/// Contains definition of the entity_kind_index class.
+
+#pragma once
+
+#include "context_entity.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+
+namespace cm {
+
+
+/// Index of context entities by entity kind. Keeps entities of each kind in
+/// order of insertion, so entities of some class can be iterated in order of
+/// insertion visiting only entities of kinds of this class. Removed entities
+/// leave empty entries, which are compacted when entries of kind grow.
+class entity_kind_index {
+public:
+    /// Number of entity kinds including unknown kind
+    static constexpr std::size_t num_kinds = static_cast<std::size_t>(entity_kind::last_) + 1;
+
+    /// Entry of index
+    struct entry {
+        std::uint64_t seq;          ///< Sequence number of entity in order of insertion
+        context_entity * ent;       ///< Pointer to entity or nullptr if entity is removed
+    };
+
+    /// Entries of one kind
+    struct kind_entries {
+        std::vector<entry> entries;         ///< Entries in order of insertion
+        std::size_t first = 0;              ///< Index of the first not empty entry
+        std::size_t num_empty = 0;          ///< Number of empty entries
+    };
+
+    /// Iterator over entities of class T in order of insertion. Merges entries
+    /// of all kinds of class T and entries of unknown kind by sequence number.
+    template <typename T>
+    class iterator {
+        using class_t = std::remove_cv_t<T>;
+        static_assert(entity_kind_traits<class_t>::has_kinds, "class has no entity kinds");
+
+        /// Kinds of entities of class T
+        static constexpr entity_kind_set kinds = entity_kind_traits<class_t>::kinds;
+
+        /// Maximum number of non empty kinds including unknown kind
+        static constexpr std::size_t max_cursors = kinds.size() + 1;
+
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T *;
+        using difference_type = std::ptrdiff_t;
+
+        /// Constructs end iterator
+        iterator() = default;
+
+        /// Constructs iterator pointing to the first entity of class T in index
+        explicit iterator(const entity_kind_index & idx) {
+            for (std::size_t i = 0; i < num_kinds; ++i) {
+                auto knd = static_cast<entity_kind>(i);
+                auto & ke = idx.entries_[i];
+
+                // entities of unknown kind may be of any class
+                if (ke.first != ke.entries.size() &&
+                    (knd == entity_kind::unknown || kinds.contains(knd))) {
+                    auto data = ke.entries.data();
+                    cursors_[num_cursors_++] = {data + ke.first, data + ke.entries.size()};
+                }
+            }
+
+            find_next();
+        }
+
+        /// Returns pointer to entity
+        T * operator*() const { return entity_cast<T>(cursors_[cur_].first->ent); }
+
+        /// Moves iterator to the next entity
+        iterator & operator++() {
+            advance();
+            find_next();
+            return *this;
+        }
+
+        /// Moves iterator to the next entity
+        iterator operator++(int) {
+            auto res = *this;
+            ++*this;
+            return res;
+        }
+
+        /// Compares iterators
+        bool operator==(const iterator & other) const {
+            if (num_cursors_ == 0 || other.num_cursors_ == 0) {
+                return num_cursors_ == other.num_cursors_;
+            }
+
+            return cursors_[cur_].first == other.cursors_[other.cur_].first;
+        }
+
+    private:
+        /// Range of not visited entries of one kind
+        struct cursor {
+            const entry * first;        ///< Next entry
+            const entry * last;         ///< End of entries
+        };
+
+        /// Moves current cursor to the next not empty entry, removes cursor
+        /// if it reaches end
+        void advance() {
+            auto & cur = cursors_[cur_];
+            do {
+                ++cur.first;
+            } while (cur.first != cur.last && !cur.first->ent);
+
+            if (cur.first == cur.last) {
+                cur = cursors_[--num_cursors_];
+            }
+        }
+
+        /// Selects cursor pointing to entity of class T with minimal sequence number
+        void find_next() {
+            // skipping empty entries at the beginning of cursors
+            for (std::size_t i = 0; i < num_cursors_;) {
+                auto & cur = cursors_[i];
+                while (cur.first != cur.last && !cur.first->ent) {
+                    ++cur.first;
+                }
+
+                if (cur.first == cur.last) {
+                    cur = cursors_[--num_cursors_];
+                } else {
+                    ++i;
+                }
+            }
+
+            while (num_cursors_ != 0) {
+                cur_ = 0;
+                for (std::size_t i = 1; i < num_cursors_; ++i) {
+                    if (cursors_[i].first->seq < cursors_[cur_].first->seq) {
+                        cur_ = i;
+                    }
+                }
+
+                // skipping entities of unknown kind that are not of class T
+                auto ent = cursors_[cur_].first->ent;
+                if (ent->ent_kind() != entity_kind::unknown || entity_cast<T>(ent)) {
+                    return;
+                }
+
+                advance();
+            }
+        }
+
+        std::array<cursor, max_cursors> cursors_;   ///< Cursors of non empty kinds
+        std::size_t num_cursors_ = 0;               ///< Number of cursors
+        std::size_t cur_ = 0;                       ///< Index of current cursor
+    };
+
+    /// View of entities of class T in index. Iterators are obtained from index
+    /// on each call of begin, so view stays valid after adding and removing entities.
+    template <typename T>
+    class view: public std::ranges::view_interface<view<T>> {
+    public:
+        /// Constructs empty view
+        view() = default;
+
+        /// Constructs view of specified index
+        explicit view(const entity_kind_index & idx): idx_{&idx} {}
+
+        /// Returns iterator to the first entity
+        iterator<T> begin() const { return iterator<T>{*idx_}; }
+
+        /// Returns iterator past the last entity
+        iterator<T> end() const { return iterator<T>{}; }
+
+    private:
+        const entity_kind_index * idx_ = nullptr;       ///< Pointer to index
+    };
+
+    /// Adds entity to the end of index
+    void push_back(context_entity * ent) {
+        auto & ke = get_kind_entries(ent);
+
+        // compacting entries if there are more empty entries than entities
+        if (ke.num_empty > ke.entries.size() / 2) {
+            compact(ke);
+        }
+
+        ent->kind_slot_ = ke.entries.size();
+        ke.entries.push_back({next_seq_++, ent});
+    }
+
+    /// Removes entity from index
+    void erase(context_entity * ent) {
+        auto & ke = get_kind_entries(ent);
+        auto slot = ent->kind_slot_;
+        assert(slot < ke.entries.size() && ke.entries[slot].ent == ent &&
+               "entity not found in kind index");
+
+        ke.entries[slot].ent = nullptr;
+        ++ke.num_empty;
+
+        // updating position of the first entry
+        while (ke.first != ke.entries.size() && !ke.entries[ke.first].ent) {
+            ++ke.first;
+        }
+    }
+
+    /// Removes all entities from index
+    void clear() {
+        for (auto && ke : entries_) {
+            ke = {};
+        }
+    }
+
+    /// Returns view of entities of class T in order of insertion
+    template <typename T>
+    view<T> entities() const {
+        return view<T>{*this};
+    }
+
+private:
+    /// Returns reference to entries of kind of entity
+    kind_entries & get_kind_entries(context_entity * ent) {
+        return entries_[static_cast<std::size_t>(ent->ent_kind())];
+    }
+
+    /// Removes empty entries of kind, updates slots of entities
+    static void compact(kind_entries & ke) {
+        std::erase_if(ke.entries, [](const entry & e) { return e.ent == nullptr; });
+
+        for (std::size_t i = 0; i < ke.entries.size(); ++i) {
+            ke.entries[i].ent->kind_slot_ = i;
+        }
+
+        ke.first = 0;
+        ke.num_empty = 0;
+    }
+
+    std::array<kind_entries, num_kinds> entries_;       ///< Entries of each kind
+    std::uint64_t next_seq_ = 0;                        ///< Next sequence number
+};
+
+
+}
+
+
+/// Views of entity_kind_index don't own entities, iterators stay valid after destroying view
+template <typename T>
+inline constexpr bool std::ranges::enable_borrowed_range<cm::entity_kind_index::view<T>> = true;
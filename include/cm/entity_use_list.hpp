@@ -0,0 +1,231 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file entity_use_list.hpp
+/// Contains definition of the entity_use_link and entity_use_list classes.
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+
+
+namespace cm {
+
+
+class entity_use;
+class entity_use_list;
+
+
+/// Scope of bulk destruction of entities. Inside this scope entities are
+/// destroyed without maintaining lists of uses: destroyed uses are not
+/// removed from lists of used entities, which may be already destroyed,
+/// and entities may be destroyed with non empty lists of uses. Entities
+/// destroyed after the scope must have their lists of uses dropped with
+/// entity::drop_uses inside the scope.
+class entity_teardown_scope {
+public:
+    /// Enters teardown scope
+    entity_teardown_scope() { ++depth_; }
+
+    /// Leaves teardown scope
+    ~entity_teardown_scope() { --depth_; }
+
+    // non copyable / non moveable
+    entity_teardown_scope(const entity_teardown_scope &) = delete;
+    entity_teardown_scope(entity_teardown_scope &&) = delete;
+    entity_teardown_scope & operator=(const entity_teardown_scope &) = delete;
+    entity_teardown_scope & operator=(entity_teardown_scope &&) = delete;
+
+    /// Returns true if current thread is inside teardown scope
+    static bool active() { return depth_ != 0; }
+
+private:
+    static inline thread_local unsigned int depth_ = 0;     ///< Number of nested scopes
+};
+
+
+/// Node of the intrusive list of entity uses. Object that uses an entity
+/// owns one link for each use it adds, so adding and removing of uses
+/// does not allocate memory.
+class entity_use_link {
+    friend class entity_use_list;
+
+public:
+    /// Constructs unlinked use link
+    entity_use_link() = default;
+
+    // non copyable / non moveable, list contains pointers to links
+    entity_use_link(const entity_use_link &) = delete;
+    entity_use_link(entity_use_link &&) = delete;
+    entity_use_link & operator=(const entity_use_link &) = delete;
+    entity_use_link & operator=(entity_use_link &&) = delete;
+
+    /// Destroys use link. Checks that link is not in the list of uses
+    /// unless it's destroyed inside teardown scope
+    ~entity_use_link() {
+        assert((!is_linked() || entity_teardown_scope::active()) &&
+               "can't destroy linked entity use");
+    }
+
+    /// Returns pointer to use or nullptr if link is not in the list of uses
+    entity_use * use() const { return use_; }
+
+    /// Returns true if link is in the list of uses
+    bool is_linked() const { return use_ != nullptr; }
+
+private:
+    entity_use * use_ = nullptr;            ///< Pointer to use
+    entity_use_link * prev_ = nullptr;      ///< Previous link in list
+    entity_use_link * next_ = nullptr;      ///< Next link in list
+};
+
+
+/// Intrusive doubly linked list of entity uses. Same use may be added to
+/// the list several times via different links. Frozen list keeps its
+/// current uses and ignores adding and removing of other uses, so entities
+/// of frozen code model may be used by entities of its forks without
+/// modifying frozen code model.
+class entity_use_list {
+public:
+    /// Iterator over entity uses
+    class iterator {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = entity_use *;
+        using difference_type = std::ptrdiff_t;
+
+        /// Constructs iterator pointing to specified link
+        explicit iterator(const entity_use_link * link = nullptr):
+            link_{link} {}
+
+        /// Returns pointer to use
+        entity_use * operator*() const { return link_->use_; }
+
+        /// Moves iterator to the next use
+        iterator & operator++() {
+            link_ = link_->next_;
+            return *this;
+        }
+
+        /// Moves iterator to the next use
+        iterator operator++(int) {
+            auto res = *this;
+            ++*this;
+            return res;
+        }
+
+        /// Compares iterators
+        bool operator==(const iterator & other) const = default;
+
+    private:
+        const entity_use_link * link_;      ///< Current link
+    };
+
+    /// Constructs empty list of uses
+    entity_use_list() = default;
+
+    /// Constructs empty list of uses. Uses are never copied with entity,
+    /// so the source list must be empty.
+    entity_use_list(const entity_use_list & other) {
+        assert(other.empty() && "can't copy list of uses");
+    }
+
+    /// Assigns list of uses. Both lists must be empty
+    entity_use_list & operator=(const entity_use_list & other) {
+        assert(empty() && other.empty() && "can't copy list of uses");
+        return *this;
+    }
+
+    /// Returns iterator to the first use
+    iterator begin() const { return iterator{first_}; }
+
+    /// Returns iterator past the last use
+    iterator end() const { return iterator{}; }
+
+    /// Returns true if list has no uses
+    bool empty() const { return first_ == nullptr; }
+
+    /// Returns number of uses in list
+    std::size_t size() const { return size_; }
+
+    /// Returns true if list is frozen
+    bool frozen() const { return frozen_; }
+
+    /// Freezes list. Uses added after freezing are not linked into list
+    void freeze() { frozen_ = true; }
+
+    /// Adds use at the end of the list via specified link. Link is left
+    /// unlinked if list is frozen
+    void push_back(entity_use_link & link, entity_use * use) {
+        assert(!link.is_linked() && "use link is already in list");
+        assert(use && "use must not be null");
+
+        if (frozen_) {
+            return;
+        }
+
+        link.use_ = use;
+        link.prev_ = last_;
+        link.next_ = nullptr;
+
+        if (last_) {
+            last_->next_ = &link;
+        } else {
+            first_ = &link;
+        }
+
+        last_ = &link;
+        ++size_;
+    }
+
+    /// Removes link from the list
+    void erase(entity_use_link & link) {
+        // use added after freezing was not linked
+        if (frozen_ && !link.is_linked()) {
+            return;
+        }
+
+        assert(link.is_linked() && "use does not exist");
+
+        if (link.prev_) {
+            link.prev_->next_ = link.next_;
+        } else {
+            first_ = link.next_;
+        }
+
+        if (link.next_) {
+            link.next_->prev_ = link.prev_;
+        } else {
+            last_ = link.prev_;
+        }
+
+        link.use_ = nullptr;
+        link.prev_ = nullptr;
+        link.next_ = nullptr;
+        --size_;
+    }
+
+    /// Forgets all links without unlinking them. Links may be already
+    /// destroyed, so this is allowed only inside teardown scope
+    void drop() {
+        assert(entity_teardown_scope::active() && "can't drop uses outside of teardown scope");
+        first_ = nullptr;
+        last_ = nullptr;
+        size_ = 0;
+    }
+
+private:
+    entity_use_link * first_ = nullptr;     ///< First link in list
+    entity_use_link * last_ = nullptr;      ///< Last link in list
+    std::size_t size_: 63 = 0;              ///< Number of uses in list
+    std::size_t frozen_: 1 = false;         ///< List is frozen
+};
+
+
+}
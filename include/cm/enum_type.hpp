@@ -16,8 +16,11 @@ namespace cm {
 
 
 /// Represents enum type in code model
-class enum_type: public named_type {
+class enum_type final: public named_type {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::enum_type; }
+
     /// Enum item
     struct item {
         std::string name;
@@ -27,6 +27,9 @@ class function;
 /// Represents function parameter
 class function_parameter: virtual public single_type_use, virtual public entity {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::function_parameter; }
+
     /// Constructs function parameter with specified pointer to function and type
     function_parameter(function * f, const qual_type & t);
 
@@ -54,19 +57,18 @@ private:
 /// Represents function parameter with name
 class named_function_parameter: public function_parameter, virtual public named_entity {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::named_function_parameter; }
+
     /// Constructs named function parameter with specified pointer to function,
     /// and parameter name and type
     named_function_parameter(function * f, const std::string & nm, const qual_type & t);
 
     /// Returns parameter name
-    const std::string & name() const override { return name_; }
+    std::string_view name() const override { return name_.str(); }
 
-    /// Sets parameter name
-    template <typename String>
-    requires (std::assignable_from<std::string &, String>)
-    void set_name(String && str) {
-        name_ = std::forward<String>(str);
-    }
+    /// Sets parameter name. Name is interned in name table of function
+    void set_name(std::string_view str);
 
     /// Prints function parameter desc to output stream
     void print_desc(std::ostream & str) const override {
@@ -80,7 +82,7 @@ public:
     }
 
 private:
-    std::string name_;          ///< Parameter name
+    symbol name_;               ///< Parameter name
 };
 
 
@@ -91,18 +93,18 @@ public:
     /// and optional return type
     function(context * ctx):
     context{ctx} {
-        assert(!dynamic_cast<function_type*>(ret_type_.type()) &&
+        assert(!entity_cast<function_type>(ret_type_.type()) &&
                "function return type can't be a function type");
 
         if (ret_type_) {
-            ret_type_->add_use(this);
+            ret_type_->add_use(this, ret_type_use_link_);
         }
     }
 
     /// Destroys function. Removes use of function type
     ~function() override {
-        if (ret_type_) {
-            ret_type_->remove_use(this);
+        if (ret_type_ && !entity_teardown_scope::active()) {
+            ret_type_->remove_use(ret_type_use_link_);
         }
     }
 
@@ -113,11 +115,13 @@ public:
 
     /// Returns function return type
     qual_type ret_type() {
+        load();
         return ret_type_;
     }
 
     /// Returns function const return type
     const_qual_type ret_type() const {
+        load();
         return ret_type_;
     }
 
@@ -125,13 +129,13 @@ public:
     /// type and add use for the new type.
     void set_ret_type(const qual_type & t) {
         if (ret_type_) {
-            ret_type_->remove_use(this);
+            ret_type_->remove_use(ret_type_use_link_);
         }
 
         ret_type_ = t;
 
         if (ret_type_) {
-            ret_type_->add_use(this);
+            ret_type_->add_use(this, ret_type_use_link_);
         }
     }
 
@@ -158,12 +162,14 @@ public:
 
     /// Returns range of const function parameters
     auto params() const {
+        load();
         auto fn = [](auto && par) -> const function_parameter * { return par.get(); };
         return params_ | std::ranges::views::transform(fn);
     }
 
     /// Returns range of function parameters
     auto params() {
+        load();
         auto fn = [](auto && par) -> function_parameter * { return par.get(); };
         return params_ | std::ranges::views::transform(fn);
     }
@@ -188,6 +194,7 @@ protected:
 
 private:
     qual_type ret_type_;                        ///< Function return type
+    entity_use_link ret_type_use_link_;         ///< Link in the list of uses of return type
 
     /// List of function parameters
     std::list<std::unique_ptr<function_parameter>> params_;
@@ -197,6 +204,9 @@ private:
 /// Represents simple user defined function in code model
 class named_function: virtual public function, virtual public named_context_entity {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::named_function; }
+
     /// Constructs named function with specified pointer to parent context,
     /// function name and return type
     named_function(context * ctx, const std::string & nm):
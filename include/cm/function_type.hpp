@@ -9,9 +9,10 @@
 
 #pragma once
 
+#include "hash.hpp"
 #include "qual_type.hpp"
+#include <algorithm>
 #include <ranges>
-#include <numeric>
 #include <vector>
 
 
@@ -37,16 +38,34 @@ struct function_type_id {
 };
 
 
+/// Description of function type referring to return type and range of
+/// parameter types owned by caller. Used for searching for function types
+/// without copying parameter types to function_type_id.
+template <typename Params>
+struct function_type_key {
+    const qual_type & ret_type;
+    const Params & params;
+
+    /// Returns true if function type description is equal to this key
+    bool operator==(const function_type_id & id) const {
+        return ret_type == id.ret_type && std::ranges::equal(params, id.params);
+    }
+};
+
+
 /// Represents function type
-class function_type: public type_t {
+class function_type final: public type_t {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::function_type; }
+
     /// Type of vector of qual types
     typedef std::vector<qual_type> qual_type_vector;
 
     /// Constructor, makes function type with specified return type
     function_type(const qual_type & rt):
     ret_type_{rt} {
-        ret_type_->add_use(this);
+        ret_type_->add_use(this, ret_type_use_link_);
     }
 
     /// Constructor, makes function type with specified return type
@@ -56,16 +75,27 @@ public:
     function_type(rt) {
         params_.reserve(std::ranges::size(pars));
         for (auto && par : pars) {
-            add_param(par);
+            params_.push_back(par);
+        }
+
+        // parameters are never changed after construction, so links can be
+        // allocated at once
+        param_use_links_ = std::vector<entity_use_link>(params_.size());
+        for (std::size_t i = 0; i < params_.size(); ++i) {
+            params_[i]->add_use(this, param_use_links_[i]);
         }
     }
 
     /// Destructor, removes uses of return type and all parameter types
     ~function_type() {
-        ret_type_.type()->remove_use(this);
+        if (entity_teardown_scope::active()) {
+            return;
+        }
 
-        for (auto && par : params()) {
-            par.type()->remove_use(this);
+        ret_type_.type()->remove_use(ret_type_use_link_);
+
+        for (std::size_t i = 0; i < params_.size(); ++i) {
+            params_[i].type()->remove_use(param_use_links_[i]);
         }
     }
 
@@ -109,40 +139,44 @@ public:
     }
 
 private:
-    /// Adds parameter before parameter at specified position
-    void add_param(const qual_type_vector::const_iterator & pos, const qual_type & ptype) {
-        params_.insert(pos, ptype);
-        ptype.type()->add_use(this);
-    }
-
-    /// Adds parameter at the end of parameters list
-    void add_param(const qual_type & type) {
-        add_param(params().end(), type);
-    }
-
-    /// Removes parameter at specified iterator
-    void remove_param(const qual_type_vector::const_iterator & pos) {
-        pos->type()->remove_use(this);
-        params_.erase(pos);
-    }
-
-
     qual_type ret_type_;                ///< Return type
     qual_type_vector params_;           ///< Function parameters
+
+    /// Link in the list of uses of return type
+    entity_use_link ret_type_use_link_;
+
+    /// Links in the lists of uses of parameter types, one for each parameter
+    std::vector<entity_use_link> param_use_links_;
 };
 
 
-/// Hash function for the function_type_id value
+/// Hash function for the function_type_id value. Hash depends on order of
+/// parameters, function_type_key with the same types has the same hash.
 struct function_type_id_hash {
     using argument_type = const function_type_id &;
     using result_type = size_t;
+    using is_transparent = void;
 
     result_type operator()(argument_type arg) const {
+        return hash(arg.ret_type, arg.params);
+    }
+
+    template <typename Params>
+    result_type operator()(const function_type_key<Params> & key) const {
+        return hash(key.ret_type, key.params);
+    }
+
+private:
+    /// Calculates hash of return type and range of parameter types
+    template <typename Params>
+    static result_type hash(const qual_type & ret_type, const Params & params) {
         auto type_hash = qual_type_hash<type_t>();
-        auto res = qual_type_hash<type_t>()(arg.ret_type);
-        const auto & par_hashes = arg.params | std::ranges::views::transform(type_hash);
+        auto res = type_hash(ret_type);
+        for (auto && par : params) {
+            res = hash_combine(res, type_hash(par));
+        }
 
-        return std::accumulate(std::ranges::begin(par_hashes), std::ranges::end(par_hashes), res);
+        return hash_mix(res);
     }
 };
 
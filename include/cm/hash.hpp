@@ -0,0 +1,39 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file hash.hpp
+/// Contains functions for mixing and combining hashes.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace cm {
+
+
+/// Mixes bits of value so that each bit of result depends on all bits of
+/// value (finalizer of splitmix64). Used for hashes of pointers, which have
+/// zero low bits and differ only in few middle bits.
+constexpr std::uint64_t hash_mix(std::uint64_t v) {
+    v ^= v >> 30;
+    v *= 0xbf58476d1ce4e5b9ull;
+    v ^= v >> 27;
+    v *= 0x94d049bb133111ebull;
+    v ^= v >> 31;
+    return v;
+}
+
+
+/// Combines hash of sequence with hash of the next element of sequence.
+/// Result depends on order of elements.
+constexpr std::size_t hash_combine(std::size_t seed, std::size_t h) {
+    return hash_mix(seed * 0x9e3779b97f4a7c15ull + h);
+}
+
+
+}
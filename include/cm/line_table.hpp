@@ -0,0 +1,68 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file line_table.hpp
+/// Contains definition of the line_table class.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace cm {
+
+
+/// Table of offsets of line starts in text of source file. Converts offsets
+/// in text to line and column numbers with binary search, so converting
+/// many locations in the same file doesn't scan text again. Lines are
+/// separated by '\n', "\r\n" separators end lines at '\n'.
+class line_table {
+public:
+    /// Constructs empty table
+    line_table() = default;
+
+    /// Constructs table of lines of specified text
+    explicit line_table(std::string_view text) {
+        starts_.push_back(0);
+
+        auto data = text.data();
+        auto end = data + text.size();
+        for (auto p = data; p != end; ++p) {
+            p = static_cast<const char *>(std::memchr(p, '\n', end - p));
+            if (!p) {
+                break;
+            }
+
+            starts_.push_back(static_cast<unsigned int>(p + 1 - data));
+        }
+
+        size_ = static_cast<unsigned int>(text.size());
+    }
+
+    /// Returns number of lines in table
+    unsigned int size() const { return static_cast<unsigned int>(starts_.size()); }
+
+    /// Returns one based line and column numbers of offset in text
+    std::pair<unsigned int, unsigned int> position(unsigned int offset) const {
+        assert(!starts_.empty() && offset <= size_ && "offset out of text");
+
+        auto it = std::upper_bound(starts_.begin(), starts_.end(), offset);
+        auto line = static_cast<unsigned int>(it - starts_.begin());
+        return {line, offset - *(it - 1) + 1};
+    }
+
+private:
+    std::vector<unsigned int> starts_;      ///< Offsets of line starts
+    unsigned int size_ = 0;                 ///< Size of text
+};
+
+
+}
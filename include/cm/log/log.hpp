@@ -7,6 +7,12 @@
 /// \file log.hpp
 /// Main include file for logging utilities in code model library.
 
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <boost/log/trivial.hpp>
 #include <boost/log/utility/manipulators/add_value.hpp>
 
@@ -14,17 +20,81 @@
 namespace cm::log {
 
 
-using logger_t = boost::log::sources::severity_logger_mt<boost::log::trivial::severity_level>;
+using logger_t = boost::log::sources::severity_logger<boost::log::trivial::severity_level>;
+
+/// Type of severity level of log records
+using severity_t = boost::log::trivial::severity_level;
 
-/// Returns reference to logger
+/// Returns reference to logger of current thread. Each thread has own
+/// logger, so threads don't lock logger when creating log records
 inline logger_t & get_logger() {
-    static logger_t logger;
+    thread_local logger_t logger;
     return logger;
 }
 
+
+/// Minimum severity level of log statements compiled into program. Log
+/// statements with lower severity levels are removed by compiler, their
+/// arguments are never evaluated. Set with CM_LOG_MIN_LEVEL CMake option
+#ifdef CM_LOG_MIN_LEVEL
+inline constexpr severity_t min_level = boost::log::trivial::CM_LOG_MIN_LEVEL;
+#else
+inline constexpr severity_t min_level = boost::log::trivial::trace;
+#endif
+
+
+/// Log category with cached minimum severity level of records passing log
+/// filter. Log statements check level of category before creating log
+/// records, so disabled log statements don't evaluate their arguments and
+/// don't build attributes of records
+class category {
+public:
+    /// Constructs category with specified name and minimum severity level
+    category(std::string name, severity_t level):
+        name_{std::move(name)}, level_{level} {}
+
+    /// Returns name of category
+    const std::string & name() const { return name_; }
+
+    /// Returns true if records with specified severity level may pass log filter
+    bool enabled(severity_t level) const {
+        return level >= level_.load(std::memory_order_relaxed);
+    }
+
+    /// Sets minimum severity level of records passing log filter
+    void set_level(severity_t level) { level_.store(level, std::memory_order_relaxed); }
+
+private:
+    std::string name_;                  ///< Name of category
+    std::atomic<severity_t> level_;     ///< Minimum severity level of records
+};
+
+
+/// Returns log category with specified name, creates category if it doesn't
+/// exist. Categories are never destroyed
+category & get_category(std::string_view name);
+
+/// Sets minimum severity levels of all categories from global level and
+/// levels of categories and subcategories. Levels are specified for
+/// "category" or "category/subcategory" names. Until levels are set all
+/// log statements are enabled and records are filtered by Boost.Log only
+void set_category_levels(severity_t global_level,
+                         const std::unordered_map<std::string, severity_t> & levels);
+
+
+/// Returns true if log statements of category with severity level are
+/// compiled in and enabled. Category is looked up once per statement
+#define CM_LOG_ENABLED(cat_name, level) \
+    ((level) >= ::cm::log::min_level && \
+     []() -> const ::cm::log::category & { \
+         static auto & log_cat = ::cm::log::get_category(cat_name); \
+         return log_cat; \
+     }().enabled(level))
+
 #define CM_LOG(cat, level) \
-    BOOST_LOG_SEV(::cm::log::get_logger(), level) \
-        << ::boost::log::add_value("Category", #cat)
+    if (!CM_LOG_ENABLED(#cat, level)) [[likely]] {} else \
+        BOOST_LOG_SEV(::cm::log::get_logger(), level) \
+            << ::boost::log::add_value("Category", #cat)
 
 #define CM_LOG_TRACE(cat)       CM_LOG(cat, ::boost::log::trivial::trace)
 #define CM_LOG_DEBUG(cat)       CM_LOG(cat, ::boost::log::trivial::debug)
@@ -35,9 +105,10 @@ inline logger_t & get_logger() {
 
 
 #define CM_LOG_SCAT(cat, scat, level) \
-    BOOST_LOG_SEV(::cm::log::get_logger(), level) \
-        << ::boost::log::add_value("Category", #cat) \
-        << ::boost::log::add_value("Subcategory", #scat)
+    if (!CM_LOG_ENABLED(#cat "/" #scat, level)) [[likely]] {} else \
+        BOOST_LOG_SEV(::cm::log::get_logger(), level) \
+            << ::boost::log::add_value("Category", #cat) \
+            << ::boost::log::add_value("Subcategory", #scat)
 
 #define CM_LOG_SCAT_TRACE(cat, scat)    CM_LOG_SCAT(cat, scat, ::boost::log::trivial::trace)
 #define CM_LOG_SCAT_DEBUG(cat, scat)    CM_LOG_SCAT(cat, scat, ::boost::log::trivial::debug)
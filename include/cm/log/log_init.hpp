@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
 #include <boost/program_options/variables_map.hpp>
 #include <boost/program_options/options_description.hpp>
@@ -20,8 +21,32 @@
 namespace cm::log {
 
 
-/// Initializes log sinks and formatting
-void log_init(bool log_console, const std::filesystem::path & log_file = {});
+/// Policy of asynchronous log sinks for records logged when queue is full
+enum class overflow_policy {
+    block,      ///< Logging thread waits for space in queue
+    drop,       ///< Record is dropped
+};
+
+
+/// Options of asynchronous log sinks
+struct async_options {
+    bool enabled = false;                               ///< Records are written by background thread
+    std::size_t queue_size = 65536;                     ///< Maximum number of queued records
+    overflow_policy overflow = overflow_policy::block;  ///< Policy for full queue
+};
+
+
+/// Initializes log sinks and formatting. Asynchronous sinks queue records
+/// and write them from background threads, records queued at exit are
+/// written by log_shutdown called automatically
+void log_init(bool log_console,
+              const std::filesystem::path & log_file = {},
+              const async_options & async = {});
+
+/// Writes records queued in asynchronous sinks, stops their background
+/// threads and removes them from log. Reports number of records dropped
+/// because of full queues to standard error stream
+void log_shutdown();
 
 /// Initializes log and configures log from porgram options
 void log_init(const boost::program_options::variables_map & vars,
@@ -0,0 +1,266 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file record_queue.hpp
+/// Contains definition of the record_queue class.
+
+#pragma once
+
+#include "log_init.hpp"
+#include <boost/log/core/record_view.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+
+namespace cm::log {
+
+
+/// Queueing strategy of asynchronous sinks with maximum number of queued
+/// records and overflow policy set at run time. Each logging thread pushes
+/// records to its own buffer, so logging threads don't contend for a common
+/// lock. Feeding thread of sink drains buffers of all threads into its
+/// batch and formats and writes records from batch. Records of each thread
+/// are written in order of logging, records of different threads are
+/// written in order of draining buffers. Limit of queued records is checked
+/// before pushing record, so concurrent threads may exceed it by a record each
+class record_queue {
+public:
+    /// Sets maximum number of queued records and policy for full queue
+    void set_limits(std::size_t max_size, overflow_policy policy) {
+        max_size_ = static_cast<std::ptrdiff_t>(std::max<std::size_t>(max_size, 1));
+        policy_ = policy;
+    }
+
+    /// Returns number of records dropped because of full queue
+    std::size_t dropped() const {
+        return dropped_;
+    }
+
+    /// Returns number of queued records
+    std::size_t size() const {
+        return static_cast<std::size_t>(std::max<std::ptrdiff_t>(size_, 0));
+    }
+
+    /// Closes queue for logging threads blocked by full queue. Wakes waiting
+    /// threads, records logged when queue is full are dropped from now on
+    /// regardless of overflow policy. Called before stopping sink, so
+    /// logging threads don't wait for feeding thread that is stopped
+    void close() {
+        std::lock_guard lock{wait_mutex_};
+        closed_ = true;
+        space_cond_.notify_all();
+    }
+
+protected:
+    /// Default constructor
+    record_queue() = default;
+
+    /// Constructs queue from arguments of sink
+    template <typename ArgsT>
+    explicit record_queue(const ArgsT &) {}
+
+    /// Enqueues log record, applies overflow policy if queue is full
+    void enqueue(const boost::log::record_view & rec) {
+        if (size_ >= max_size_) {
+            if (policy_ == overflow_policy::drop || closed_) {
+                ++dropped_;
+                return;
+            }
+
+            std::unique_lock lock{wait_mutex_};
+            ++waiting_;
+            space_cond_.wait(lock, [&] { return closed_ || size_ < max_size_; });
+            --waiting_;
+
+            if (size_ >= max_size_) {
+                ++dropped_;
+                return;
+            }
+        }
+
+        push(rec);
+    }
+
+    /// Attempts to enqueue log record without blocking
+    bool try_enqueue(const boost::log::record_view & rec) {
+        if (size_ >= max_size_) {
+            return false;
+        }
+
+        push(rec);
+        return true;
+    }
+
+    /// Attempts to dequeue log record ready for writing without blocking
+    bool try_dequeue_ready(boost::log::record_view & rec) {
+        return try_dequeue(rec);
+    }
+
+    /// Attempts to dequeue log record without blocking
+    bool try_dequeue(boost::log::record_view & rec) {
+        std::lock_guard lock{batch_mutex_};
+        return pop(rec);
+    }
+
+    /// Dequeues log record, waits for record if queue is empty. Returns
+    /// false if waiting is interrupted
+    bool dequeue_ready(boost::log::record_view & rec) {
+        while (true) {
+            {
+                std::lock_guard lock{batch_mutex_};
+                if (pop(rec)) {
+                    return true;
+                }
+            }
+
+            // records are counted after pushing them to buffers, so records
+            // pushed after setting flag are seen by waiting or wake reader
+            std::unique_lock lock{wait_mutex_};
+            if (interrupted_) {
+                interrupted_ = false;
+                return false;
+            }
+
+            reader_waiting_ = true;
+            cond_.wait(lock, [&] { return interrupted_ || size_ > 0; });
+            reader_waiting_ = false;
+        }
+    }
+
+    /// Wakes feeding thread waiting for records. Sink interrupts waiting for
+    /// stopping and flushing, so logging threads waiting for space are woken
+    /// by close only
+    void interrupt_dequeue() {
+        std::lock_guard lock{wait_mutex_};
+        interrupted_ = true;
+        cond_.notify_one();
+    }
+
+private:
+    /// Buffer of records of logging thread
+    struct thread_buffer {
+        std::mutex mutex;                           ///< Protects records
+        std::vector<boost::log::record_view> records;        ///< Records not drained by feeding thread
+    };
+
+    /// Returns buffer of current thread, registers buffer on first use
+    thread_buffer & local_buffer() {
+        // buffers are kept by thread for its lifetime and by queue until
+        // they are drained after thread exits
+        thread_local std::unordered_map<std::uint64_t, std::shared_ptr<thread_buffer>> buffers;
+        thread_local std::uint64_t last_id = 0;
+        thread_local thread_buffer * last = nullptr;
+        if (last_id == id_) {
+            return *last;
+        }
+
+        auto & buf = buffers[id_];
+        if (!buf) {
+            buf = std::make_shared<thread_buffer>();
+            std::lock_guard lock{buffers_mutex_};
+            buffers_.push_back(buf);
+        }
+
+        last_id = id_;
+        last = buf.get();
+        return *buf;
+    }
+
+    /// Pushes record to buffer of current thread, wakes feeding thread
+    /// waiting for records
+    void push(const boost::log::record_view & rec) {
+        auto & buf = local_buffer();
+        {
+            std::lock_guard lock{buf.mutex};
+            buf.records.push_back(rec);
+        }
+
+        ++size_;
+        if (reader_waiting_) {
+            std::lock_guard lock{wait_mutex_};
+            cond_.notify_one();
+        }
+    }
+
+    /// Moves records from buffers of threads to batch of feeding thread.
+    /// Removes empty buffers of exited threads
+    void drain() {
+        std::lock_guard lock{buffers_mutex_};
+        std::erase_if(buffers_, [&](auto && buf) {
+            std::lock_guard buf_lock{buf->mutex};
+            if (batch_.empty()) {
+                batch_.swap(buf->records);
+            } else {
+                std::move(buf->records.begin(), buf->records.end(), std::back_inserter(batch_));
+                buf->records.clear();
+            }
+
+            return buf.use_count() == 1;
+        });
+    }
+
+    /// Pops record from batch, drains buffers if batch is empty. Logging
+    /// threads waiting for space are woken when half of queue is free, so
+    /// they don't wake for each record
+    bool pop(boost::log::record_view & rec) {
+        if (batch_pos_ == batch_.size()) {
+            batch_.clear();
+            batch_pos_ = 0;
+            drain();
+            if (batch_.empty()) {
+                return false;
+            }
+        }
+
+        rec.swap(batch_[batch_pos_++]);
+        if (--size_ <= max_size_ / 2 && waiting_ != 0) {
+            std::lock_guard lock{wait_mutex_};
+            space_cond_.notify_all();
+        }
+
+        return true;
+    }
+
+    /// Source of identifiers of queues
+    static inline std::atomic<std::uint64_t> next_id_ = 1;
+
+    const std::uint64_t id_ = next_id_++;           ///< Identifier of queue for buffers of threads
+
+    std::mutex buffers_mutex_;                      ///< Protects list of buffers
+    std::vector<std::shared_ptr<thread_buffer>> buffers_;   ///< Buffers of logging threads
+
+    std::mutex batch_mutex_;                        ///< Protects batch of feeding thread
+    std::vector<boost::log::record_view> batch_;             ///< Records drained from buffers
+    std::size_t batch_pos_ = 0;                     ///< Index of the next record in batch
+
+    std::mutex wait_mutex_;                         ///< Protects waiting for records and space
+    std::condition_variable cond_;                  ///< Signaled when record is queued
+    std::condition_variable space_cond_;            ///< Signaled when record is dequeued
+    bool interrupted_ = false;                      ///< Waiting for records is interrupted
+
+    /// Number of queued records. Record is counted after pushing it to
+    /// buffer, so feeding thread may pop it before and the number is
+    /// negative for a moment
+    std::atomic<std::ptrdiff_t> size_ = 0;
+
+    std::atomic<std::ptrdiff_t> max_size_ = 65536;  ///< Maximum number of queued records
+    std::atomic<overflow_policy> policy_ = overflow_policy::block;  ///< Policy for full queue
+    std::atomic<bool> closed_ = false;              ///< Queue is closed for blocked logging threads
+    std::atomic<std::size_t> dropped_ = 0;          ///< Number of dropped records
+    std::atomic<std::size_t> waiting_ = 0;          ///< Number of threads waiting for space
+    std::atomic<bool> reader_waiting_ = false;      ///< Feeding thread waits for records
+};
+
+
+}
@@ -11,6 +11,7 @@
 
 #include "array_type.hpp"
 #include "function_type.hpp"
+#include "hash.hpp"
 #include "type.hpp"
 #include "record_type.hpp"
 
@@ -38,8 +39,7 @@ public:
     /// Calculates hash of type description
     size_t hash() const {
         auto res = std::hash<const record_type*>()(obj_type());
-        res += std::hash<const_qual_type>()(mem_type());
-        return res;
+        return hash_combine(res, std::hash<const_qual_type>()(mem_type()));
     }
 
     /// Compares this type description with other
@@ -54,20 +54,25 @@ private:
 
 
 /// Pointer to member type
-class mem_ptr_type: public type_t {
+class mem_ptr_type final: public type_t {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::mem_ptr_type; }
+
     /// Constructs pointer to member type with specified this object type
     /// and member type
     mem_ptr_type(record_type * ot, const qual_type & mt):
     obj_type_{ot}, mem_type_{mt} {
-        obj_type_->add_use(this);
-        mem_type_->add_use(this);
+        obj_type_->add_use(this, obj_use_link_);
+        mem_type_->add_use(this, mem_use_link_);
     }
 
     /// Destoys object and removes type use for object type and member type
     virtual ~mem_ptr_type() {
-        mem_type_->remove_use(this);
-        obj_type_->remove_use(this);
+        if (!entity_teardown_scope::active()) {
+            mem_type_->remove_use(mem_use_link_);
+            obj_type_->remove_use(obj_use_link_);
+        }
     }
 
     /// Returns object type
@@ -95,8 +100,10 @@ public:
     }
 
 private:
-    record_type * obj_type_;        ///< Pointer to object type
-    qual_type mem_type_;            ///< Pointer to member type
+    record_type * obj_type_;            ///< Pointer to object type
+    qual_type mem_type_;                ///< Pointer to member type
+    entity_use_link obj_use_link_;      ///< Link in the list of uses of object type
+    entity_use_link mem_use_link_;      ///< Link in the list of uses of member type
 };
 
 
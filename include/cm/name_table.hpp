@@ -0,0 +1,153 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file name_table.hpp
+/// Contains definition of the symbol and name_table classes.
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <unordered_set>
+
+
+namespace cm {
+
+
+class name_table;
+
+
+/// Handle of name interned in name table. Table stores each name once,
+/// so symbols of names from the same table are compared and hashed as
+/// pointers. Default constructed symbol refers to empty name, which is
+/// shared by all tables.
+class symbol {
+    friend class name_table;
+
+public:
+    /// Constructs symbol of empty name
+    symbol() = default;
+
+    /// Returns name of symbol
+    std::string_view str() const { return *str_; }
+
+    /// Returns name of symbol
+    operator std::string_view () const { return *str_; }
+
+    /// Returns true if name of symbol is empty
+    bool empty() const { return str_->empty(); }
+
+    /// Compares symbols. Symbols must be from the same table
+    bool operator==(const symbol & other) const = default;
+
+    /// Returns hash of symbol
+    std::size_t hash() const { return std::hash<const std::string_view*>{}(str_); }
+
+private:
+    /// Constructs symbol pointing to name stored in table
+    explicit symbol(const std::string_view * s): str_{s} {}
+
+    static constexpr std::string_view empty_str{};      ///< Empty name
+
+    const std::string_view * str_ = &empty_str;         ///< Pointer to name stored in table
+};
+
+
+/// Table of interned names. Names and nodes of table are allocated from
+/// memory resource of table. Names are never removed from table, symbols
+/// stay valid while table exists. Table is not thread safe.
+class name_table {
+public:
+    /// Constructs empty table. Names are allocated from specified memory
+    /// resource or with global operator new if resource is nullptr
+    explicit name_table(std::pmr::memory_resource * res = nullptr):
+        res_{res ? res : std::pmr::new_delete_resource()}, names_{res_} {}
+
+    /// Destroys table and deallocates names
+    ~name_table() {
+        for (auto && str : names_) {
+            res_->deallocate(const_cast<char*>(str.data()), str.size(), 1);
+        }
+    }
+
+    // non copyable / non moveable, symbols contain pointers to names in table
+    name_table(const name_table &) = delete;
+    name_table(name_table &&) = delete;
+    name_table & operator=(const name_table &) = delete;
+    name_table & operator=(name_table &&) = delete;
+
+    /// Returns symbol of specified name. Adds name to table if it doesn't exist
+    symbol intern(std::string_view str) {
+        // empty name doesn't require table
+        if (str.empty()) {
+            return {};
+        }
+
+        auto it = names_.find(str);
+        if (it == names_.end()) {
+            auto buf = static_cast<char*>(res_->allocate(str.size(), 1));
+            std::memcpy(buf, str.data(), str.size());
+            try {
+                it = names_.emplace(buf, str.size()).first;
+            } catch (...) {
+                res_->deallocate(buf, str.size(), 1);
+                throw;
+            }
+        }
+
+        return symbol{&*it};
+    }
+
+    /// Returns symbol of specified name or empty optional if name is not
+    /// in table. Name that is not in table is not a name of any entity.
+    std::optional<symbol> find(std::string_view str) const {
+        if (str.empty()) {
+            return symbol{};
+        }
+
+        auto it = names_.find(str);
+        if (it == names_.end()) {
+            return std::nullopt;
+        }
+
+        return symbol{&*it};
+    }
+
+    /// Returns number of names in table
+    std::size_t size() const { return names_.size(); }
+
+private:
+    /// Transparent hash of names allowing lookup by string view
+    struct name_hash {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view str) const {
+            return std::hash<std::string_view>{}(str);
+        }
+    };
+
+    /// Memory resource for allocating names and nodes of set of names
+    std::pmr::memory_resource * res_;
+
+    /// Set of names. Nodes of set are not moved, so pointers to names are stable
+    std::pmr::unordered_set<std::string_view, name_hash, std::equal_to<>> names_;
+};
+
+
+}
+
+
+/// Hash of symbols
+template <>
+struct std::hash<cm::symbol> {
+    std::size_t operator()(const cm::symbol & sym) const noexcept {
+        return sym.hash();
+    }
+};
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "context_entity.hpp"
+#include "name_table.hpp"
 #include "named_entity.hpp"
 
 
@@ -21,22 +22,21 @@ class named_context_entity: virtual public context_entity, virtual public named_
     friend class context;
 
 public:
-    /// Constructs named declaration with specified parent decl context and name
-    explicit named_context_entity(context * ctx, const std::string & nm):
-        context_entity{ctx}, name_{nm} {}
+    /// Constructs named declaration with specified parent decl context and
+    /// name. Name is interned in name table of context
+    explicit named_context_entity(context * ctx, const std::string & nm);
 
     /// Returns Entity name
-    const std::string & name() const override { return name_; }
+    std::string_view name() const override { return name_.str(); }
+
+    /// Returns symbol of entity name
+    symbol name_symbol() const { return name_; }
 
 private:
     /// Sets entity name
-    template <typename String>
-    requires (std::assignable_from<std::string &, String>)
-    void set_name_impl(String && str) {
-        name_ = std::forward<String>(str);
-    }
+    void set_name_impl(symbol nm) { name_ = nm; }
 
-    std::string name_;          ///< Entity name
+    symbol name_;               ///< Entity name
 };
 
 
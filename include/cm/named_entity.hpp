@@ -19,7 +19,7 @@ namespace cm {
 class named_entity: virtual public entity {
 public:
     /// Returns name of context_entity
-    virtual const std::string & name() const = 0;
+    virtual std::string_view name() const = 0;
 
     /// Prints type description to output stream
     void print_desc(std::ostream & str) const override {
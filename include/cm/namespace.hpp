@@ -29,12 +29,16 @@ namespace cm {
 /// Represents namespace
 class namespace_: public entity_context_t<>, public named_entity {
 public:
-    /// Constructs namespace with specified parent namespace and name
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::namespace_; }
+
+    /// Constructs namespace with specified parent namespace and name. Name
+    /// is interned in name table of parent namespace
     namespace_(namespace_ * parent, const std::string & nm):
     entity_context_t<>{parent},
     context{parent},
     context_entity{parent},
-    name_{nm} {
+    name_{names().intern(nm)} {
     }
 
     /// Returns default access level for this context
@@ -54,17 +58,20 @@ public:
 
     /// Searches for nested namespace with specified name. Returns pointer
     /// to namespace or nullptr if namespace was not found
-    const namespace_ * find_namespace(const std::string & name) const;
+    const namespace_ * find_namespace(std::string_view name) const;
 
     /// Searches for nested namespace with specified name. Returns pointer
     /// to namespace or nullptr if namespace was not found
-    namespace_ * find_namespace(const std::string & name) {
+    namespace_ * find_namespace(std::string_view name) {
         auto cthis = const_cast<const namespace_*>(this);
         return const_cast<namespace_*>(cthis->find_namespace(name));
     }
 
     /// Returns name of namespace
-    const std::string & name() const override { return name_; }
+    std::string_view name() const override { return name_.str(); }
+
+    /// Returns symbol of namespace name
+    symbol name_symbol() const { return name_; }
 
     /// Returns range of const nested namespaces
     const auto & namespaces() const { return c_namespaces_r_; }
@@ -74,7 +81,8 @@ public:
 
     /// Removes nested namespace
     void remove_namespace(namespace_ * ns) {
-        auto cnt = namespaces_.erase(ns->name());
+        remove_qualified_name(ns, ns->name_);
+        auto cnt = namespaces_.erase(ns->key_);
         assert(cnt && "Can't find namespace in map");
     }
 
@@ -89,11 +97,19 @@ public:
     /// Dumps namespace to output stream
     void dump(std::ostream & str, const dump_options & opts, unsigned int indent) const override;
 
+protected:
+    /// Adds qualified names of nested entities and namespaces to index
+    void add_nested_qualified_names() override;
+
+    /// Removes qualified names of nested entities and namespaces from index
+    void remove_nested_qualified_names() override;
+
 private:
-    std::string name_;          ///< Name of namespace
+    symbol name_;               ///< Name of namespace
+    symbol key_;                ///< Key of namespace in map of parent namespace
 
     /// Map of nested namespaces
-    std::unordered_map<std::string, std::shared_ptr<namespace_>> namespaces_;
+    std::unordered_map<symbol, std::shared_ptr<namespace_>> namespaces_;
 
     /// Range of pointers to namespaces
     decltype(util::make_second_ptr_range(namespaces_)) namespaces_r_ = util::make_second_ptr_range(namespaces_);
@@ -0,0 +1,165 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file pointer_map.hpp
+/// Contains definition of the pointer_map class.
+
+#pragma once
+
+#include "hash.hpp"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace cm {
+
+
+/// Map from pointers to pointers. Entries are stored in open addressing
+/// table with linear probing, so lookup usually touches one cache line of
+/// table and inserting entries doesn't allocate nodes. Null pointers can't
+/// be used as keys and values. Removing entry shifts entries of following
+/// slots back, so table has no tombstones and lookups don't slow down
+/// after removing entries.
+template <typename Key, typename Value>
+class pointer_map {
+public:
+    /// Constructs empty map
+    pointer_map() = default;
+
+    /// Returns value for specified key or nullptr if key is not in map
+    Value * find(const Key * key) const {
+        if (slots_.empty()) {
+            return nullptr;
+        }
+
+        auto mask = slots_.size() - 1;
+        for (auto i = slot_index(key, mask); slots_[i].key; i = (i + 1) & mask) {
+            if (slots_[i].key == key) {
+                return slots_[i].value;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /// Adds value for specified key. Returns false and doesn't change map if
+    /// key is already in map
+    bool insert(const Key * key, Value * value) {
+        assert(key && "null key can't be added to pointer map");
+        assert(value && "null value can't be added to pointer map");
+
+        // keeping load factor of table not greater than 3/4
+        if ((size_ + 1) * 4 > slots_.size() * 3) {
+            rehash(slots_.empty() ? min_slots : slots_.size() * 2);
+        }
+
+        auto mask = slots_.size() - 1;
+        auto i = slot_index(key, mask);
+        for (; slots_[i].key; i = (i + 1) & mask) {
+            if (slots_[i].key == key) {
+                return false;
+            }
+        }
+
+        slots_[i] = {key, value};
+        ++size_;
+        return true;
+    }
+
+    /// Removes entry with specified key. Returns false if key is not in map
+    bool erase(const Key * key) {
+        if (slots_.empty()) {
+            return false;
+        }
+
+        auto mask = slots_.size() - 1;
+        auto i = slot_index(key, mask);
+        for (; slots_[i].key != key; i = (i + 1) & mask) {
+            if (!slots_[i].key) {
+                return false;
+            }
+        }
+
+        // moving entries of probe sequence into free slot if their first
+        // slots are not between free slot and their slots
+        for (auto j = (i + 1) & mask; slots_[j].key; j = (j + 1) & mask) {
+            auto first = slot_index(slots_[j].key, mask);
+            if (((j - first) & mask) >= ((j - i) & mask)) {
+                slots_[i] = slots_[j];
+                i = j;
+            }
+        }
+
+        slots_[i] = {};
+        --size_;
+        return true;
+    }
+
+    /// Reserves space for specified number of entries, so adding them
+    /// doesn't grow table
+    void reserve(std::size_t n) {
+        auto num_slots = std::bit_ceil((n * 4 + 2) / 3);
+        if (num_slots > slots_.size()) {
+            rehash(std::max(num_slots, min_slots));
+        }
+    }
+
+    /// Returns number of entries in map
+    std::size_t size() const { return size_; }
+
+    /// Returns true if map has no entries
+    bool empty() const { return size_ == 0; }
+
+    /// Removes all entries from map
+    void clear() {
+        slots_.clear();
+        size_ = 0;
+    }
+
+private:
+    /// Minimum number of slots of non empty table
+    static constexpr std::size_t min_slots = 64;
+
+    /// Slot of table
+    struct slot {
+        const Key * key = nullptr;      ///< Key or nullptr if slot is empty
+        Value * value = nullptr;        ///< Value
+    };
+
+    /// Returns index of the first slot for key
+    static std::size_t slot_index(const Key * key, std::size_t mask) {
+        return hash_mix(reinterpret_cast<std::uintptr_t>(key)) & mask;
+    }
+
+    /// Moves entries to table with specified number of slots, which must be
+    /// a power of 2
+    void rehash(std::size_t num_slots) {
+        std::vector<slot> old(num_slots);
+        old.swap(slots_);
+
+        auto mask = slots_.size() - 1;
+        for (auto && s : old) {
+            if (s.key) {
+                auto i = slot_index(s.key, mask);
+                while (slots_[i].key) {
+                    i = (i + 1) & mask;
+                }
+
+                slots_[i] = s;
+            }
+        }
+    }
+
+    std::vector<slot> slots_;       ///< Slots of table, number of slots is power of 2
+    std::size_t size_ = 0;          ///< Number of entries in map
+};
+
+
+}
@@ -19,8 +19,11 @@ namespace cm {
 
 
 /// Represents pointer type in code model
-class pointer_type: public ptr_or_ref_type {
+class pointer_type final: public ptr_or_ref_type {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::pointer_type; }
+
     /// Constructor, makes pointer type with specified pointee type
     pointer_type(const qual_type & p):
     ptr_or_ref_type(p) {
@@ -26,12 +26,14 @@ public:
     ptr_or_ref_type(const qual_type & p):
     base_{p} {
         assert(base_ && "Invalid pointee type");
-        base_.type()->add_use(this);
+        base_.type()->add_use(this, base_use_link_);
     }
 
     /// Destructor, removes use to base type
     ~ptr_or_ref_type() {
-        base_.type()->remove_use(this);
+        if (!entity_teardown_scope::active()) {
+            base_.type()->remove_use(base_use_link_);
+        }
     }
 
     /// Returns type of pointee
@@ -53,7 +55,8 @@ public:
     virtual bool is_ref() const = 0;
 
 private:
-    qual_type base_;        ///< Type of pointee
+    qual_type base_;                    ///< Type of pointee
+    entity_use_link base_use_link_;     ///< Link in the list of uses of pointee type
 };
 
 
@@ -10,6 +10,8 @@
 #pragma once
 
 #include "type.hpp"
+#include <cassert>
+#include <cstdint>
 #include <functional>
 #include <sstream>
 #include <type_traits>
@@ -18,40 +20,54 @@
 namespace cm {
 
 
-/// Base class for all qual types
+/// Base class for all qual types. Stores pointer to type and qualifiers
+/// in one word: qualifiers are packed into low bits of pointer, which are
+/// always zero because types are aligned at least to pointer size.
 class qual_type_base {
 public:
-    /// Consturcts qualified type base class with specified const and volatile predicates
-    qual_type_base(bool is_c = false, bool is_v = false):
-        is_const_{is_c}, is_volatile_{is_v} {}
-
-    /// Default destructor
-    virtual ~qual_type_base() = default;
-
-    /// Returns pointer to const type
-    virtual const type_t * ctype() const = 0;
-
     /// Returns true if type has const qualifier
-    bool is_const() const { return is_const_; }
+    bool is_const() const { return (bits_ & const_bit) != 0; }
 
     /// Returns true if type has volatile qualifier
-    bool is_volatile() const { return is_volatile_; }
+    bool is_volatile() const { return (bits_ & volatile_bit) != 0; }
 
     /// Sets const flag for qual type
-    void set_const(bool val) { is_const_ = val; }
+    void set_const(bool val) { bits_ = val ? (bits_ | const_bit) : (bits_ & ~const_bit); }
 
     /// Sets volatile flag for qual type
-    void set_volatile(bool val) { is_volatile_ = val; }
+    void set_volatile(bool val) { bits_ = val ? (bits_ | volatile_bit) : (bits_ & ~volatile_bit); }
 
     /// Writes qualifiers to output stream
     void print_qual(std::ostream & str, bool first_space, bool last_space) const;
 
-    /// Prints type description to output stream
-    void print_desc(std::ostream & str) const;
+protected:
+    /// Constructs qualified type base class with specified pointer to type
+    /// and const and volatile predicates
+    qual_type_base(const void * t, bool is_c, bool is_v):
+        bits_{reinterpret_cast<std::uintptr_t>(t) |
+              (is_c ? const_bit : 0) |
+              (is_v ? volatile_bit : 0)} {
+        assert((reinterpret_cast<std::uintptr_t>(t) & qual_mask) == 0 && "misaligned type");
+    }
+
+    /// Returns stored pointer to type
+    void * type_ptr() const { return reinterpret_cast<void*>(bits_ & ~qual_mask); }
+
+    /// Replaces stored pointer to type keeping qualifiers
+    void set_type_ptr(const void * t) {
+        assert((reinterpret_cast<std::uintptr_t>(t) & qual_mask) == 0 && "misaligned type");
+        bits_ = reinterpret_cast<std::uintptr_t>(t) | (bits_ & qual_mask);
+    }
+
+    /// Prints type description followed by qualifiers to output stream
+    void print_desc_impl(std::ostream & str, const type_t * t) const;
 
 private:
-    bool is_const_;             ///< Has const qualifier?
-    bool is_volatile_;          ///< Has volatile qualifier?
+    static constexpr std::uintptr_t const_bit = 1;          ///< Bit of const qualifier
+    static constexpr std::uintptr_t volatile_bit = 2;       ///< Bit of volatile qualifier
+    static constexpr std::uintptr_t qual_mask = 3;          ///< Bits of qualifiers
+
+    std::uintptr_t bits_;       ///< Pointer to type and bits of qualifiers
 };
 
 
@@ -59,24 +75,25 @@ private:
 template <typename T = type_t>
 class qual_type_t: public qual_type_base {
     static_assert(std::is_base_of<type_t, T>::value, "T should be derived from type_t");
+    static_assert(alignof(T) >= 4, "low bits of pointer to type are used for qualifiers");
 
 public:
     /// Constructor, makes const qual type with specified type and qualifiers
     qual_type_t(T * t = nullptr, bool is_c = false, bool is_v = false):
-    qual_type_base{is_c, is_v}, type_{t} {
+    qual_type_base{t, is_c, is_v} {
     }
 
     /// Constructs qual type from another convertible qual type
     template <typename T2>
     qual_type_t(const qual_type_t<T2> & qt):
-    qual_type_base{qt.is_const(), qt.is_volatile()}, type_{qt.type()} {
+    qual_type_t{qt.type(), qt.is_const(), qt.is_volatile()} {
     }
 
     /// Returns type
-    auto type() const { return type_; }
+    T * type() const { return static_cast<T*>(type_ptr()); }
 
     /// Sets type in CV type
-    void set_type(T * t) { type_ = t; }
+    void set_type(T * t) { set_type_ptr(t); }
 
     /// Returns qual type with replaced pointer to type
     qual_type_t<T> replaced_type(T * t) const {
@@ -94,7 +111,7 @@ public:
     }
 
     /// Returns pointer to const type
-    const type_t * ctype() const override { return type(); }
+    const type_t * ctype() const { return type(); }
 
     /// Returns type name for named type
     std::string name() const {
@@ -102,7 +119,7 @@ public:
     }
 
     /// Returns true if qual type is null
-    bool is_null() const { return type_ == nullptr; }
+    bool is_null() const { return type_ptr() == nullptr; }
 
     /// Returns true if type is not null
     explicit operator bool() const { return !is_null(); }
@@ -114,7 +131,7 @@ public:
     /// if cast is not possible
     template <typename T2>
     auto cast() const {
-        auto casted_type = type_->template cast<std::remove_const_t<T2>>();
+        auto casted_type = type()->template cast<std::remove_const_t<T2>>();
         using ret_type = std::conditional_t<std::is_const<T>::value, const T2, T2>;
         return qual_type_t<ret_type>{casted_type, is_const(), is_volatile()};
     }
@@ -122,20 +139,8 @@ public:
     /// Returns pointer to type that the type() member function returns
     T * operator->() const { return type(); }
 
-private:
-    /// Writes CV qualifiers to output stream
-    void write_cv(std::ostream & str) const {
-        if (is_const()) {
-            str << " const";
-        }
-
-        if (is_volatile()) {
-            str << " volatile";
-        }
-    }
-
-protected:
-    T * type_;                  ///< Pointer to type
+    /// Prints type description to output stream
+    void print_desc(std::ostream & str) const { print_desc_impl(str, ctype()); }
 };
 
 
@@ -144,6 +149,9 @@ template <typename Type> using const_qual_type_t = qual_type_t<const Type>;
 using const_qual_type = qual_type_t<const type_t>;
 using qual_type = qual_type_t<>;
 
+static_assert(sizeof(qual_type) == sizeof(void*) && std::is_trivially_copyable_v<qual_type>,
+              "qual type should be a single trivially copyable word");
+
 
 /// Implementation of qualified use of type
 template <typename Type = type_t>
@@ -160,9 +168,12 @@ public:
     qual_type_use_impl & operator=(const qual_type_use_impl &) = delete;
     qual_type_use_impl & operator=(qual_type_use_impl &&) = delete;
 
-    /// Destroys use of type. Removes this instance from the list of entity uses.
+    /// Destroys use of type. Removes this instance from the list of entity
+    /// uses unless it's destroyed inside teardown scope.
     ~qual_type_use_impl() override {
-        do_remove_use();
+        if (!entity_teardown_scope::active()) {
+            do_remove_use();
+        }
     }
 
     /// Returns used type with qualifiers
@@ -183,18 +194,19 @@ private:
     /// Adds this use to the list of uses of current entity if it's not null
     void do_add_use() {
         if (type_) {
-            type_->add_use(this);
+            type_->add_use(this, use_link_);
         }
     }
 
     /// Removes this use from the list of uses of current used entity if it's not null
     void do_remove_use() {
         if (type_) {
-            type_->remove_use(this);
+            type_->remove_use(use_link_);
         }
     }
 
     qual_type_t<Type> type_;        ///< Used type
+    entity_use_link use_link_;      ///< Link in the list of uses of used type
 };
 
 
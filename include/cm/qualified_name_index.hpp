@@ -0,0 +1,130 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file qualified_name_index.hpp
+/// Contains definition of the qualified_name_index class.
+
+#pragma once
+
+#include "hash.hpp"
+#include "name_table.hpp"
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+
+namespace cm {
+
+
+class context_entity;
+
+
+/// Index of named entities of code model by fully qualified names. Qualified
+/// names are not stored in index: key of entity is a hash of key of its
+/// parent context and symbol of its name, so keys of nested entities are
+/// computed without walking parent contexts. Entities found by key are
+/// checked by comparing symbols of names of entity and its parent contexts
+/// with symbols of components of requested name.
+/// Entities with empty names (anonymous namespaces) are not added to index,
+/// they share key with parent context, so their nested entities are
+/// found by names qualified with name of parent context. Entries are stored
+/// in open addressing table with linear probing, so lookup of entity
+/// usually touches one cache line of table.
+class qualified_name_index {
+public:
+    /// Key of root context
+    static constexpr std::size_t root_key = 0x6a09e667f3bcc908ull;
+
+    /// Constructs empty index allocating entries from specified memory
+    /// resource or from default resource if resource is nullptr
+    explicit qualified_name_index(std::pmr::memory_resource * res):
+        slots_{res ? res : std::pmr::get_default_resource()} {}
+
+    // non copyable / non moveable
+    qualified_name_index(const qualified_name_index &) = delete;
+    qualified_name_index(qualified_name_index &&) = delete;
+    qualified_name_index & operator=(const qualified_name_index &) = delete;
+    qualified_name_index & operator=(qualified_name_index &&) = delete;
+
+    /// Returns key of entity with specified name in context with specified key.
+    /// Never returns 0, which is used for contexts without qualified names
+    static std::size_t child_key(std::size_t parent_key, symbol name) {
+        if (name.empty()) {
+            return parent_key;
+        }
+
+        auto h = hash_combine(parent_key, name.hash());
+        return h != 0 ? h : 1;
+    }
+
+    /// Adds entity with specified key and name
+    void insert(std::size_t key, context_entity * ent, symbol name);
+
+    /// Removes entity with specified key
+    void erase(std::size_t key, context_entity * ent);
+
+    /// Returns number of entities in index
+    std::size_t size() const { return size_; }
+
+    /// Searches for entity with specified qualified name for which predicate
+    /// returns true. Returns nullptr if entity is not found
+    template <typename Pred>
+    context_entity * find(const name_table & names, std::string_view qname, Pred && pred) const {
+        // symbols of components of typical names fit in buffer on stack
+        std::array<std::byte, 16 * sizeof(symbol)> buf;
+        std::pmr::monotonic_buffer_resource res{buf.data(), buf.size()};
+        std::pmr::vector<symbol> comps{&res};
+        if (!split_qualified_name(names, qname, comps)) {
+            return nullptr;
+        }
+
+        if (slots_.empty()) {
+            return nullptr;
+        }
+
+        auto key = qualified_key(comps);
+        auto mask = slots_.size() - 1;
+        for (auto i = key & mask; slots_[i].key != 0; i = (i + 1) & mask) {
+            auto & s = slots_[i];
+            if (s.key == key && has_qualified_name(s, comps) && pred(s.ent)) {
+                return s.ent;
+            }
+        }
+
+        return nullptr;
+    }
+
+private:
+    /// Slot of table
+    struct slot {
+        std::size_t key = 0;                ///< Key of entity or 0 if slot is empty
+        context_entity * ent = nullptr;     ///< Pointer to entity
+        symbol name;                        ///< Name of entity
+    };
+
+    /// Doubles number of slots of table
+    void grow();
+
+    /// Splits qualified name into symbols of components. Returns false if
+    /// some component of name is not in name table
+    static bool split_qualified_name(const name_table & names,
+                                     std::string_view qname,
+                                     std::pmr::vector<symbol> & comps);
+
+    /// Returns key of qualified name with specified components
+    static std::size_t qualified_key(const std::pmr::vector<symbol> & comps);
+
+    /// Returns true if entity in slot has qualified name with specified components
+    static bool has_qualified_name(const slot & s, const std::pmr::vector<symbol> & comps);
+
+    std::pmr::vector<slot> slots_;      ///< Slots of table, number of slots is power of 2
+    std::size_t size_ = 0;              ///< Number of entities in table
+};
+
+
+}
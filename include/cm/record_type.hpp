@@ -14,6 +14,7 @@
 #include "record_kind.hpp"
 #include "template_function.hpp"
 #include <ranges>
+#include <deque>
 #include <map>
 #include <vector>
 
@@ -39,8 +40,11 @@ public:
 
 
 /// Instance variable
-class field: public variable, public member {
+class field final: public variable, public member {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::field; }
+
     /// Constructor, makes isntance variable with specified name,
     /// type and access level
     inline field(record * rec,
@@ -60,8 +64,11 @@ private:
 
 
 /// Static record variable
-class static_record_variable: public variable, public member {
+class static_record_variable final: public variable, public member {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::static_record_variable; }
+
     /// Constructs static record variable with specified name, type, and access specified
     static_record_variable(record * rec,
                            const std::string & nm,
@@ -83,6 +90,9 @@ public:
 /// Named (user defined non template) method
 class named_method: public method, public named_function {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::named_method; }
+
     /// Constructs method
     explicit inline named_method(record * rec, const std::string & nm);
 
@@ -150,6 +160,7 @@ public:
 
     /// Returns range of base records
     auto bases() const {
+        load();
         return bases_ | std::ranges::views::all;
     }
 
@@ -172,26 +183,27 @@ public:
 
         // TODO: implement access levels for base types
 
-        base->add_use(this);
         bases_.push_back(base);
+        base->add_use(this, base_use_links_.emplace_back());
     }
 
     /// Removes all base records
     void remove_all_bases() {
-        for (auto && b : bases_) {
-            b->remove_use(this);
+        for (std::size_t i = 0; i < bases_.size(); ++i) {
+            bases_[i]->remove_use(base_use_links_[i]);
         }
 
         bases_.clear();
+        base_use_links_.clear();
     }
 
     /// Replaces base type
     void replace_base(type_t * src, type_t * dst) {
-        for (auto & base : bases_) {
-            if (base == src) {
-                base->remove_use(this);
-                base = dst;
-                base->add_use(this);
+        for (std::size_t i = 0; i < bases_.size(); ++i) {
+            if (bases_[i] == src) {
+                bases_[i]->remove_use(base_use_links_[i]);
+                bases_[i] = dst;
+                bases_[i]->add_use(this, base_use_links_[i]);
             }
         }
     }
@@ -265,12 +277,19 @@ private:
 
     /// Vector of base types (non necessary records, may be typedef or template instantiation)
     std::vector<type_t*> bases_;
+
+    /// Links in the lists of uses of base types, one for each base type.
+    /// Deque does not move elements when new base types are added.
+    std::deque<entity_use_link> base_use_links_;
 };
 
 
 /// Represents record type in code model
 class record_type: public record, virtual public context_type {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::record_type; }
+
     /// Constructs record type with specified parent context and record kind
     explicit record_type(context * ctx, record_kind knd):
         record{ctx, knd},
@@ -291,6 +310,9 @@ public:
 /// Named record type
 class named_record_type: virtual public named_type, public record_type {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::named_record_type; }
+
     /// Constructs record with specified context and name
     named_record_type(context * ctx, const std::string & nm, record_kind knd):
         named_type{ctx, nm},
@@ -16,8 +16,11 @@ namespace cm {
 
 
 /// Represents lvalue reference type in code model
-class rvalue_reference_type: public ptr_or_ref_type {
+class rvalue_reference_type final: public ptr_or_ref_type {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::rvalue_reference_type; }
+
     /// Constructor, makes pointer type with specified pointee type
     rvalue_reference_type(const qual_type & p):
     ptr_or_ref_type(p) {
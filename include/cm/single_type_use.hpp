@@ -23,7 +23,7 @@ public:
     explicit single_type_use(const qual_type & t):
     type_{t} {
         if (type_) {
-            type_->add_use(this);
+            type_->add_use(this, use_link_);
         }
     }
 
@@ -33,10 +33,11 @@ public:
     single_type_use & operator=(const single_type_use &) = delete;
     single_type_use & operator=(single_type_use &&) = delete;
 
-    /// Destroys type use. Removes type use if type is not null
+    /// Destroys type use. Removes type use if type is not null and type
+    /// use is not destroyed inside teardown scope
     ~single_type_use() override {
-        if (type_) {
-            type_->remove_use(this);
+        if (type_ && !entity_teardown_scope::active()) {
+            type_->remove_use(use_link_);
         }
     }
 
@@ -50,18 +51,19 @@ public:
     /// Adds use of the new type if new type is not null.
     void set_type(const qual_type & ct) {
         if (type_) {
-            type_->remove_use(this);
+            type_->remove_use(use_link_);
         }
 
         type_ = ct;
 
         if (type_) {
-            type_->add_use(this);
+            type_->add_use(this, use_link_);
         }
     }
 
 private:
     qual_type type_;            ///< The type
+    entity_use_link use_link_;  ///< Link in the list of uses of the type
 };
 
 
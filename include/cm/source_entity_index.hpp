@@ -0,0 +1,78 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file source_entity_index.hpp
+/// Contains definition of the source_entity_index class.
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <unordered_map>
+#include <unordered_set>
+
+
+namespace cm {
+
+
+class context_entity;
+class source_file;
+
+
+/// Index of entities of code model by source files owning them. Entity is
+/// owned by source file that introduced entity into code model, so all
+/// entities contributed by source file are found without visiting whole
+/// code model. Entities are removed from index when destroyed.
+class source_entity_index {
+public:
+    /// Constructs empty index
+    source_entity_index() = default;
+
+    // non copyable / non moveable
+    source_entity_index(const source_entity_index &) = delete;
+    source_entity_index(source_entity_index &&) = delete;
+    source_entity_index & operator=(const source_entity_index &) = delete;
+    source_entity_index & operator=(source_entity_index &&) = delete;
+
+    /// Adds entity owned by specified source file
+    void insert(const source_file * src, context_entity * ent) {
+        [[maybe_unused]] auto inserted = entities_[src].insert(ent).second;
+        assert(inserted && "entity is already in index");
+    }
+
+    /// Removes entity owned by specified source file
+    void erase(const source_file * src, context_entity * ent) {
+        auto it = entities_.find(src);
+        assert(it != entities_.end() && "source file not found in index");
+
+        auto cnt = it->second.erase(ent);
+        assert(cnt != 0 && "entity not found in index");
+
+        if (it->second.empty()) {
+            entities_.erase(it);
+        }
+    }
+
+    /// Returns some entity owned by specified source file or nullptr if
+    /// source file owns no entities
+    context_entity * first(const source_file * src) const {
+        auto it = entities_.find(src);
+        return it != entities_.end() ? *it->second.begin() : nullptr;
+    }
+
+    /// Returns number of entities owned by specified source file
+    std::size_t count(const source_file * src) const {
+        auto it = entities_.find(src);
+        return it != entities_.end() ? it->second.size() : 0;
+    }
+
+private:
+    /// Sets of entities by owning source files. Empty sets are removed
+    std::unordered_map<const source_file*, std::unordered_set<context_entity*>> entities_;
+};
+
+
+}
@@ -15,18 +15,45 @@
 namespace cm {
 
 
-/// Represents source file in code model
+class source_location_table;
+
+
+/// Represents source file in code model. Fork of code model has its own
+/// source file objects for source files of base code model, so locations in
+/// these source files are encoded in location table of fork. Such source
+/// files refer to source files of base code model as their origins.
 class source_file {
 public:
-    /// Constructs source file with specified path
-    explicit source_file(std::filesystem::path p):
-        path_{std::move(p)} {}
+    /// Constructs source file with specified path, table of locations and
+    /// optional source file of base code model with the same path
+    source_file(std::filesystem::path p,
+                source_location_table & locs,
+                const source_file * origin = nullptr):
+        path_{std::move(p)}, locations_{&locs},
+        origin_{origin && origin->origin_ ? origin->origin_ : origin} {}
 
     /// Returns source file path
     const std::filesystem::path & path() const { return path_; }
 
+    /// Returns table encoding locations in source file
+    source_location_table & locations() const { return *locations_; }
+
+    /// Returns source file of root base code model with the same path or
+    /// nullptr if source file is not created by fork for source file of base
+    /// code model
+    const source_file * origin() const { return origin_; }
+
+    /// Returns true if source files have the same path in code model and its
+    /// forks
+    bool same_file(const source_file * other) const {
+        auto self = origin_ ? origin_ : this;
+        return other && self == (other->origin_ ? other->origin_ : other);
+    }
+
 private:
-    std::filesystem::path path_;        ///< Source file path
+    std::filesystem::path path_;                ///< Source file path
+    source_location_table * locations_;         ///< Table of locations of code model
+    const source_file * origin_;                ///< Source file of root base code model or nullptr
 };
 
 
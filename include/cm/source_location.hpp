@@ -5,7 +5,11 @@
 //
 
 #include "source_file.hpp"
+#include "source_location_table.hpp"
+#include <cassert>
 #include <climits>
+#include <cstdint>
+#include <ostream>
 #include <string>
 
 #pragma once
@@ -14,18 +18,21 @@
 namespace cm {
 
 
-/// Represents location in source code
+/// Represents location in source code. Location is stored as 32-bit
+/// identifier in source location table of code model owning source file, so
+/// locations are compared as integers and file, line and column are decoded
+/// on demand. Locations without source file are invalid.
 class source_location {
 public:
     /// Constructs source location with specified ssource file, line number and column number
     source_location(const source_file * f = nullptr,
                     unsigned int lnum = 0,
                     unsigned int cnum = 0):
-        file_{f}, line_num_{lnum}, col_num_{cnum} {}
+        id_{f ? f->locations().encode(f, lnum, cnum) : 0} {}
 
     /// Returns true if source position is valid
     bool is_valid() const {
-        return file_ != nullptr;
+        return id_ != 0;
     }
 
     /// Returns true if source position is valid
@@ -33,42 +40,39 @@ public:
         return is_valid();
     }
 
-    /// Returns file name
-    const source_file * file() const {
-        return file_;
+    /// Returns identifier of location in source location table
+    std::uint32_t id() const {
+        return id_;
     }
 
-    /// Returns line number
-    auto line() const {
-        return line_num_;
-    }
-
-    /// Returns column number
-    auto column() const {
-        return col_num_;
+    /// Returns source file, line number and column number of location
+    decoded_source_location decode() const {
+        return source_location_table::decode(id_);
     }
 
     /// Prints source location to output stream
     void print(std::ostream & str, bool full_path = false) const {
         assert(is_valid() && "location is invalid");
 
+        auto loc = decode();
         if (full_path) {
-            str << file_->path().filename();
+            str << loc.file->path().filename();
         } else {
-            str << file_->path().string();
+            str << loc.file->path().string();
         }
 
-        str << ':' << line();
+        str << ':' << loc.line;
 
-        if (column() != UINT_MAX) {
-            str << ':' << column();
+        if (loc.column != UINT_MAX) {
+            str << ':' << loc.column;
         }
     }
 
+    /// Locations are equal if they have the same file, line and column
+    bool operator==(const source_location &) const = default;
+
 private:
-    const source_file * file_;  ///< Source file
-    unsigned int line_num_;     ///< Line number
-    unsigned int col_num_;      ///< Column number
+    std::uint32_t id_;          ///< Identifier of location in source location table
 };
 
 
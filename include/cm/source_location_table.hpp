@@ -0,0 +1,222 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file source_location_table.hpp
+/// Contains definition of the source_location_table class.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+
+namespace cm {
+
+
+class source_file;
+
+
+/// Source file, line number and column number of encoded source location
+struct decoded_source_location {
+    const source_file * file = nullptr;     ///< Source file
+    unsigned int line = 0;                  ///< Line number
+    unsigned int column = 0;                ///< Column number
+};
+
+
+/// Table encoding source locations of code model into 32-bit identifiers.
+/// Like source locations of clang, identifiers are offsets in single space
+/// divided between source files. Space is divided into slabs handed out to
+/// tables on demand, so identifiers of different tables don't overlap and
+/// are decoded without reference to table. Slabs are returned when table is
+/// destroyed. Table allocates space of slab in spans of lines of source file,
+/// each line of span has the same number of columns. Decoding identifier
+/// finds span with binary search in slab and computes line and column from
+/// offset in span. Identifier 0 is the location without file, line and
+/// column. Encoding and decoding are thread safe.
+///
+/// Space has 65535 slabs of 65536 identifiers shared by all live tables,
+/// each table with locations takes at least one slab. If all slabs are taken,
+/// locations are encoded as identifier 0 and counted by num_dropped. Columns
+/// larger than 65534 are encoded as missing columns.
+class source_location_table {
+public:
+    /// Constructs empty table
+    source_location_table() = default;
+
+    /// Destroys table and returns its slabs, identifiers of table become invalid
+    ~source_location_table();
+
+    // non copyable / non moveable
+    source_location_table(const source_location_table &) = delete;
+    source_location_table(source_location_table &&) = delete;
+    source_location_table & operator=(const source_location_table &) = delete;
+    source_location_table & operator=(source_location_table &&) = delete;
+
+    /// Returns identifier of location in source file. Returns 0 for locations
+    /// without file and if space of identifiers is exhausted. Columns too
+    /// large for spans are encoded as missing columns
+    std::uint32_t encode(const source_file * file, unsigned int line, unsigned int column);
+
+    /// Returns source file, line and column of location identifier returned
+    /// by existing table. Returns location without file for identifiers of
+    /// destroyed tables if their slabs are not taken by other tables
+    static decoded_source_location decode(std::uint32_t id);
+
+    /// Returns number of allocated spans
+    std::size_t num_spans() const { return num_spans_.load(std::memory_order_acquire); }
+
+    /// Freezes table. Frozen table encodes only locations in existing spans,
+    /// other locations are encoded as identifier 0 and counted by num_dropped
+    void freeze() { frozen_.store(true, std::memory_order_relaxed); }
+
+    /// Returns number of locations encoded as identifier 0 because space of
+    /// identifiers is exhausted or table is frozen
+    std::size_t num_dropped() const { return num_dropped_.load(std::memory_order_relaxed); }
+
+private:
+    /// Range of identifiers allocated for lines of source file
+    struct span {
+        std::uint32_t base;                 ///< Identifier of the first column of the first line
+        std::uint32_t first_line;           ///< The first line of span
+        std::uint32_t num_lines;            ///< Number of lines in span
+        std::uint32_t column_bits;          ///< Log2 of number of columns in each line
+        const source_file * file;           ///< Source file
+
+        /// Returns true if span contains location with incremented column
+        bool contains(const source_file * f, unsigned int line, std::uint32_t col) const {
+            // wide spans contain only columns that don't fit into narrower spans
+            return file == f && line - first_line < num_lines && (col >> column_bits) == 0 &&
+                   (column_bits == block_column_bits || (col >> (column_bits - 1)) != 0);
+        }
+
+        /// Returns true if span contains identifier
+        bool contains(std::uint32_t id) const {
+            return id - base < (std::uint64_t{num_lines} << column_bits);
+        }
+    };
+
+    /// Range of identifiers handed out to table
+    struct slab {
+        const source_location_table * table;    ///< Table owning slab
+        std::size_t index;                      ///< Index of slab in space of identifiers
+        std::size_t first_span;                 ///< Index of the first span of slab in table
+        std::atomic<std::size_t> num_spans = 0; ///< Number of spans in slab
+    };
+
+    /// Key of wide span in map of spans
+    struct span_key {
+        const source_file * file;           ///< Source file
+        std::uint32_t line;                 ///< Line of span
+        std::uint32_t column_bits;          ///< Log2 of number of columns of span
+
+        /// Comparison operator
+        bool operator==(const span_key &) const = default;
+    };
+
+    /// Hash of span key
+    struct span_key_hash {
+        std::size_t operator()(const span_key & key) const;
+    };
+
+    /// Log2 of number of identifiers in slab
+    static constexpr std::uint32_t slab_bits = 16;
+
+    /// Number of slabs in space of identifiers
+    static constexpr std::size_t num_slabs = std::size_t{1} << (32 - slab_bits);
+
+    /// Maximum number of lines in blocks of lines. Blocks of source file grow
+    /// from single line to maximum size as spans of file are added
+    static constexpr std::uint32_t block_lines = 16;
+
+    /// Log2 of number of columns in lines of blocks. Locations with larger
+    /// columns are encoded in wide spans of single lines
+    static constexpr std::uint32_t block_column_bits = 6;
+
+    /// Maximum log2 of number of columns of wide span, wide span of single
+    /// line with maximum columns fills the whole slab
+    static constexpr std::uint32_t max_column_bits = slab_bits;
+
+    /// Number of spans in the first chunk of spans, each next chunk is twice
+    /// as large as previous one
+    static constexpr std::size_t first_chunk_size = 16;
+
+    /// Maximum number of chunks, spans have at least 64 identifiers
+    static constexpr std::size_t max_chunks = 23;
+
+    /// Slabs of all tables by indices, slab 0 is never handed out
+    static std::array<std::atomic<const slab*>, num_slabs> slabs_;
+
+    /// Index of slab where search for free slab starts
+    static std::atomic<std::size_t> next_slab_;
+
+    /// Returns span with specified index
+    const span & span_at(std::size_t i) const {
+        auto c = static_cast<std::size_t>(std::bit_width(i / first_chunk_size + 1) - 1);
+        return chunks_[c][i - first_chunk_size * ((std::size_t{1} << c) - 1)];
+    }
+
+    /// Returns span for location with incremented column, allocates new span
+    /// if not found. Returns nullptr if space of identifiers is exhausted or
+    /// table is frozen
+    const span * find_or_add_span(const source_file * file, unsigned int line, std::uint32_t col);
+
+    /// Allocates span with specified lines and number of columns. Returns
+    /// nullptr if space of identifiers is exhausted or table is frozen
+    const span * add_span(const source_file * file, std::uint32_t first_line,
+                          std::uint32_t num_lines, std::uint32_t column_bits);
+
+    /// Protects adding spans
+    std::mutex mutex_;
+
+    /// Indices of blocks of lines of source files by first lines
+    std::unordered_map<const source_file*, std::map<std::uint32_t, std::size_t>> blocks_;
+
+    /// Indices of wide spans by keys
+    std::unordered_map<span_key, std::size_t, span_key_hash> wide_spans_;
+
+    /// Chunks of spans ordered by slabs and base identifiers in slabs. Chunks
+    /// are not reallocated, so spans are read without locking while adding spans
+    std::array<std::unique_ptr<span[]>, max_chunks> chunks_;
+
+    /// Number of spans
+    std::atomic<std::size_t> num_spans_ = 0;
+
+    /// Slabs of table, the last slab is used for allocating spans
+    std::vector<std::unique_ptr<slab>> own_slabs_;
+
+    /// Base identifier of the next span in the last slab
+    std::uint64_t next_id_ = 0;
+
+    /// Identifier following the last slab
+    std::uint64_t slab_end_ = 0;
+
+    /// Number of locations not encoded because space of identifiers is
+    /// exhausted or table is frozen
+    std::atomic<std::size_t> num_dropped_ = 0;
+
+    /// Table is frozen, new spans are not allocated
+    std::atomic<bool> frozen_ = false;
+
+    /// The last encoded span, locations are usually encoded one after another
+    /// in the same source file
+    std::atomic<const span*> last_encoded_ = nullptr;
+
+    /// The last decoded span, locations are usually decoded one after another
+    /// in the same source file
+    mutable std::atomic<const span*> last_decoded_ = nullptr;
+};
+
+
+}
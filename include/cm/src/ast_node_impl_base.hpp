@@ -10,6 +10,7 @@
 #pragma once
 
 #include "ast_node.hpp"
+#include "../source_location.hpp"
 
 
 namespace cm::src {
@@ -77,14 +78,29 @@ public:
     const Parent * parent() const override { return parent_; }
 
     /// Returns range in source code for AST node
-    source_file_range source_range() const override { return range_; }
+    source_file_range source_range() const override {
+        if (start_.id() == 0) {
+            return {};
+        }
+
+        auto start = start_.decode();
+        auto end = end_.decode();
+        return source_file_range{start.file,
+                                 src::source_range{source_position{start.line, start.column},
+                                                   source_position{end.line, end.column}}};
+    }
 
     /// Sets range in source code for AST node
-    void set_source_range(const source_file_range & r) override { range_ = r; }
+    void set_source_range(const source_file_range & r) override {
+        auto & rng = r.range();
+        start_ = cm::source_location{r.file(), rng.start().line(), rng.start().column()};
+        end_ = cm::source_location{r.file(), rng.end().line(), rng.end().column()};
+    }
 
 private:
     Parent * parent_;                   ///< Pointer to parent node
-    source_file_range range_;           ///< Node range in source code
+    cm::source_location start_;         ///< Start of node range in source code
+    cm::source_location end_;           ///< End of node range in source code
 };
 
 
@@ -12,6 +12,7 @@
 #include "../../cmsrc.hpp"
 #include "../../../cm.hpp"
 #include "../../../cxx/clang/ast_converter.hpp"
+#include "../../../cxx/clang/source_location_cache.hpp"
 #include <clang/AST/RecursiveASTVisitor.h>
 
 
@@ -90,7 +91,7 @@ class ast_converter: public ::clang::RecursiveASTVisitor<ast_converter> {
 public:
     /// Constructs AST converter with specified reference to source code model
     ast_converter(source_code_model & mdl):
-        cm_conv_{mdl.code_mdl()}, scm_{mdl} {}
+        cm_conv_{mdl.code_mdl()}, scm_{mdl}, locs_{mdl.code_mdl()} {}
 
     /// Default destructor
     ~ast_converter() = default;
@@ -272,6 +273,9 @@ private:
     cm::clang::ast_converter cm_conv_;  ///< Code model AST converter
     source_code_model & scm_;           ///< Reference to source code model
 
+    /// Source files and lines of files of converted AST
+    cm::clang::source_location_cache locs_;
+
     /// Clang AST context
     ::clang::ASTContext * clang_ast_ctx_ = nullptr;
 
@@ -23,14 +23,14 @@ public:
     explicit entity_attr_impl(CMEntity * ent = nullptr):
     ent_{ent} {
         if (ent_) {
-            ent_->add_use(static_cast<Derived*>(this));
+            ent_->add_use(static_cast<Derived*>(this), use_link_);
         }
     }
 
     /// Destroys attribute. Removes entity use
     ~entity_attr_impl() {
         if (ent_) {
-            ent_->remove_use(static_cast<Derived*>(this));
+            ent_->remove_use(use_link_);
         }
     }
 
@@ -44,13 +44,13 @@ public:
     /// and adds use of the new entity
     void set_entity(CMEntity * e) {
         if (ent_) {
-            ent_->remove_use(static_cast<Derived*>(this));
+            ent_->remove_use(use_link_);
         }
 
         ent_ = e;
 
         if (ent_) {
-            ent_->add_use(static_cast<Derived*>(this));
+            ent_->add_use(static_cast<Derived*>(this), use_link_);
         }
     }
 
@@ -66,6 +66,7 @@ public:
 
 private:
     CMEntity * ent_;            ///< Pointer to code model entity
+    entity_use_link use_link_;  ///< Link in the list of uses of code model entity
 };
 
 
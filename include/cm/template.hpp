@@ -14,10 +14,14 @@
 #include "template_name.hpp"
 #include "template_substitution.hpp"
 #include "templated_entity.hpp"
+#include <algorithm>
+#include <cassert>
+#include <initializer_list>
 #include <ranges>
 #include <list>
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 
 namespace cm {
@@ -38,7 +42,7 @@ public:
         named_context_entity{ctx, nm} {}
 
     /// Returns template name
-    const std::string & name() const override {
+    std::string_view name() const override {
         return named_context_entity::name();
     }
 
@@ -52,19 +56,7 @@ public:
         std::convertible_to<template_argument_desc> ... Args
     >
     Substitution * find_substitution(const Args & ... args) {
-        for (auto && subst : uses<template_substitution>()) {
-            if (subst->args_equal(args...)) {
-                if constexpr (std::same_as<Substitution, template_substitution>) {
-                    return subst;
-                } else {
-                    auto casted_subst = dynamic_cast<Substitution*>(subst);
-                    assert(casted_subst && "invalid substituion type for arguments");
-                    return casted_subst;
-                }
-            }
-        }
-
-        return nullptr;
+        return find_substitution<Substitution>(std::initializer_list<const_template_argument_desc>{args...});
     }
 
     /// Searches for const template substitution. If substitution found then checks
@@ -77,19 +69,7 @@ public:
         std::convertible_to<const_template_argument_desc> ... Args
     >
     const Substitution * find_substitution(const Args & ... args) const {
-        for (auto && subst : uses<template_substitution>()) {
-            if (subst->args_equal(args...)) {
-                if constexpr (std::same_as<Substitution, template_substitution>) {
-                    return subst;
-                } else {
-                    auto casted_subst = dynamic_cast<Substitution*>(subst);
-                    assert(casted_subst && "invalid substituion type for arguments");
-                    return casted_subst;
-                }
-            }
-        }
-
-        return nullptr;
+        return find_substitution<Substitution>(std::initializer_list<const_template_argument_desc>{args...});
     }
 
     /// Searches for template substitution. If substitution found then checks
@@ -102,19 +82,8 @@ public:
         const_template_argument_desc_range ArgsRange
     >
     Substitution * find_substitution(ArgsRange && args) {
-        for (auto && subst : uses<template_substitution>()) {
-            if (subst->args_equal(args)) {
-                if constexpr (std::same_as<Substitution, template_substitution>) {
-                    return subst;
-                } else {
-                    auto casted_subst = dynamic_cast<Substitution*>(subst);
-                    assert(casted_subst && "invalid substituion type for arguments");
-                    return casted_subst;
-                }
-            }
-        }
-
-        return nullptr;
+        auto cthis = const_cast<const template_*>(this);
+        return const_cast<Substitution*>(cthis->find_substitution<Substitution>(args));
     }
 
     /// Searches for const template substitution. If substitution found then checks
@@ -127,17 +96,21 @@ public:
         const_template_argument_desc_range ArgsRange
     >
     const Substitution * find_substitution(ArgsRange && args) const {
-        for (auto && subst : uses<template_substitution>()) {
+        auto [first, last] = substs_.equal_range(template_substitution::hash_args(args));
+        for (; first != last; ++first) {
+            const template_substitution * subst = first->second;
             if (subst->args_equal(args)) {
                 if constexpr (std::same_as<Substitution, template_substitution>) {
                     return subst;
                 } else {
-                    auto casted_subst = dynamic_cast<Substitution*>(subst);
+                    auto casted_subst = entity_cast<const Substitution>(subst);
                     assert(casted_subst && "invalid substituion type for arguments");
                     return casted_subst;
                 }
             }
         }
+
+        return nullptr;
     }
 
 
@@ -174,6 +147,22 @@ private:
     /// Creates template dependent instantiation from vector of arguments
     virtual template_dependent_instantiation *
     create_dependent_instantiation_impl(const template_argument_desc_vector & args) = 0;
+
+    /// Adds substitution to map of substitutions
+    void add_substitution(template_substitution * subst) override {
+        substs_.emplace(subst->args_hash(), subst);
+    }
+
+    /// Removes substitution from map of substitutions
+    void remove_substitution(template_substitution * subst) override {
+        auto [first, last] = substs_.equal_range(subst->args_hash());
+        auto it = std::find_if(first, last, [subst](auto && p) { return p.second == subst; });
+        assert(it != last && "substitution not found in template");
+        substs_.erase(it);
+    }
+
+    /// Map of substitutions of this template by hashes of their arguments
+    std::unordered_multimap<std::size_t, template_substitution*> substs_;
 };
 
 
@@ -38,14 +38,23 @@ public:
     /// Returns const pointer to template substitution
     const template_substitution * substitution() const { return subst_; }
 
+protected:
+    /// Changes argument with specified function and updates index of
+    /// substitutions of template
+    template <typename Fn>
+    void change(Fn && fn);
+
 private:
     template_substitution * subst_;     ///< Pointer to template substitution
 };
 
 
 /// Type template argument
-class type_template_argument: public template_argument, public qual_type_use_impl<> {
+class type_template_argument final: public template_argument, public qual_type_use_impl<> {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::type_template_argument; }
+
     /// Constructs type template argument
     explicit type_template_argument(template_substitution * subst, const qual_type & t):
         template_argument{subst}, qual_type_use_impl<>{t} {}
@@ -60,6 +69,11 @@ public:
         return const_template_argument_desc{type()};
     }
 
+    /// Sets type of argument. Updates index of substitutions of template
+    void set_type(const qual_type & t) {
+        change([&] { qual_type_use_impl<>::set_type(t); });
+    }
+
     /// Prints template argument description
     void print_desc(std::ostream & str) const override {
         type().print_desc(str);
@@ -68,8 +82,11 @@ public:
 
 
 /// Value template argument
-class value_template_argument: public template_argument {
+class value_template_argument final: public template_argument {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::value_template_argument; }
+
     /// Constructs value template argument
     explicit value_template_argument(template_substitution * subst, const value & val):
         template_argument{subst}, val_{val} {}
@@ -77,8 +94,10 @@ public:
     /// Returns parameter value
     const value & val() const { return val_; }
 
-    /// Sets parameter value
-    void set_value(const value & v) { val_ = v; }
+    /// Sets parameter value. Updates index of substitutions of template
+    void set_value(const value & v) {
+        change([&] { val_ = v; });
+    }
 
     /// Returns template argument description
     template_argument_desc desc() override {
@@ -20,6 +20,9 @@ namespace cm {
 /// Template function instantiation
 class template_function_instantiation: virtual public function, public template_instantiation {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::template_function_instantiation; }
+
     /// Constructs template function instantiation with specified pointer to template function
     /// and template arguments
     template <typename ... ParamsInitArgs>
@@ -50,6 +53,9 @@ public:
 /// Template function
 class template_function: virtual public named_function, virtual public template_ {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::template_function; }
+
     /// Constructs template function with pointer to parent context, function name,
     /// and tempalte parameters pack flag
     template_function(context * ctx, const std::string & nm):
@@ -63,13 +69,18 @@ public:
     /// Destroys template function
     ~template_function() override {
         // removing all function parameters and return type before destroying
-        // base template class because they can use template parameters types
+        // base template class because they can use template parameters types.
+        // Uses are not removed inside teardown scope, order doesn't matter
+        if (entity_teardown_scope::active()) {
+            return;
+        }
+
         remove_all_params();
         set_ret_type({});
     }
 
     /// Returns function name
-    const std::string & name() const override {
+    std::string_view name() const override {
         return named_function::name();
     }
 
@@ -108,7 +119,7 @@ public:
             return nullptr;
         }
 
-        auto rinst = dynamic_cast<template_function_instantiation*>(inst);
+        auto rinst = entity_cast<template_function_instantiation>(inst);
         assert(rinst != nullptr && "invalid instantiation for function remplate");
         return rinst;
     }
@@ -121,7 +132,7 @@ public:
             return nullptr;
         }
 
-        auto rinst = dynamic_cast<const template_function_instantiation*>(inst);
+        auto rinst = entity_cast<const template_function_instantiation>(inst);
         assert(rinst != nullptr && "invalid instantiation for function remplate");
         return rinst;
     }
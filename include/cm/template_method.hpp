@@ -22,6 +22,9 @@ class record;
 class template_method_instantiation: virtual public method,
                                      virtual public template_function_instantiation {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::template_method_instantiation; }
+
     /// Constructs template method instantiation
     template <typename ... ParamsInitArgs>
     requires (std::constructible_from<template_instantiation, template_ *, ParamsInitArgs...>)
@@ -52,6 +55,9 @@ public:
 class template_method: virtual public template_function,
                        virtual public named_method {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::template_method; }
+
     /// Constructs template instance function
     template_method(record * rec, const std::string & name):
         template_function{rec, name},
@@ -65,14 +71,14 @@ public:
 
     /// Returns pointer to parent record
     record * ctx() {
-        auto rec = dynamic_cast<record *>(context_entity::ctx());
+        auto rec = entity_cast<record>(context_entity::ctx());
         assert(rec && "parent context of method is not a record");
         return rec;
     }
 
     /// Returns const pointer record
     const record * ctx() const {
-        auto rec = dynamic_cast<const record *>(context_entity::ctx());
+        auto rec = entity_cast<const record>(context_entity::ctx());
         assert(rec && "parent context of method is not a record");
         return rec;
     }
@@ -95,7 +101,7 @@ public:
             return nullptr;
         }
 
-        auto rinst = dynamic_cast<template_method_instantiation*>(inst);
+        auto rinst = entity_cast<template_method_instantiation>(inst);
         assert(rinst != nullptr && "invalid instantiation for method remplate");
         return rinst;
     }
@@ -108,7 +114,7 @@ public:
             return nullptr;
         }
 
-        auto rinst = dynamic_cast<const template_method_instantiation*>(inst);
+        auto rinst = entity_cast<const template_method_instantiation>(inst);
         assert(rinst != nullptr && "invalid instantiation for method remplate");
         return rinst;
     }
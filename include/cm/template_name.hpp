@@ -13,12 +13,26 @@
 namespace cm {
 
 
+class template_substitution;
+
+
 /// Represents a template name, i.e. a reference to a template.
 /// Can be real template or dependent template name
 class template_name: virtual public context_entity {
+    friend class template_substitution;
+
 public:
     /// Returns template name as string
-    virtual const std::string & name() const = 0;
+    virtual std::string_view name() const = 0;
+
+private:
+    /// Called by substitution of this template when its arguments are set.
+    /// Templates that index substitutions by arguments add substitution to index.
+    virtual void add_substitution(template_substitution *) {}
+
+    /// Called by substitution of this template before changing its arguments
+    /// and when it is destroyed
+    virtual void remove_substitution(template_substitution *) {}
 };
 
 
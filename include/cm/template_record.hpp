@@ -41,6 +41,9 @@ class template_record_instantiation_type: public record_type,
                                           public template_record_substitution,
                                           virtual public template_instantiation {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::template_record_instantiation_type; }
+
     /// Constructs template record instantiation from pack of template arguments
     template <std::convertible_to<template_argument_desc> ... Args>
     explicit template_record_instantiation_type(context * ctx,
@@ -71,6 +74,9 @@ public:
 class template_record_specialization_type: public template_record_instantiation_type,
                                            public template_specialization {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::template_record_specialization_type; }
+
     /// Constructs template record specialization from pack of template arguments
     template <std::convertible_to<template_argument_desc> ... Args>
     explicit template_record_specialization_type(context * ctx,
@@ -96,6 +102,9 @@ public:
 class template_record_dependent_instantiation_type: public template_dependent_instantiation,
                                                     public template_record_substitution {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::template_record_dependent_instantiation_type; }
+
     /// Constructs template record dependent instantiation from pack of template arguments
     template <std::convertible_to<template_argument_desc> ... Args>
     explicit template_record_dependent_instantiation_type(context * ctx,
@@ -123,6 +132,9 @@ public:
 /// Does not have template arguments
 class template_record_type: public context_type {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::template_record_type; }
+
     /// Constructs template record type
     explicit template_record_type(context * ctx);
 
@@ -143,6 +155,9 @@ public:
 /// Template record
 class template_record: public record, public template_ {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::template_record; }
+
     /// Constructs template record with specified parent decl context, name, kind,
     /// parameter pack flag, and template parameters
     explicit template_record(context * ctx, const std::string & nm, record_kind knd):
@@ -307,6 +322,9 @@ class template_record_partial_specialization: public record,
                                               public templated_entity,
                                               public template_substitution {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::template_record_partial_specialization; }
+
     /// Constructs template record partial specialization
     explicit template_record_partial_specialization(context * ctx, template_record * templ):
         record{ctx, templ->kind()},
@@ -384,7 +402,7 @@ template_record_specialization_type::template_record_specialization_type(context
 template_record_instantiation_type{ctx, templ, std::forward<Args>(args)...},
 template_specialization{ctx, templ, std::forward<Args>(args)...},
 template_instantiation{templ, std::forward<Args>(args)...},
-template_record_substitution{ctx, templ, std::forward<Args>(args)...},
+template_substitution{templ, std::forward<Args>(args)...},
 context_type{ctx},
 context{ctx},
 context_entity{ctx} {}
@@ -438,7 +456,7 @@ template_record * context::get_or_create_template_record(const std::string & nam
     // looking for existing named entity
     if (auto ent = find_named_entity(name)) {
         // checking that entity is a template
-        auto templ = dynamic_cast<template_record*>(ent);
+        auto templ = entity_cast<template_record>(ent);
         assert(templ && "named entity is not a template record");
 
         // checking equality of template parameters of existing template
@@ -9,9 +9,11 @@
 
 #pragma once
 
+#include "hash.hpp"
 #include "template_argument.hpp"
 #include "template_name.hpp"
 #include <algorithm>
+#include <cstddef>
 
 
 namespace cm {
@@ -20,6 +22,8 @@ namespace cm {
 /// Represents template substitution: a template name with template arguments
 class template_substitution: public entity_use_impl<template_name>,
                              virtual public context_entity {
+    friend class template_argument;
+
 public:
     /// Constructs template instantiation with pack of template parameters descriptions
     template <std::convertible_to<template_argument_desc> ... Params>
@@ -37,10 +41,41 @@ public:
         }
 
         for (auto && arg : t_args) {
-            add_arg(arg);
+            push_arg(arg);
+        }
+
+        templ->add_substitution(this);
+    }
+
+    /// Removes substitution from index of template
+    ~template_substitution() {
+        // template may be already destroyed while destroying code model
+        if (!entity_teardown_scope::active()) {
+            used_entity()->remove_substitution(this);
+        }
+    }
+
+    /// Returns hash of range of template arguments descriptions. Hash depends
+    /// on order of arguments and is equal for equal ranges of arguments
+    template <const_template_argument_desc_range Args>
+    static std::size_t hash_args(Args && args_r) {
+        std::size_t res = 0;
+        for (auto && arg : args_r) {
+            res = hash_combine(res, const_template_argument_desc{arg}.hash());
         }
+
+        return res;
     }
 
+    /// Returns hash of pack of template arguments descriptions
+    template <std::convertible_to<const_template_argument_desc> ... Args>
+    static std::size_t hash_args(const Args & ... args) {
+        return hash_args(std::initializer_list<const_template_argument_desc>{args...});
+    }
+
+    /// Returns hash of arguments of this substitution
+    std::size_t args_hash() const { return args_hash_; }
+
     /// Returns pointer to a template of specified type. Checks that template type matches
     template <std::derived_from<template_name> Template = template_name>
     Template * templ() {
@@ -48,7 +83,7 @@ public:
         if constexpr (std::same_as<Template, template_name>) {
             return ent;
         } else {
-            auto casted_ent = dynamic_cast<Template*>(ent);
+            auto casted_ent = entity_cast<Template>(ent);
             assert(casted_ent && "invalid template type in substitution");
             return casted_ent;
         }
@@ -61,7 +96,7 @@ public:
         if constexpr (std::same_as<Template, template_name>) {
             return ent;
         } else {
-            auto casted_ent = dynamic_cast<const Template*>(ent);
+            auto casted_ent = entity_cast<const Template>(ent);
             assert(casted_ent && "invalid template type in substitution");
             return casted_ent;
         }
@@ -81,25 +116,29 @@ public:
 
     /// Adds template instantiation argument
     void add_arg(std::unique_ptr<template_argument> && arg) {
-        args_.push_back(std::move(arg));
+        used_entity()->remove_substitution(this);
+        push_arg(std::move(arg));
+        used_entity()->add_substitution(this);
     }
 
     /// Adds template instantiation argument from argument description
     void add_arg(const template_argument_desc & arg_desc) {
-        if (arg_desc.is_type()) {
-            add_arg(std::make_unique<type_template_argument>(this, arg_desc.type()));
-        } else {
-            add_arg(std::make_unique<value_template_argument>(this, arg_desc.value()));
-        }
+        used_entity()->remove_substitution(this);
+        push_arg(arg_desc);
+        used_entity()->add_substitution(this);
     }
 
     /// Removes template argument
     void remove_arg(template_argument * arg) {
+        used_entity()->remove_substitution(this);
+
         auto ret = std::ranges::remove_if(args_, [arg](auto && arg_uptr) {
             return arg_uptr.get() == arg;
         });
 
         args_.erase(std::ranges::begin(ret), std::ranges::end(ret));
+        rehash_args();
+        used_entity()->add_substitution(this);
     }
 
     /// Returns true if arguments of this instantiation are equal to specified range of arguments
@@ -136,9 +175,52 @@ public:
     }
 
 private:
+    /// Recomputes hash of arguments without updating index of template
+    void rehash_args() {
+        args_hash_ = 0;
+        for (auto && arg_uptr : args_) {
+            args_hash_ = hash_combine(args_hash_, arg_uptr->desc().hash());
+        }
+    }
+
+    /// Changes argument with specified function. Removes substitution from
+    /// index of template before changing and adds it with new hash of
+    /// arguments after changing
+    template <typename Fn>
+    void change_arg(Fn && fn) {
+        used_entity()->remove_substitution(this);
+        fn();
+        rehash_args();
+        used_entity()->add_substitution(this);
+    }
+
+    /// Adds template argument without updating index of template
+    void push_arg(std::unique_ptr<template_argument> && arg) {
+        args_hash_ = hash_combine(args_hash_, arg->desc().hash());
+        args_.push_back(std::move(arg));
+    }
+
+    /// Adds template argument from argument description without updating index of template
+    void push_arg(const template_argument_desc & arg_desc) {
+        if (arg_desc.is_type()) {
+            push_arg(make_entity<type_template_argument>(ctx()->entity_resource(), this, arg_desc.type()));
+        } else {
+            push_arg(make_entity<value_template_argument>(ctx()->entity_resource(), this, arg_desc.value()));
+        }
+    }
+
     /// Vector of template arguments
     std::vector<std::unique_ptr<template_argument>> args_;
+
+    /// Hash of template arguments
+    std::size_t args_hash_ = 0;
 };
 
 
+template <typename Fn>
+void template_argument::change(Fn && fn) {
+    subst_->change_arg(std::forward<Fn>(fn));
+}
+
+
 }
@@ -38,6 +38,9 @@ public:
 /// Type template parameter
 class type_template_parameter: public template_parameter, public type_t {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::type_template_parameter; }
+
     /// Constructs type template parameter with specified name
     explicit type_template_parameter(context * ctx, const std::string & nm):
         template_parameter{ctx, nm},
@@ -45,7 +48,7 @@ public:
         context_entity{ctx} {}
     
     /// Returns name of context_entity
-    const std::string & name() const override {
+    std::string_view name() const override {
         return template_parameter::name();
     }
 
@@ -60,6 +63,9 @@ public:
 /// Represents value template parameter definition
 class value_template_parameter: public template_parameter, virtual public named_entity {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::value_template_parameter; }
+
     /// Constructs value template parameter of specified type
     value_template_parameter(context * ctx, const std::string & nm, type_t * t):
         template_parameter(ctx, nm),
@@ -113,18 +119,20 @@ public:
     /// Returns template parameter with specified index
     template_parameter * template_param(size_t idx) {
         auto params = template_params();
-        assert(idx < std::ranges::distance(params) && "invalid template parameter index");
+        assert(idx < static_cast<size_t>(std::ranges::distance(params)) &&
+               "invalid template parameter index");
         auto it = std::ranges::begin(params);
-        std::ranges::advance(it, idx);
+        std::ranges::advance(it, static_cast<std::ranges::range_difference_t<decltype(params)>>(idx));
         return *it;
     }
 
     /// Returns template parameter with specified index
     const template_parameter * template_param(size_t idx) const {
         auto params = template_params();
-        assert(idx < std::ranges::distance(params) && "invalid template parameter index");
+        assert(idx < static_cast<size_t>(std::ranges::distance(params)) &&
+               "invalid template parameter index");
         auto it = std::ranges::begin(params);
-        std::ranges::advance(it, idx);
+        std::ranges::advance(it, static_cast<std::ranges::range_difference_t<decltype(params)>>(idx));
         return *it;
     }
 
@@ -202,7 +210,7 @@ private:
 
 inline templated_entity * template_parameter::templ() {
     assert(ctx() != nullptr && "context is null for template parameter");
-    auto res = dynamic_cast<templated_entity*>(ctx());
+    auto res = entity_cast<templated_entity>(ctx());
     assert(res && "parent context for template parameter is not a template");
     return res;
 }
@@ -210,7 +218,7 @@ inline templated_entity * template_parameter::templ() {
 
 inline const templated_entity * template_parameter::templ() const {
     assert(ctx() != nullptr && "context is null for template parameter");
-    auto res = dynamic_cast<const templated_entity*>(ctx());
+    auto res = entity_cast<const templated_entity>(ctx());
     assert(res && "parent context for template parameter is not a template");
     return res;
 }
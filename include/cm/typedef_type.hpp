@@ -17,17 +17,22 @@ namespace cm {
 
 
 /// Represents typedef type in code model
-class typedef_type: public named_type {
+class typedef_type final: public named_type {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::typedef_type; }
+
     /// Constructs typedef type with specified context, name and base qual type
     typedef_type(context * ctx, const std::string & nm, const qual_type & b):
         named_type(ctx, nm), context_type(ctx), context_entity(ctx), base_{b} {
-        base_.type()->add_use(this);
+        base_.type()->add_use(this, base_use_link_);
     }
 
     /// Destructor, removes use of base type
     ~typedef_type() {
-        base_.type()->remove_use(this);
+        if (!entity_teardown_scope::active()) {
+            base_.type()->remove_use(base_use_link_);
+        }
     }
 
     /// Returns base type
@@ -43,16 +48,17 @@ public:
             return;
         }
 
-        base_->remove_use(this);
+        base_->remove_use(base_use_link_);
         base_ = b;
-        base_->add_use(this);
+        base_->add_use(this, base_use_link_);
     }
 
     /// Dumps typedef type to output stream
     void dump(std::ostream & str, const dump_options & opts, unsigned int indent) const override;
 
 private:
-    qual_type base_;            ///< Base qual type
+    qual_type base_;                    ///< Base qual type
+    entity_use_link base_use_link_;     ///< Link in the list of uses of base type
 };
 
 
@@ -21,6 +21,9 @@ namespace cm {
 /// Represents variable in code model
 class variable: public named_context_entity, virtual public single_type_use {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::variable; }
+
     /// Constructs variable with specified name and type. Adds use to type
     variable(context * ctx, const std::string & nm, const qual_type & t):
     named_context_entity{ctx, nm}, context_entity{ctx}, single_type_use{t} {
@@ -21,8 +21,11 @@ using vector_type_id = array_or_vector_type_id;
 
 
 /// Represents vector (SSE/AVX) type in code model
-class vector_type: public array_or_vector_type {
+class vector_type final: public array_or_vector_type {
 public:
+    /// Returns kind of entity
+    entity_kind ent_kind() const override { return entity_kind::vector_type; }
+
     /// Constructor, makes vector type with specified element
     /// type and size
     vector_type(type_t * b, uint64_t sz):
@@ -0,0 +1,30 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file bench.cpp
+/// Contains definition of main function for code model benchmarks.
+
+#include "bench.hpp"
+
+
+/// Runs all registered benchmarks or only benchmarks which names contain
+/// one of the command line arguments
+int main(int argc, char ** argv) {
+    for (auto && b : cm::bench::benchmarks()) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i) {
+            if (b.name.find(argv[i]) != std::string::npos) {
+                selected = true;
+            }
+        }
+
+        if (selected) {
+            b.fn();
+        }
+    }
+
+    return 0;
+}
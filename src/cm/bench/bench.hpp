@@ -0,0 +1,76 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file bench.hpp
+/// Contains definition of minimal utilities for code model benchmarks.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+namespace cm::bench {
+
+
+/// Registered benchmark
+struct benchmark {
+    std::string name;                   ///< Benchmark name
+    std::function<void()> fn;           ///< Benchmark function
+};
+
+
+/// Returns reference to vector of registered benchmarks
+inline std::vector<benchmark> & benchmarks() {
+    static std::vector<benchmark> res;
+    return res;
+}
+
+
+/// Helper for static registration of benchmarks
+struct benchmark_registrar {
+    benchmark_registrar(const std::string & name, std::function<void()> fn) {
+        benchmarks().push_back({name, std::move(fn)});
+    }
+};
+
+
+/// Measures execution time of function in milliseconds
+template <typename Fn>
+double measure_ms(Fn && fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+
+/// Prints result of measurement to standard output
+inline void report(const std::string & bench, const std::string & what,
+                   double value, const std::string & unit = "ms") {
+    std::cout << std::left << std::setw(40) << bench
+              << std::setw(32) << what
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << value << " " << unit << std::endl;
+}
+
+
+}
+
+
+#define CM_BENCH_CONCAT_IMPL(a, b) a##b
+#define CM_BENCH_CONCAT(a, b) CM_BENCH_CONCAT_IMPL(a, b)
+
+/// Defines and registers benchmark function with specified name
+#define CM_BENCHMARK(name) \
+    static void cm_bench_##name(); \
+    static ::cm::bench::benchmark_registrar \
+        CM_BENCH_CONCAT(cm_bench_registrar_, name){#name, cm_bench_##name}; \
+    static void cm_bench_##name()
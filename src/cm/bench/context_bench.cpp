@@ -0,0 +1,277 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file context_bench.cpp
+/// Contains benchmarks for adding and removing entities in contexts.
+
+#include "bench.hpp"
+#include "cm/code_model.hpp"
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+
+namespace cm::bench {
+
+
+/// Number of entities in context
+static constexpr unsigned int context_num_entities = 100000;
+
+/// Number of namespaces in large code model
+static constexpr unsigned int model_num_namespaces = 100;
+
+/// Number of records in each namespace of large code model
+static constexpr unsigned int model_num_records = 1250;
+
+/// Number of small scratch code models
+static constexpr unsigned int scratch_num_models = 20000;
+
+/// Number of forks of large code model
+static constexpr unsigned int fork_num_forks = 1000;
+
+/// Number of fields in each record of code model loaded on demand
+static constexpr unsigned int lazy_num_fields = 8;
+
+/// Every n-th record of code model loaded on demand is accessed
+static constexpr unsigned int lazy_access_step = 100;
+
+
+/// Creates typedefs in namespace
+static std::vector<typedef_type*> create_context_typedefs(code_model & cm, namespace_ * ns) {
+    std::vector<typedef_type*> res;
+    res.reserve(context_num_entities);
+
+    for (unsigned int i = 0; i < context_num_entities; ++i) {
+        res.push_back(ns->create_typedef("td" + std::to_string(i), cm.bt_int()));
+    }
+
+    return res;
+}
+
+
+/// Measures removing entities from context in order of creation and in
+/// reverse order
+CM_BENCHMARK(context_remove) {
+    code_model cm;
+
+    auto ns = cm.create_namespace("ns");
+    auto tds = create_context_typedefs(cm, ns);
+    auto forward_ms = measure_ms([&] {
+        for (auto && td : tds) {
+            ns->remove_entity(td);
+        }
+    });
+    report("context_remove", "remove in order of creation", forward_ms);
+
+    auto ns2 = cm.create_namespace("ns2");
+    auto tds2 = create_context_typedefs(cm, ns2);
+    auto reverse_ms = measure_ms([&] {
+        for (auto it = tds2.rbegin(); it != tds2.rend(); ++it) {
+            ns2->remove_entity(*it);
+        }
+    });
+    report("context_remove", "remove in reverse order", reverse_ms);
+}
+
+
+/// Measures destroying code model with large record
+CM_BENCHMARK(context_teardown) {
+    auto cm = std::make_unique<code_model>();
+    auto rec = cm->create_named_record("rec");
+    for (unsigned int i = 0; i < context_num_entities; ++i) {
+        rec->create_field("f" + std::to_string(i), cm->bt_int());
+    }
+
+    auto teardown_ms = measure_ms([&] { cm.reset(); });
+    report("context_teardown", "teardown", teardown_ms);
+}
+
+
+/// Creates about 1M entities in code model. Each record has fields using
+/// builtin types and pointer to previous record, method returning reference
+/// to record and typedef
+static void create_large_model(code_model & cm) {
+    record_type * prev = cm.create_named_record("first");
+
+    for (unsigned int i = 0; i < model_num_namespaces; ++i) {
+        auto ns = cm.create_namespace("ns" + std::to_string(i));
+        for (unsigned int j = 0; j < model_num_records; ++j) {
+            auto idx = std::to_string(j);
+            auto rec = ns->create_named_record("rec" + idx);
+            rec->create_field("a", cm.bt_int());
+            rec->create_field("b", cm.bt_char());
+            rec->create_field("c", cm.bt_double());
+            rec->create_field("prev", cm.get_or_create_ptr_type(prev));
+            rec->create_method("get")->set_ret_type(cm.get_or_create_lvalue_ref_type(rec));
+            ns->create_typedef("td" + idx, rec);
+            prev = rec;
+        }
+    }
+}
+
+
+/// Measures destroying code model with about 1M entities
+CM_BENCHMARK(model_teardown) {
+    auto cm = std::make_unique<code_model>();
+    create_large_model(*cm);
+
+    auto teardown_ms = measure_ms([&] { cm.reset(); });
+    report("model_teardown", "teardown", teardown_ms);
+}
+
+
+/// Measures freezing code model with about 1M entities and creating,
+/// changing and destroying its forks
+CM_BENCHMARK(model_fork) {
+    code_model cm;
+    create_large_model(cm);
+
+    auto freeze_ms = measure_ms([&] { cm.freeze(); });
+    report("model_fork", "freeze", freeze_ms);
+
+    auto fork_ms = measure_ms([&] {
+        for (unsigned int i = 0; i < fork_num_forks; ++i) {
+            auto fork = cm.fork();
+            auto ns = fork->fork_namespace(cm.resolve<namespace_>("ns0"));
+            auto rec = ns->create_named_record("rec0");
+            rec->create_field("prev", fork->get_or_create_ptr_type(cm.resolve<named_record_type>("ns0::rec1")));
+            fork->hide(cm.resolve<named_record_type>("ns0::rec2"));
+        }
+    });
+    report("model_fork", "fork, change and destroy " + std::to_string(fork_num_forks) + " forks", fork_ms);
+}
+
+
+/// Memory resource counting allocated and not deallocated bytes
+class allocated_bytes_resource: public std::pmr::memory_resource {
+public:
+    /// Returns number of allocated and not deallocated bytes
+    std::size_t allocated() const { return allocated_; }
+
+private:
+    void * do_allocate(std::size_t bytes, std::size_t align) override {
+        allocated_ += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+
+    void do_deallocate(void * p, std::size_t bytes, std::size_t align) override {
+        allocated_ -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override {
+        return this == &other;
+    }
+
+    std::size_t allocated_ = 0;
+};
+
+
+/// Loader creating fields of records on demand
+class field_loader: public context_loader {
+public:
+    /// Creates fields in record
+    static void create_fields(code_model & cm, record * rec) {
+        for (unsigned int i = 0; i < lazy_num_fields; ++i) {
+            rec->create_field("f" + std::to_string(i), cm.get_or_create_ptr_type(cm.bt_int()));
+        }
+    }
+
+    explicit field_loader(code_model & cm): cm_{cm} { cm_.add_loader(this); }
+
+    ~field_loader() override { cm_.remove_loader(this); }
+
+    /// Creates record which fields are created on first access
+    void create_record(namespace_ * ns, const std::string & name) {
+        auto rec = ns->create_named_record(name);
+        rec->set_loader(this);
+        pending_.insert(rec);
+    }
+
+    void load(context * ctx) override {
+        pending_.erase(ctx);
+        create_fields(cm_, dynamic_cast<record*>(ctx));
+    }
+
+    void cancel(context * ctx) override { pending_.erase(ctx); }
+
+    bool load_all() override {
+        bool res = !pending_.empty();
+        while (!pending_.empty()) {
+            (*pending_.begin())->load();
+        }
+
+        return res;
+    }
+
+private:
+    code_model & cm_;                           ///< Code model
+    std::unordered_set<context*> pending_;      ///< Records which fields are not created yet
+};
+
+
+/// Measures creating code model with records which contents are created
+/// eagerly and on demand and accessing some of records
+CM_BENCHMARK(lazy_load) {
+    auto access = [](code_model & cm) {
+        for (unsigned int i = 0; i < model_num_namespaces; ++i) {
+            for (unsigned int j = 0; j < model_num_records; j += lazy_access_step) {
+                auto qname = "ns" + std::to_string(i) + "::rec" + std::to_string(j) + "::f0";
+                cm.resolve<field>(qname);
+            }
+        }
+    };
+
+    allocated_bytes_resource eager_res;
+    code_model eager_cm{&eager_res};
+    auto eager_ms = measure_ms([&] {
+        for (unsigned int i = 0; i < model_num_namespaces; ++i) {
+            auto ns = eager_cm.create_namespace("ns" + std::to_string(i));
+            for (unsigned int j = 0; j < model_num_records; ++j) {
+                field_loader::create_fields(eager_cm, ns->create_named_record("rec" + std::to_string(j)));
+            }
+        }
+    });
+    report("lazy_load", "create eagerly", eager_ms);
+    report("lazy_load", "access eagerly created", measure_ms([&] { access(eager_cm); }));
+    report("lazy_load", "memory of eager model", eager_res.allocated() / 1024.0, "KiB");
+
+    allocated_bytes_resource lazy_res;
+    code_model lazy_cm{&lazy_res};
+    field_loader loader{lazy_cm};
+    auto lazy_ms = measure_ms([&] {
+        for (unsigned int i = 0; i < model_num_namespaces; ++i) {
+            auto ns = lazy_cm.create_namespace("ns" + std::to_string(i));
+            for (unsigned int j = 0; j < model_num_records; ++j) {
+                loader.create_record(ns, "rec" + std::to_string(j));
+            }
+        }
+    });
+    report("lazy_load", "create on demand", lazy_ms);
+    report("lazy_load", "access created on demand", measure_ms([&] { access(lazy_cm); }));
+    report("lazy_load", "memory of lazy model", lazy_res.allocated() / 1024.0, "KiB");
+    report("lazy_load", "load remaining contents", measure_ms([&] { lazy_cm.load_all(); }));
+}
+
+
+/// Measures constructing and destroying small scratch code models, which
+/// are created for converting single declarations
+CM_BENCHMARK(scratch_model) {
+    auto scratch_ms = measure_ms([&] {
+        for (unsigned int i = 0; i < scratch_num_models; ++i) {
+            code_model cm;
+            auto rec = cm.create_named_record("rec");
+            rec->create_field("x", cm.bt_int());
+            rec->create_field("y", cm.get_or_create_ptr_type(cm.bt_char()));
+        }
+    });
+    report("scratch_model", "construct and destroy", scratch_ms);
+}
+
+
+}
@@ -0,0 +1,150 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file entity_kind_bench.cpp
+/// Contains benchmarks for checking classes of code model entities.
+
+#include "bench.hpp"
+#include "cm/code_model.hpp"
+#include <string>
+
+
+namespace cm::bench {
+
+
+/// Number of records in generated code model
+static constexpr unsigned int entity_kind_num_records = 20000;
+
+/// Number of passes over entities of generated code model
+static constexpr unsigned int entity_kind_num_passes = 20;
+
+
+/// Sink for results of benchmarks preventing optimizing out of casts
+static volatile std::size_t entity_kind_sink = 0;
+
+
+/// Fills namespace with records, typedefs and enums. Each record contains
+/// fields, methods and nested records
+static void fill_entity_kind_model(code_model & cm, namespace_ * ns) {
+    auto int_ptr = cm.get_or_create_ptr_type(cm.bt_int());
+
+    for (unsigned int i = 0; i < entity_kind_num_records; ++i) {
+        auto idx = std::to_string(i);
+        auto rec = ns->create_named_record("rec" + idx);
+        rec->create_field("a", cm.bt_int());
+        rec->create_field("b", int_ptr);
+        rec->create_var("c", cm.bt_int());
+        rec->create_method("get")->set_ret_type(cm.bt_int());
+        rec->create_named_record("nested");
+
+        ns->create_typedef("td" + idx, rec);
+        ns->create_enum("en" + idx, cm.bt_int());
+    }
+}
+
+
+/// Counts entities of class T in all records of namespace using specified cast
+template <typename T, typename Cast>
+static std::size_t count_record_entities(const namespace_ * ns, Cast && cast) {
+    std::size_t res = 0;
+
+    for (auto && ent : ns->entities()) {
+        if (auto rec = cast.template operator()<record_type>(ent)) {
+            for (auto && rec_ent : rec->entities()) {
+                if (cast.template operator()<T>(rec_ent)) {
+                    ++res;
+                }
+            }
+        }
+    }
+
+    return res;
+}
+
+
+/// Compares dynamic_cast with casting by entity kind when filtering entities
+/// of contexts and entity uses
+CM_BENCHMARK(entity_kind_cast) {
+    code_model cm;
+    auto ns = cm.create_namespace("ns");
+    fill_entity_kind_model(cm, ns);
+
+    auto dyn_cast = []<typename T>(const entity_use * ent) {
+        return dynamic_cast<const T*>(ent);
+    };
+
+    auto kind_cast = []<typename T>(const entity_use * ent) {
+        return entity_cast<const T>(ent);
+    };
+
+    auto measure_filter = [&](auto && cast) {
+        return measure_ms([&] {
+            for (unsigned int i = 0; i < entity_kind_num_passes; ++i) {
+                entity_kind_sink = entity_kind_sink + count_record_entities<field>(ns, cast);
+                entity_kind_sink = entity_kind_sink + count_record_entities<function>(ns, cast);
+            }
+        });
+    };
+
+    report("entity_kind_cast", "filter entities, dynamic_cast", measure_filter(dyn_cast));
+    report("entity_kind_cast", "filter entities, entity_cast", measure_filter(kind_cast));
+
+    auto measure_uses = [&](auto && cast) {
+        return measure_ms([&] {
+            for (unsigned int i = 0; i < entity_kind_num_passes; ++i) {
+                std::size_t res = 0;
+                for (auto && use : cm.bt_int()->uses()) {
+                    if (cast.template operator()<variable>(use)) {
+                        ++res;
+                    }
+                }
+
+                entity_kind_sink = entity_kind_sink + res;
+            }
+        });
+    };
+
+    report("entity_kind_cast", "filter uses, dynamic_cast", measure_uses(dyn_cast));
+    report("entity_kind_cast", "filter uses, entity_cast", measure_uses(kind_cast));
+}
+
+
+/// Compares scanning of all context entities with iterating entities of
+/// kind index when filtering entities by class
+CM_BENCHMARK(entity_kind_index) {
+    code_model cm;
+    auto ns = cm.create_namespace("ns");
+    fill_entity_kind_model(cm, ns);
+
+    auto scan_ms = measure_ms([&] {
+        for (unsigned int i = 0; i < entity_kind_num_passes; ++i) {
+            std::size_t res = 0;
+            for (auto && ent : ns->entities()) {
+                if (auto td = entity_cast<const typedef_type>(ent)) {
+                    res += td->name().size();
+                }
+            }
+
+            entity_kind_sink = entity_kind_sink + res;
+        }
+    });
+    report("entity_kind_index", "typedefs, scan all entities", scan_ms);
+
+    auto index_ms = measure_ms([&] {
+        for (unsigned int i = 0; i < entity_kind_num_passes; ++i) {
+            std::size_t res = 0;
+            for (auto && td : ns->typedefs()) {
+                res += td->name().size();
+            }
+
+            entity_kind_sink = entity_kind_sink + res;
+        }
+    });
+    report("entity_kind_index", "typedefs, kind index", index_ms);
+}
+
+
+}
@@ -0,0 +1,177 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file log_bench.cpp
+/// Contains benchmarks for disabled log statements.
+
+#include "bench.hpp"
+#include "cm/hash.hpp"
+#include "cm/pointer_map.hpp"
+#include "cm/log/log.hpp"
+#include "cm/log/log_init.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/program_options.hpp>
+
+
+namespace cm::bench {
+
+
+/// Number of declarations of synthetic translation unit
+static constexpr unsigned int log_num_decls = 2000000;
+
+/// Number of runs of each measurement
+static constexpr unsigned int log_num_runs = 5;
+
+/// Number of threads writing log records
+static constexpr unsigned int log_num_threads = 4;
+
+/// Number of log records written by each thread
+static constexpr unsigned int log_num_records = 50000;
+
+/// Number of steps of synthetic conversion of declaration between log records
+static constexpr unsigned int log_convert_steps = 200;
+
+
+/// Sink for results of benchmarks preventing optimizing out of conversion
+static volatile std::size_t log_sink = 0;
+
+
+/// Synthetic clang declaration
+struct log_decl {
+    unsigned int id;        ///< Identifier of declaration
+};
+
+
+/// Returns dump of declaration like dump of clang declaration logged by
+/// AST converter
+static std::string dump_decl_to_string(const log_decl & decl) {
+    std::ostringstream str;
+    str << "Decl " << &decl << " id " << decl.id;
+    return str.str();
+}
+
+
+/// Converts declarations of synthetic translation unit adding them to map
+/// of converted declarations like AST converter, calls specified function
+/// for each converted declaration. Returns the best time of several runs
+template <typename Log>
+static double measure_log_convert(const std::vector<log_decl> & decls, Log && log) {
+    double res = 0;
+    for (unsigned int run = 0; run < log_num_runs; ++run) {
+        pointer_map<log_decl, const log_decl> converted;
+        converted.reserve(decls.size());
+        auto ms = measure_ms([&] {
+            std::size_t found = 0;
+            for (std::size_t i = 0; i < decls.size(); ++i) {
+                log(decls[i]);
+                if (converted.find(&decls[i / 2])) {
+                    ++found;
+                }
+
+                converted.insert(&decls[i], &decls[i]);
+            }
+
+            log_sink = log_sink + found;
+        });
+
+        res = run == 0 ? ms : std::min(res, ms);
+    }
+
+    return res;
+}
+
+
+/// Compares conversion without log statements with conversion logging
+/// dumps of declarations with disabled trace level. Disabled statements are
+/// checked by cached level of category and by Boost.Log filter configured
+/// from log level option
+CM_BENCHMARK(disabled_log) {
+    // configuring log filter and category levels without sinks
+    namespace po = boost::program_options;
+    const char * argv[] = {"cm-bench", "--log-level", "info,cm-cxx-clang:info"};
+    po::variables_map vars;
+    po::store(po::parse_command_line(3, argv, log::log_options()), vars);
+    log::log_init(vars, false);
+
+    std::vector<log_decl> decls;
+    for (unsigned int i = 0; i < log_num_decls; ++i) {
+        decls.push_back({i});
+    }
+
+    auto none = [](const log_decl &) {};
+    auto gated = [](const log_decl & decl) {
+        CM_LOG_TRACE(cm-bench) << "converting decl:\n" << dump_decl_to_string(decl);
+    };
+    auto filtered = [](const log_decl & decl) {
+        BOOST_LOG_SEV(log::get_logger(), boost::log::trivial::trace)
+            << boost::log::add_value("Category", "cm-bench")
+            << "converting decl:\n" << dump_decl_to_string(decl);
+    };
+
+    report("disabled_log", "no log statements", measure_log_convert(decls, none));
+    report("disabled_log", "category level check", measure_log_convert(decls, gated));
+    report("disabled_log", "Boost.Log filter", measure_log_convert(decls, filtered));
+}
+
+
+/// Measures writing log records to file from several threads with specified
+/// options of asynchronous sinks. Reports time of logging threads and time
+/// including writing queued records
+static void measure_log_threads(const std::string & what, const log::async_options & async) {
+    auto log_file = std::filesystem::temp_directory_path() / "cm-bench-log" / "log.txt";
+    std::filesystem::remove(log_file);
+    log::log_init(false, log_file, async);
+
+    double shutdown_ms = 0;
+    auto log_ms = measure_ms([&] {
+        std::vector<std::thread> threads;
+        for (unsigned int t = 0; t < log_num_threads; ++t) {
+            threads.emplace_back([t] {
+                std::uint64_t res = t;
+                for (unsigned int i = 0; i < log_num_records; ++i) {
+                    // converting declaration
+                    for (unsigned int j = 0; j < log_convert_steps; ++j) {
+                        res = hash_mix(res + j);
+                    }
+
+                    CM_LOG_INFO(cm-bench) << "thread " << t << " converted declaration " << i;
+                }
+
+                log_sink = log_sink + res;
+            });
+        }
+
+        for (auto && thread : threads) {
+            thread.join();
+        }
+    });
+
+    shutdown_ms = measure_ms([] {
+        log::log_shutdown();
+        boost::log::core::get()->remove_all_sinks();
+    });
+
+    report("log_threads", what + ", logging", log_ms);
+    report("log_threads", what + ", total", log_ms + shutdown_ms);
+}
+
+
+/// Compares writing log records to file from several threads with
+/// synchronous sink and with asynchronous sinks blocking and dropping
+/// records when queue is full
+CM_BENCHMARK(log_threads) {
+    measure_log_threads("synchronous", {});
+    measure_log_threads("async block", {true, 4096, log::overflow_policy::block});
+    measure_log_threads("async drop", {true, 4096, log::overflow_policy::drop});
+}
+
+
+}
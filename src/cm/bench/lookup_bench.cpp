@@ -0,0 +1,329 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file lookup_bench.cpp
+/// Contains benchmarks for searching entities by name.
+
+#include "bench.hpp"
+#include "cm/code_model.hpp"
+#include "cm/line_table.hpp"
+#include "cm/pointer_map.hpp"
+#include <algorithm>
+#include <map>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+namespace cm::bench {
+
+
+/// Number of namespaces in generated code model
+static constexpr unsigned int lookup_num_namespaces = 100;
+
+/// Number of records in each namespace of generated code model
+static constexpr unsigned int lookup_num_records = 100;
+
+/// Number of fields in each record of generated code model
+static constexpr unsigned int lookup_num_fields = 10;
+
+/// Number of passes over qualified names
+static constexpr unsigned int lookup_num_passes = 20;
+
+/// Number of instantiations of template
+static constexpr unsigned int lookup_num_instantiations = 5000;
+
+/// Number of declarations in synthetic translation unit
+static constexpr unsigned int lookup_num_decls = 200000;
+
+/// Number of references to previous declarations from each declaration
+static constexpr unsigned int lookup_num_decl_refs = 4;
+
+/// Number of source files of synthetic translation unit
+static constexpr unsigned int lookup_num_files = 200;
+
+/// Number of lines in each source file of synthetic translation unit
+static constexpr unsigned int lookup_num_lines = 2000;
+
+
+/// Sink for results of benchmarks preventing optimizing out of lookups
+static volatile std::size_t lookup_sink = 0;
+
+
+/// Fills code model with namespaces, records and fields. Returns qualified
+/// names of all fields
+static std::vector<std::string> fill_lookup_model(code_model & cm) {
+    std::vector<std::string> res;
+
+    for (unsigned int i = 0; i < lookup_num_namespaces; ++i) {
+        auto ns_name = "namespace_number_" + std::to_string(i);
+        auto ns = cm.create_namespace(ns_name);
+
+        for (unsigned int j = 0; j < lookup_num_records; ++j) {
+            auto rec_name = "record_number_" + std::to_string(j);
+            auto rec = ns->create_named_record(rec_name);
+
+            for (unsigned int k = 0; k < lookup_num_fields; ++k) {
+                auto fld_name = "field_number_" + std::to_string(k);
+                rec->create_field(fld_name, cm.bt_int());
+                res.push_back(ns_name + "::" + rec_name + "::" + fld_name);
+            }
+        }
+    }
+
+    return res;
+}
+
+
+/// Resolves qualified name of field in form namespace::record::field. Passes
+/// components of name to find functions converted with specified function
+template <typename Conv>
+static const variable * resolve_field(code_model & cm, std::string_view qname, Conv && conv) {
+    auto ns_end = qname.find("::");
+    auto rec_end = qname.find("::", ns_end + 2);
+
+    auto ns = cm.find_namespace(conv(qname.substr(0, ns_end)));
+    if (!ns) {
+        return nullptr;
+    }
+
+    auto rec = ns->find_named_record(conv(qname.substr(ns_end + 2, rec_end - ns_end - 2)));
+    if (!rec) {
+        return nullptr;
+    }
+
+    return rec->find_var(conv(qname.substr(rec_end + 2)));
+}
+
+
+/// Compares resolving of qualified names passing components of names as
+/// temporary strings and as string views
+CM_BENCHMARK(qualified_name_lookup) {
+    code_model cm;
+    auto qnames = fill_lookup_model(cm);
+
+    auto measure_lookup = [&](auto && conv) {
+        return measure_ms([&] {
+            for (unsigned int i = 0; i < lookup_num_passes; ++i) {
+                std::size_t res = 0;
+                for (auto && qname : qnames) {
+                    if (resolve_field(cm, qname, conv)) {
+                        ++res;
+                    }
+                }
+
+                lookup_sink = lookup_sink + res;
+            }
+        });
+    };
+
+    auto to_string = [](std::string_view str) { return std::string{str}; };
+    auto to_view = [](std::string_view str) { return str; };
+
+    report("qualified_name_lookup", "temporary strings", measure_lookup(to_string));
+    report("qualified_name_lookup", "string views", measure_lookup(to_view));
+}
+
+
+/// Compares resolving of qualified names by walking contexts and by
+/// searching in qualified name index of code model
+CM_BENCHMARK(qualified_name_resolve) {
+    code_model cm;
+    auto qnames = fill_lookup_model(cm);
+    std::shuffle(qnames.begin(), qnames.end(), std::mt19937{});
+
+    auto measure_resolve = [&](auto && resolve) {
+        return measure_ms([&] {
+            for (unsigned int i = 0; i < lookup_num_passes; ++i) {
+                std::size_t res = 0;
+                for (auto && qname : qnames) {
+                    if (resolve(qname)) {
+                        ++res;
+                    }
+                }
+
+                lookup_sink = lookup_sink + res;
+            }
+        });
+    };
+
+    auto walk = [&](std::string_view qname) {
+        return resolve_field(cm, qname, [](std::string_view str) { return str; });
+    };
+    auto index = [&](std::string_view qname) { return cm.resolve<variable>(qname); };
+
+    report("qualified_name_resolve", "walking contexts", measure_resolve(walk));
+    report("qualified_name_resolve", "qualified name index", measure_resolve(index));
+}
+
+
+/// Compares maps from declarations to entities used by AST converter on
+/// synthetic translation unit. Declarations of different sizes are allocated
+/// one after another like in AST context, each converted declaration is added
+/// to map and references some previous declarations
+CM_BENCHMARK(decl_map) {
+    // allocating declarations of 40-160 bytes
+    struct decl { std::byte data[40]; };
+    std::pmr::monotonic_buffer_resource res;
+    std::vector<decl*> decls;
+    std::mt19937 rnd;
+    for (unsigned int i = 0; i < lookup_num_decls; ++i) {
+        auto size = sizeof(decl) * (1 + rnd() % 4);
+        decls.push_back(static_cast<decl*>(res.allocate(size, alignof(decl))));
+    }
+
+    // references mostly to recent declarations and sometimes to any previous
+    std::vector<unsigned int> refs;
+    for (unsigned int i = 1; i < lookup_num_decls; ++i) {
+        for (unsigned int j = 0; j < lookup_num_decl_refs; ++j) {
+            refs.push_back(rnd() % 2 ? i - 1 - rnd() % std::min(i, 64u) : rnd() % i);
+        }
+    }
+
+    auto measure_convert = [&](auto && map, auto && insert, auto && find) {
+        return measure_ms([&] {
+            std::size_t found = 0;
+            auto ref = refs.begin();
+            insert(map, decls[0]);
+            for (unsigned int i = 1; i < lookup_num_decls; ++i) {
+                for (unsigned int j = 0; j < lookup_num_decl_refs; ++j, ++ref) {
+                    if (find(map, decls[*ref])) {
+                        ++found;
+                    }
+                }
+
+                insert(map, decls[i]);
+            }
+
+            lookup_sink = lookup_sink + found;
+        });
+    };
+
+    auto tree_insert = [](auto && map, decl * d) { map.emplace(d, d); };
+    auto tree_find = [](auto && map, decl * d) { return map.find(d) != map.end(); };
+    std::map<const decl*, decl*> tree;
+    report("decl_map", "std::map", measure_convert(tree, tree_insert, tree_find));
+
+    auto flat_insert = [](auto && map, decl * d) { map.insert(d, d); };
+    auto flat_find = [](auto && map, decl * d) { return map.find(d) != nullptr; };
+    pointer_map<decl, decl> flat;
+    report("decl_map", "pointer_map", measure_convert(flat, flat_insert, flat_find));
+
+    pointer_map<decl, decl> reserved;
+    reserved.reserve(lookup_num_decls);
+    report("decl_map", "reserved pointer_map", measure_convert(reserved, flat_insert, flat_find));
+}
+
+
+/// Compares converting locations of declarations of synthetic translation
+/// unit by looking up source files by paths in code model for each location
+/// and by caching source files and line tables by file IDs. Declarations are
+/// grouped by source files like in translation unit
+CM_BENCHMARK(source_locations) {
+    std::mt19937 rnd;
+
+    // generating texts of source files
+    std::vector<std::string> paths;
+    std::vector<std::string> texts;
+    for (unsigned int i = 0; i < lookup_num_files; ++i) {
+        paths.push_back("/usr/include/c++/12/bits/header_number_" + std::to_string(i) + ".h");
+
+        std::string text;
+        for (unsigned int j = 0; j < lookup_num_lines; ++j) {
+            text.append(rnd() % 60, ' ');
+            text += "int declaration;\n";
+        }
+
+        texts.push_back(std::move(text));
+    }
+
+    // generating locations as file IDs and offsets
+    std::vector<std::pair<unsigned int, unsigned int>> locs;
+    for (unsigned int i = 0; i < lookup_num_decls; ++i) {
+        auto fid = i * lookup_num_files / lookup_num_decls;
+        locs.emplace_back(fid, static_cast<unsigned int>(rnd() % texts[fid].size()));
+    }
+
+    auto measure_convert = [&](auto && convert) {
+        code_model cm;
+        return measure_ms([&] {
+            std::size_t res = 0;
+            for (auto && [fid, offset] : locs) {
+                auto loc = convert(cm, fid, offset).decode();
+                res += loc.line + loc.column + (loc.file != nullptr);
+            }
+
+            lookup_sink = lookup_sink + res;
+        });
+    };
+
+    // line tables are shared by both variants like line tables of clang
+    // source manager
+    std::vector<line_table> lines;
+    for (auto && text : texts) {
+        lines.emplace_back(text);
+    }
+
+    auto by_path = [&](code_model & cm, unsigned int fid, unsigned int offset) {
+        auto [line, col] = lines[fid].position(offset);
+        return source_location{cm.source(std::string_view{paths[fid]}), line, col};
+    };
+
+    std::unordered_map<unsigned int, const source_file*> files;
+    unsigned int last_fid = UINT_MAX;
+    const source_file * last_file = nullptr;
+    auto by_fid = [&](code_model & cm, unsigned int fid, unsigned int offset) {
+        if (fid != last_fid) {
+            auto [it, inserted] = files.try_emplace(fid);
+            if (inserted) {
+                it->second = cm.source(std::string_view{paths[fid]});
+            }
+
+            last_fid = fid;
+            last_file = it->second;
+        }
+
+        auto [line, col] = lines[fid].position(offset);
+        return source_location{last_file, line, col};
+    };
+
+    report("source_locations", "source by path", measure_convert(by_path));
+    report("source_locations", "source by file ID", measure_convert(by_fid));
+}
+
+
+/// Measures searching for instantiations of template with many instantiations
+CM_BENCHMARK(template_instantiation_lookup) {
+    code_model cm;
+    auto templ = cm.create_named_entity<template_record>("vector", record_kind::class_);
+    templ->add_type_template_param("T");
+    templ->add_type_template_param("Alloc");
+
+    std::vector<record_type*> recs;
+    for (unsigned int i = 0; i < lookup_num_instantiations; ++i) {
+        auto rec = cm.create_named_record("rec" + std::to_string(i));
+        templ->create_instantiation(rec, cm.bt_int());
+        recs.push_back(rec);
+    }
+
+    auto find_ms = measure_ms([&] {
+        std::size_t res = 0;
+        for (auto && rec : recs) {
+            if (templ->find_instantiation(rec, cm.bt_int())) {
+                ++res;
+            }
+        }
+
+        lookup_sink = lookup_sink + res;
+    });
+    report("template_instantiation_lookup", "find instantiation", find_ms);
+}
+
+
+}
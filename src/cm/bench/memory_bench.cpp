@@ -0,0 +1,182 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file memory_bench.cpp
+/// Contains benchmarks for memory resources of code model entities.
+
+#include "bench.hpp"
+#include "cm/code_model.hpp"
+#include "cm/source_location.hpp"
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+
+namespace cm::bench {
+
+
+/// Number of namespaces in generated code model
+static constexpr unsigned int memory_num_namespaces = 100;
+
+/// Number of records in each namespace of generated code model
+static constexpr unsigned int memory_num_records = 1250;
+
+/// Number of source files with encoded locations
+static constexpr unsigned int memory_num_files = 1000;
+
+/// Number of lines with encoded locations in each source file
+static constexpr unsigned int memory_num_lines = 1000;
+
+
+/// Sink for results of benchmarks preventing optimizing out of decoding
+static volatile std::size_t memory_sink = 0;
+
+
+/// Memory resource counting allocations passed to upstream resource
+class counting_resource: public std::pmr::memory_resource {
+public:
+    /// Constructs counting resource with specified upstream resource
+    explicit counting_resource(std::pmr::memory_resource * upstream):
+        upstream_{upstream} {}
+
+    /// Returns number of allocations
+    std::size_t num_allocs() const { return num_allocs_; }
+
+    /// Returns maximum number of allocated bytes
+    std::size_t peak_bytes() const { return peak_bytes_; }
+
+private:
+    void * do_allocate(std::size_t bytes, std::size_t align) override {
+        ++num_allocs_;
+        bytes_ += bytes;
+        peak_bytes_ = std::max(peak_bytes_, bytes_);
+        return upstream_->allocate(bytes, align);
+    }
+
+    void do_deallocate(void * ptr, std::size_t bytes, std::size_t align) override {
+        bytes_ -= bytes;
+        upstream_->deallocate(ptr, bytes, align);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource * upstream_;      ///< Upstream memory resource
+    std::size_t num_allocs_ = 0;                ///< Number of allocations
+    std::size_t bytes_ = 0;                     ///< Number of allocated bytes
+    std::size_t peak_bytes_ = 0;                ///< Maximum number of allocated bytes
+};
+
+
+/// Fills code model with about 1M entities. Each record has fields using
+/// builtin types and pointer to previous record, method returning reference
+/// to record and typedef
+static void fill_memory_model(code_model & cm) {
+    record_type * prev = cm.create_named_record("first");
+
+    for (unsigned int i = 0; i < memory_num_namespaces; ++i) {
+        auto ns = cm.create_namespace("ns" + std::to_string(i));
+        for (unsigned int j = 0; j < memory_num_records; ++j) {
+            auto idx = std::to_string(j);
+            auto rec = ns->create_named_record("rec" + idx);
+            rec->create_field("a", cm.bt_int());
+            rec->create_field("b", cm.bt_char());
+            rec->create_field("c", cm.bt_double());
+            rec->create_field("prev", cm.get_or_create_ptr_type(prev));
+            rec->create_method("get")->set_ret_type(cm.get_or_create_lvalue_ref_type(rec));
+            ns->create_typedef("td" + idx, rec);
+            prev = rec;
+        }
+    }
+}
+
+
+/// Builds and destroys code model allocating entities from specified resource,
+/// reports time and allocations passed to counting resource
+static void measure_memory_model(const std::string & what,
+                                 std::pmr::memory_resource * res,
+                                 const counting_resource & counter) {
+    std::unique_ptr<code_model> cm;
+    auto build_ms = measure_ms([&] {
+        cm = std::make_unique<code_model>(res);
+        fill_memory_model(*cm);
+    });
+
+    auto teardown_ms = measure_ms([&] { cm.reset(); });
+
+    report("entity_memory", what + ", build", build_ms);
+    report("entity_memory", what + ", teardown", teardown_ms);
+    report("entity_memory", what + ", allocations", counter.num_allocs(), "calls");
+    report("entity_memory", what + ", peak memory", counter.peak_bytes() / 1048576.0, "MB");
+}
+
+
+/// Compares allocating entities of large code model with global operator new,
+/// from pool resource and from monotonic buffer resource
+CM_BENCHMARK(entity_memory) {
+    {
+        counting_resource counter{std::pmr::new_delete_resource()};
+        measure_memory_model("operator new", &counter, counter);
+    }
+
+    {
+        counting_resource counter{std::pmr::new_delete_resource()};
+        std::pmr::unsynchronized_pool_resource pool{&counter};
+        measure_memory_model("pool", &pool, counter);
+    }
+
+    {
+        counting_resource counter{std::pmr::new_delete_resource()};
+        std::pmr::monotonic_buffer_resource monotonic{&counter};
+        measure_memory_model("monotonic", &monotonic, counter);
+    }
+}
+
+
+/// Reports sizes of source locations and entities with locations, and
+/// measures encoding and decoding locations in source location table
+CM_BENCHMARK(source_location_size) {
+    report("source_location_size", "source_location", sizeof(source_location), "bytes");
+    report("source_location_size", "field", sizeof(field), "bytes");
+    report("source_location_size", "variable", sizeof(variable), "bytes");
+    report("source_location_size", "method", sizeof(method), "bytes");
+
+    code_model cm;
+    std::vector<const source_file*> files;
+    for (unsigned int i = 0; i < memory_num_files; ++i) {
+        files.push_back(cm.source("/usr/include/location_header_" + std::to_string(i) + ".h"));
+    }
+
+    std::vector<source_location> locs;
+    locs.reserve(memory_num_files * memory_num_lines);
+    auto encode_ms = measure_ms([&] {
+        for (auto && file : files) {
+            for (unsigned int line = 1; line <= memory_num_lines; ++line) {
+                locs.emplace_back(file, line, 1 + line % 48);
+            }
+        }
+    });
+
+    auto decode_ms = measure_ms([&] {
+        std::size_t res = 0;
+        for (auto && loc : locs) {
+            auto dloc = loc.decode();
+            res += dloc.line + dloc.column;
+        }
+
+        memory_sink = memory_sink + res;
+    });
+
+    report("source_location_size", "encode 1M locations", encode_ms);
+    report("source_location_size", "decode 1M locations", decode_ms);
+    report("source_location_size", "spans", cm.locations().num_spans(), "spans");
+}
+
+
+}
@@ -0,0 +1,110 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file type_bench.cpp
+/// Contains benchmarks for creating and searching for composite types.
+
+#include "bench.hpp"
+#include "cm/code_model.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace cm::bench {
+
+
+/// Maximum number of parameters of generated function signatures
+static constexpr unsigned int func_max_params = 4;
+
+/// Number of passes over function signatures when searching for existing types
+static constexpr unsigned int func_num_passes = 10;
+
+
+/// Function signature
+struct func_signature {
+    qual_type ret;                      ///< Return type
+    std::vector<qual_type> params;      ///< Parameter types
+};
+
+
+/// Generates signatures with all sequences of parameter types up to maximum
+/// number of parameters. Sequences differing only in order of parameters are
+/// common in overload sets, e.g. f(int, char*) and f(char*, int).
+static std::vector<func_signature> generate_signatures(const std::vector<qual_type> & types) {
+    std::vector<func_signature> res;
+    std::vector<std::vector<qual_type>> prev{{}};
+
+    for (unsigned int n = 0; n <= func_max_params; ++n) {
+        std::vector<std::vector<qual_type>> next;
+        for (auto && params : prev) {
+            res.push_back({types[res.size() % types.size()], params});
+
+            if (n != func_max_params) {
+                for (auto && t : types) {
+                    next.push_back(params);
+                    next.back().push_back(t);
+                }
+            }
+        }
+
+        prev = std::move(next);
+    }
+
+    return res;
+}
+
+
+/// Measures creating and searching for function types with realistic
+/// signatures, counts function types with colliding hashes of type descriptions
+CM_BENCHMARK(func_type_intern) {
+    code_model cm;
+
+    // builtin types, cv qualified builtin types and pointers to records
+    std::vector<qual_type> types{cm.bt_int(), cm.bt_char(), cm.bt_double(), cm.bt_bool()};
+    types.push_back(qual_type{cm.bt_int(), true});
+    types.push_back(qual_type{cm.bt_char(), true});
+    for (unsigned int i = 0; i < 6; ++i) {
+        auto rec = cm.create_named_record("rec" + std::to_string(i));
+        types.push_back(cm.get_or_create_ptr_type(rec));
+    }
+
+    auto sigs = generate_signatures(types);
+
+    auto create_ms = measure_ms([&] {
+        for (auto && sig : sigs) {
+            cm.get_or_create_func_type_r(sig.ret, sig.params);
+        }
+    });
+    report("func_type_intern", "create " + std::to_string(sigs.size()) + " types", create_ms);
+
+    auto find_ms = measure_ms([&] {
+        for (unsigned int i = 0; i < func_num_passes; ++i) {
+            for (auto && sig : sigs) {
+                cm.get_or_create_func_type_r(sig.ret, sig.params);
+            }
+        }
+    });
+    report("func_type_intern", "find existing types", find_ms);
+
+    // counting types sharing hash with other types
+    std::unordered_map<std::size_t, unsigned int> hashes;
+    for (auto && ftype : cm.func_types()) {
+        ++hashes[function_type_id_hash{}(ftype->type_id())];
+    }
+
+    unsigned int num_colliding = 0;
+    for (auto && [hash, cnt] : hashes) {
+        if (cnt > 1) {
+            num_colliding += cnt;
+        }
+    }
+
+    report("func_type_intern", "types with colliding hashes", num_colliding, "types");
+}
+
+
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file use_list_bench.cpp
+/// Contains benchmarks for tracking uses of code model entities.
+
+#include "bench.hpp"
+#include "cm/code_model.hpp"
+#include <memory>
+#include <string>
+
+
+namespace cm::bench {
+
+
+/// Number of namespaces in generated code model
+static constexpr unsigned int use_list_num_namespaces = 1000;
+
+/// Number of records in each namespace
+static constexpr unsigned int use_list_num_records = 100;
+
+
+/// Fills code model with records which fields and methods use small set
+/// of builtin and composite types
+static void fill_use_list_model(code_model & cm) {
+    auto int_ptr = cm.get_or_create_ptr_type(cm.bt_int());
+    auto char_ptr = cm.get_or_create_ptr_type(qual_type{cm.bt_char(), true});
+
+    for (unsigned int i = 0; i < use_list_num_namespaces; ++i) {
+        auto ns = cm.create_namespace("ns" + std::to_string(i));
+
+        for (unsigned int j = 0; j < use_list_num_records; ++j) {
+            auto rec = ns->create_named_record("rec" + std::to_string(j));
+            rec->create_field("a", cm.bt_int());
+            rec->create_field("b", cm.bt_char());
+            rec->create_field("c", int_ptr);
+            rec->create_field("d", char_ptr);
+            rec->create_field("e", cm.bt_int());
+
+            auto meth = rec->create_method("get");
+            meth->set_ret_type(cm.bt_int());
+            meth->add_param("x", cm.bt_int());
+            meth->add_param("y", cm.bt_char());
+        }
+    }
+}
+
+
+/// Measures building and tearing down large code model where few types
+/// collect most of the uses
+CM_BENCHMARK(use_list_build_and_teardown) {
+    auto cm = std::make_unique<code_model>();
+
+    auto build_ms = measure_ms([&] { fill_use_list_model(*cm); });
+    report("use_list_build_and_teardown", "build", build_ms);
+
+    auto teardown_ms = measure_ms([&] { cm.reset(); });
+    report("use_list_build_and_teardown", "teardown", teardown_ms);
+}
+
+
+/// Measures adding and removing uses of single type in non LIFO order
+CM_BENCHMARK(use_list_churn) {
+    static constexpr unsigned int num_uses = 200000;
+
+    static constexpr unsigned int num_fields_per_rec = 100;
+
+    code_model cm;
+    auto ns = cm.create_namespace("ns");
+
+    std::vector<field*> fields;
+    fields.reserve(num_uses);
+
+    auto add_ms = measure_ms([&] {
+        record * rec = nullptr;
+        for (unsigned int i = 0; i < num_uses; ++i) {
+            if (i % num_fields_per_rec == 0) {
+                rec = ns->create_named_record("rec" + std::to_string(i));
+            }
+
+            fields.push_back(rec->create_field("f" + std::to_string(i), cm.bt_int()));
+        }
+    });
+    report("use_list_churn", "add uses", add_ms);
+
+    // retargeting every second field removes use from the middle of the
+    // list of int uses and adds use to list of char uses
+    auto retarget_ms = measure_ms([&] {
+        for (unsigned int i = 0; i < num_uses; i += 2) {
+            fields[i]->set_type(cm.bt_char());
+        }
+
+        for (unsigned int i = 0; i < num_uses; i += 2) {
+            fields[i]->set_type(cm.bt_int());
+        }
+    });
+    report("use_list_churn", "retarget uses", retarget_ms);
+}
+
+
+}
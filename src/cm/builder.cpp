@@ -36,7 +36,7 @@ void record_builder_base::tdef_impl(const std::string & name,
     if (is_new_) {
         td = rec_->create_typedef(name, type);
     } else {
-        td = dynamic_cast<type_t*>(rec_->find_named_entity(name));
+        td = entity_cast<type_t>(rec_->find_named_entity(name));
         assert(td && "can't find typedef in existing record");
     }
 
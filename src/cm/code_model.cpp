@@ -9,155 +9,233 @@
 
 #include "pch.hpp"
 #include "cm/code_model.hpp"
+#include <array>
+#include <iterator>
 #include <ranges>
 #include <sstream>
+#include <utility>
 
 
 namespace cm {
 
 
-code_model::code_model():
-namespace_{nullptr, ""}, context{nullptr}, context_entity{nullptr},
-opaque_type_{this, record_kind::struct_} {
-
-    // adding builtin types
-    builtin_types_.push_back({builtin_type::kind_t::void_, "void"});
-    builtin_types_.push_back({builtin_type::kind_t::bool_, "bool"});
-    builtin_types_.push_back({builtin_type::kind_t::char_, "char"});
-    builtin_types_.push_back({builtin_type::kind_t::short_, "short"});
-    builtin_types_.push_back({builtin_type::kind_t::int_, "int"});
-    builtin_types_.push_back({builtin_type::kind_t::long_, "long"});
-    builtin_types_.push_back({builtin_type::kind_t::long_long_, "long long"});
-    builtin_types_.push_back({builtin_type::kind_t::int128_, "int128"});
-    builtin_types_.push_back({builtin_type::kind_t::signed_char_, "signed char"});
-    builtin_types_.push_back({builtin_type::kind_t::unsigned_char_, "unsigned char"});
-    builtin_types_.push_back({builtin_type::kind_t::unsigned_short_, "unsigned short"});
-    builtin_types_.push_back({builtin_type::kind_t::unsigned_int_, "unsigned int"});
-    builtin_types_.push_back({builtin_type::kind_t::unsigned_long_, "unsigned long"});
-    builtin_types_.push_back({builtin_type::kind_t::unsigned_long_long_, "unsigned long long"});
-    builtin_types_.push_back({builtin_type::kind_t::uint128_, "uint128"});
-    builtin_types_.push_back({builtin_type::kind_t::float_, "float"});
-    builtin_types_.push_back({builtin_type::kind_t::double_, "double"});
-    builtin_types_.push_back({builtin_type::kind_t::long_double_, "long double"});
-
-    builtin_types_.push_back({builtin_type::kind_t::wchar_t_, "wchar_t"});
-    builtin_types_.push_back({builtin_type::kind_t::char8_t_, "char8_t"});
-    builtin_types_.push_back({builtin_type::kind_t::char16_t_, "char16_t"});
-    builtin_types_.push_back({builtin_type::kind_t::char32_t_, "char32_t"});
-
-    builtin_types_.push_back({builtin_type::kind_t::nullptr_t_, "nullptr_t"});
-
-    builtin_types_.push_back({builtin_type::kind_t::complex_char_, "char complex"});
-    builtin_types_.push_back({builtin_type::kind_t::complex_short_, "short complex"});
-    builtin_types_.push_back({builtin_type::kind_t::complex_int_, "int complex"});
-    builtin_types_.push_back({builtin_type::kind_t::complex_long_, "long complex"});
-    builtin_types_.push_back({builtin_type::kind_t::complex_long_long_, "long long complex"});
-
-    builtin_types_.push_back({builtin_type::kind_t::complex_unsigned_char_, "unsigned char complex"});
-    builtin_types_.push_back({builtin_type::kind_t::complex_unsigned_short_, "unsigned short complex"});
-    builtin_types_.push_back({builtin_type::kind_t::complex_unsigned_int_, "unsigned int complex"});
-    builtin_types_.push_back({builtin_type::kind_t::complex_unsigned_long_, "unsigned long complex"});
-    builtin_types_.push_back({builtin_type::kind_t::complex_unsigned_long_long_, "unsigned long long complex"});
-
-    builtin_types_.push_back({builtin_type::kind_t::complex_float_, "float complex"});
-    builtin_types_.push_back({builtin_type::kind_t::complex_double_, "double complex"});
-    builtin_types_.push_back({builtin_type::kind_t::complex_long_double_, "long double double"});
-
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_int8x1_, "svint8x1"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_int8x2_, "svint8x2"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_int8x2_, "svint8x3"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_int8x4_, "svint8x4"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_int16x1_, "svint16x1"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_int16x2_, "svint16x2"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_int16x2_, "svint16x3"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_int16x4_, "svint16x4"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_int32x1_, "svint32x1"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_int32x2_, "svint32x2"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_int32x2_, "svint32x3"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_int32x4_, "svint32x4"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_int64x1_, "svint64x1"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_int64x2_, "svint64x2"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_int64x2_, "svint64x3"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_int64x4_, "svint64x4"});
-
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_uint8x1_, "svuint8x1"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_uint8x2_, "svuint8x2"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_uint8x2_, "svuint8x3"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_uint8x4_, "svuint8x4"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_uint16x1_, "svuint16x1"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_uint16x2_, "svuint16x2"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_uint16x2_, "svuint16x3"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_uint16x4_, "svuint16x4"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_uint32x1_, "svuint32x1"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_uint32x2_, "svuint32x2"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_uint32x2_, "svuint32x3"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_uint32x4_, "svuint32x4"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_uint64x1_, "svuint64x1"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_uint64x2_, "svuint64x2"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_uint64x2_, "svuint64x3"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_uint64x4_, "svuint64x4"});
-
-
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_float16x1_, "svfloat16x1"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_float16x2_, "svfloat16x2"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_float16x2_, "svfloat16x3"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_float16x4_, "svfloat16x4"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_float32x1_, "svfloat32x1"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_float32x2_, "svfloat32x2"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_float32x2_, "svfloat32x3"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_float32x4_, "svfloat32x4"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_float64x1_, "svfloat64x1"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_float64x2_, "svfloat64x2"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_float64x2_, "svfloat64x3"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_float64x4_, "svfloat64x4"});
-
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_bfloat16x1_, "svbfloat16x1"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_bfloat16x2_, "svbfloat16x2"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_bfloat16x2_, "svbfloat16x3"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_bfloat16x4_, "svbfloat16x4"});
-
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_boolx1_, "svboolx1"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_boolx2_, "svboolx2"});
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_boolx4_, "svboolx4"});
-
-    builtin_types_.push_back({builtin_type::kind_t::arm_sve_count_, "svcount"});
+/// Kinds of builtin types in order of list of builtin types
+static constexpr builtin_type::kind_t builtin_type_kinds[] = {
+#define CM_BUILTIN_TYPE_KIND(knd, nm) builtin_type::kind_t::knd##_,
+    CM_BUILTIN_TYPES(CM_BUILTIN_TYPE_KIND)
+#undef CM_BUILTIN_TYPE_KIND
+};
+
+
+/// Returns true if each kind in list of builtin types is equal to its index,
+/// so builtin types constructed from indices are in order of the list
+static constexpr bool builtin_type_kinds_ordered() {
+    for (std::size_t i = 0; i < std::size(builtin_type_kinds); ++i) {
+        if (static_cast<std::size_t>(builtin_type_kinds[i]) != i) {
+            return false;
+        }
+    }
+
+    return std::size(builtin_type_kinds) == builtin_type::num_kinds;
 }
 
+static_assert(builtin_type_kinds_ordered(), "builtin types must be listed in order of kinds");
+
+
+/// Makes array of builtin types of all kinds indexed by kinds
+template <std::size_t ... Kinds>
+static std::array<builtin_type, sizeof...(Kinds)> make_builtin_types(std::index_sequence<Kinds...>) {
+    return {builtin_type{static_cast<builtin_type::kind_t>(Kinds)}...};
+}
+
+
+code_model::code_model():
+code_model{nullptr, nullptr} {}
+
+
+code_model::code_model(std::pmr::memory_resource * res):
+code_model{res, nullptr} {}
+
+
+code_model::code_model(std::pmr::memory_resource * res, code_model * base):
+namespace_{nullptr, ""}, context{res, &names_, &qname_index_, &src_index_},
+context_entity{nullptr},
+base_{base},
+names_{res},
+qname_index_{entity_resource()},
+builtin_types_{make_builtin_types(std::make_index_sequence<builtin_type::num_kinds>{})},
+bt_types_{base ? base->bt_types_ : builtin_types_.data()},
+opaque_type_{this, record_kind::struct_},
+ptr_types_{entity_resource()}, lvalue_ref_types_{entity_resource()},
+rvalue_ref_types_{entity_resource()}, arr_types_{entity_resource()},
+vec_types_{entity_resource()}, func_types_{entity_resource()},
+mem_ptr_types_{entity_resource()} {}
+
 
 code_model::~code_model() {
-    // then removing all base classes for all records. This is required because
-    // it's possible to make loop of type uses via base class, i. e.
-    // class MyClass: Base<MyClass> ...
-    remove_namespace_base_records(this);
+    assert(num_forks_ == 0 && "can't destroy code model with forks");
+
+    // destroying all entities at once without maintaining lists of uses.
+    // Entities may use each other in any order, including loops of type uses
+    // via base class, i. e. class MyClass: Base<MyClass> ...
+    entity_teardown_scope teardown;
+
+    destroy_namespace_entities(this);
+
+    ptr_types_.clear();
+    lvalue_ref_types_.clear();
+    rvalue_ref_types_.clear();
+    arr_types_.clear();
+    vec_types_.clear();
+    func_types_.clear();
+    mem_ptr_types_.clear();
+    for (auto && bt : builtin_types_) {
+        bt.drop_uses();
+    }
+
+    // remaining entities are destroyed after leaving teardown scope
+    opaque_type_.drop_uses();
+    drop_uses();
+
+    if (base_) {
+        --base_->num_forks_;
+    }
+}
+
 
-    // removing all entities in global namespace
-    remove_namespace_entities(this);
+void code_model::freeze() {
+    if (frozen_) {
+        return;
+    }
+
+    load_all();
+    freeze_namespace(this);
+
+    auto freeze_types = [](auto && types) {
+        for (auto && t : types.types()) {
+            t->freeze();
+        }
+    };
+
+    freeze_types(ptr_types_);
+    freeze_types(lvalue_ref_types_);
+    freeze_types(rvalue_ref_types_);
+    freeze_types(arr_types_);
+    freeze_types(vec_types_);
+    freeze_types(func_types_);
+    freeze_types(mem_ptr_types_);
+    for (auto && bt : builtin_types_) {
+        bt.freeze();
+    }
+
+    opaque_type_.freeze();
+    locations_.freeze();
+    frozen_ = true;
+}
+
+
+std::unique_ptr<code_model> code_model::fork() {
+    freeze();
+
+    auto res = std::unique_ptr<code_model>{new code_model{entity_resource(), this}};
+    ++num_forks_;
+    return res;
+}
 
-    // now removing all composite types (ptr/ref/arr/func) and types depended on them
 
-    while (!ptr_types_.empty()) {
-        remove_entity_and_uses(ptr_types_.first());
+void code_model::load_all() {
+    // loading contents may add contexts with contents loaded on demand to
+    // other loaders, so loaders are visited until no contents are loaded
+    bool loaded = true;
+    while (loaded) {
+        loaded = false;
+        for (auto && loader : loaders_) {
+            loaded |= loader->load_all();
+        }
     }
+}
+
+
+bool code_model::load_enclosing_context(std::string_view qname) const {
+    // searching for the last separator of components of qualified name
+    // skipping separators in template arguments
+    auto pos = std::string_view::npos;
+    int depth = 0;
+    for (std::size_t i = 0; i + 1 < qname.size(); ++i) {
+        if (qname[i] == '<' || qname[i] == '(') {
+            ++depth;
+        } else if (qname[i] == '>' || qname[i] == ')') {
+            --depth;
+        } else if (depth == 0 && qname[i] == ':' && qname[i + 1] == ':') {
+            pos = i++;
+        }
+    }
+
+    if (pos == std::string_view::npos || pos == 0) {
+        return false;
+    }
+
+    auto ctx = entity_cast<const context>(resolve(qname.substr(0, pos)));
+    if (!ctx || ctx->is_loaded()) {
+        return false;
+    }
+
+    ctx->load();
+    return true;
+}
 
-    while (!lvalue_ref_types_.empty()) {
-        remove_entity_and_uses(lvalue_ref_types_.first());
+
+namespace_ * code_model::fork_namespace(const namespace_ * ns) {
+    if (ns->is_root()) {
+        return this;
     }
 
-    while (!rvalue_ref_types_.empty()) {
-        remove_entity_and_uses(rvalue_ref_types_.first());
+    auto parent = fork_namespace(entity_cast<const namespace_>(ns->ctx()));
+    if (ns->name().empty()) {
+        // anonymous namespaces share qualified names with parent namespaces
+        return parent;
     }
 
-    while (!arr_types_.empty()) {
-        remove_entity_and_uses(arr_types_.first());
+    return parent->get_or_create_namespace(std::string{ns->name()});
+}
+
+
+bool code_model::is_hidden(const context_entity * ent, const code_model * base) const {
+    for (auto cm = this; cm != base; cm = cm->base_) {
+        if (cm->hidden_.empty()) {
+            continue;
+        }
+
+        for (auto e = ent; e; e = e->ctx()) {
+            if (cm->hidden_.contains(e)) {
+                return true;
+            }
+        }
     }
 
-    while (!func_types_.empty()) {
-        remove_entity_and_uses(func_types_.first());
+    return false;
+}
+
+
+void code_model::freeze_namespace(namespace_ * ns) {
+    for (auto && nested_ns : ns->namespaces()) {
+        freeze_namespace(nested_ns);
     }
 
-    while (!vec_types_.empty()) {
-        remove_entity_and_uses(vec_types_.first());
+    freeze_context(ns);
+}
+
+
+void code_model::freeze_context(context * ctx) {
+    for (auto && ent : ctx->entities()) {
+        if (auto nested_ctx = ent->cast<context>()) {
+            freeze_context(nested_ctx);
+        } else {
+            ent->freeze();
+        }
     }
+
+    ctx->freeze();
 }
 
 
@@ -177,24 +255,24 @@ void code_model::replace_type(type_t * src, type_t * dst) {
     // composite types from dst. Replaceing of uses of composite types
     // derived from the src type does not changes uses of src type itself.
     for (auto use : src->uses()) {
-        if (auto ptr_type = dynamic_cast<pointer_type*>(use)) {
+        if (auto ptr_type = entity_cast<pointer_type>(use)) {
             auto new_base = ptr_type->base().replaced_type(src, dst);
             auto new_ptr = get_or_create_ptr_type(new_base);
             replace_type(ptr_type, new_ptr);
-        } else if (auto ref_type = dynamic_cast<lvalue_reference_type*>(use)) {
+        } else if (auto ref_type = entity_cast<lvalue_reference_type>(use)) {
             auto new_base = ref_type->base().replaced_type(src, dst);
             auto new_ref = get_or_create_lvalue_ref_type(new_base);
             replace_type(ref_type, new_ref);
-        } else if (auto arr_type = dynamic_cast<array_type*>(use)) {
+        } else if (auto arr_type = entity_cast<array_type>(use)) {
             auto new_arr = get_or_create_arr_type(dst, arr_type->size());
             replace_type(arr_type, new_arr);
-        } else if (auto func_type = dynamic_cast<function_type*>(use)) {
+        } else if (auto func_type = entity_cast<function_type>(use)) {
             auto new_ret = func_type->ret_type().replaced_type(src, dst);
             auto fn = [src, dst](auto && par) { return par.replaced_type(src, dst); };
             auto new_pars = func_type->params() | std::ranges::views::transform(fn);
             auto new_ftype = get_or_create_func_type_r(new_ret, new_pars);
             replace_type(func_type, new_ftype);
-        } else if (auto mtype = dynamic_cast<mem_ptr_type*>(use)) {
+        } else if (auto mtype = entity_cast<mem_ptr_type>(use)) {
             auto new_obj = mtype->obj_type();
 
             if (new_obj == src) {
@@ -217,11 +295,11 @@ void code_model::replace_type(type_t * src, type_t * dst) {
         auto use = *use_it;
 
         // skip composite types. This use will not be removed
-        if (dynamic_cast<pointer_type*>(use) ||
-            dynamic_cast<lvalue_reference_type*>(use) ||
-            dynamic_cast<mem_ptr_type*>(use) ||
-            dynamic_cast<array_type*>(use) ||
-            dynamic_cast<function_type*>(use)) {
+        if (entity_cast<pointer_type>(use) ||
+            entity_cast<lvalue_reference_type>(use) ||
+            entity_cast<mem_ptr_type>(use) ||
+            entity_cast<array_type>(use) ||
+            entity_cast<function_type>(use)) {
 
             ++use_it;
             continue;
@@ -231,18 +309,18 @@ void code_model::replace_type(type_t * src, type_t * dst) {
         // so we need to increase it before removing uses
         ++use_it;
 
-        if (auto var = dynamic_cast<variable*>(use)) {
+        if (auto var = entity_cast<variable>(use)) {
             var->set_type(var->type().replaced_type(src, dst));
-        } else if (auto func = dynamic_cast<function*>(use)) {
+        } else if (auto func = entity_cast<function>(use)) {
             // function return type
             func->set_ret_type(func->ret_type().replaced_type(src, dst));
-        } else if (auto param = dynamic_cast<function_parameter*>(use)) {
+        } else if (auto param = entity_cast<function_parameter>(use)) {
             param->set_type(param->type().replaced_type(src, dst));
-        } else if (auto td = dynamic_cast<typedef_type*>(use)) {
+        } else if (auto td = entity_cast<typedef_type>(use)) {
             td->set_base(td->base().replaced_type(src, dst));
-        } else if (auto t_arg = dynamic_cast<type_template_argument*>(use)) {
+        } else if (auto t_arg = entity_cast<type_template_argument>(use)) {
             t_arg->set_type(t_arg->type().replaced_type(src, dst));
-        } else if (auto type = dynamic_cast<type_t*>(use)) {
+        } else if (auto type = entity_cast<type_t>(use)) {
             if (auto rtype = type->cast<record_type>()) {
                 rtype->replace_base(src, dst);
             } else {
@@ -302,83 +380,99 @@ void code_model::remove_type(type_t * type) {
 
 
 /// Searches for existing source file with specified path. Returns null if not found.
-const source_file * code_model::find_source(const std::filesystem::path & p,
-                                            bool find_name) const {
+const source_file * code_model::find_source(std::string_view p, bool find_name) const {
     // trying find source with exact path match
     if (auto it = sources_.find(p); it != sources_.end()) {
         return it->second.get();
     }
 
-    if (!find_name || p.filename() != p) {
-        return nullptr;
+    if (!find_name || p.find('/') != std::string_view::npos) {
+        return base_ ? base_->find_source(p, find_name) : nullptr;
     }
 
     // trying search source with matching file name
     for (auto && [path, src] : sources_) {
-        if (path.filename() == p) {
+        if (src->path().filename() == p) {
             return src.get();
         }
     }
 
-    return nullptr;
-}
-
-
-void code_model::dump(std::ostream & str, const dump_options & opts, unsigned int indent) const {
-    namespace_::dump_entities(str, opts, indent);
+    return base_ ? base_->find_source(p, find_name) : nullptr;
 }
 
 
-void code_model::remove_decl_context_base_records(context * ctx) {
-    // removing bases from records
-    for (auto && decl : ctx->entities()) {
-        // removing all base records if type is a record
-        if (auto * rtype = dynamic_cast<record*>(decl)) {
-            rtype->remove_all_bases();
-        }
+/// Returns source file owning entity or namespace level entity containing
+/// entity. Returns nullptr for entities not owned by source files
+static const source_file * entity_owner_source(const entity * ent) {
+    if (auto par = entity_cast<const function_parameter>(ent)) {
+        ent = par->func();
+    } else if (auto t_arg = entity_cast<const type_template_argument>(ent)) {
+        ent = t_arg->substitution();
+    }
 
-        // removing base records for all records in nested decl ctx
-        if (auto nested_dctx = dynamic_cast<context*>(decl)) {
-            remove_decl_context_base_records(nested_dctx);
+    for (auto ctx_ent = entity_cast<const context_entity>(ent); ctx_ent; ctx_ent = ctx_ent->ctx()) {
+        if (auto src = ctx_ent->owner_source()) {
+            return src;
         }
     }
-}
 
+    return nullptr;
+}
 
-void code_model::remove_namespace_base_records(namespace_ * ns) {
-    // removing base records from namespace decl ctx
-    remove_decl_context_base_records(ns);
 
-    // removing base records from all nested namespaces
-    for (auto && nested_ns : ns->namespaces()) {
-        remove_namespace_base_records(nested_ns);
+std::vector<const source_file*> code_model::remove_source_entities(const source_file * src) {
+    // removed entities remove themselves from index when destroyed
+    std::vector<const source_file*> owners;
+    while (auto ent = src_index_.first(src)) {
+        remove_entity_and_uses(ent, &owners);
     }
+
+    std::erase(owners, src);
+    return owners;
 }
 
 
-void code_model::remove_entity_and_uses(entity * ent) {
-    // removing all nested entities
+void code_model::dump(std::ostream & str, const dump_options & opts, unsigned int indent) const {
+    namespace_::dump_entities(str, opts, indent);
+}
+
+
+void code_model::remove_entity_uses(entity * ent, std::vector<const source_file*> * owners) {
+    // removing uses of all nested entities. Nested entities are removed together
+    // with context, removing of entities does not invalidate iterators
     if (auto ctx = ent->cast<context>()) {
-        auto ctx_entities = ctx->entities();
-        while (!std::ranges::empty(ctx_entities)) {
-            remove_entity_and_uses(*std::ranges::begin(ctx_entities));
+        for (auto && nested_ent : ctx->entities()) {
+            remove_entity_uses(nested_ent, owners);
         }
     }
 
     // removing all entity uses
     auto ent_uses = ent->uses();
     while (!std::ranges::empty(ent_uses)) {
-        auto ent_use_ent = dynamic_cast<entity*>(*std::ranges::begin(ent_uses));
+        auto ent_use_ent = entity_cast<entity>(*std::ranges::begin(ent_uses));
         assert(ent_use_ent && "don't know how to remove non code model entity use");
 
+        // recording source file owning entity using removed entity
+        if (owners) {
+            auto src = entity_owner_source(ent_use_ent);
+            if (src && std::ranges::find(*owners, src) == owners->end()) {
+                owners->push_back(src);
+            }
+        }
+
         // special case for function return type
-        auto func = dynamic_cast<function*>(ent_use_ent);
+        auto func = entity_cast<function>(ent_use_ent);
         if (func && func->ret_type().type() == ent) {
             func->set_ret_type({});
         } else {
-            remove_entity_and_uses(ent_use_ent);
+            remove_entity_and_uses(ent_use_ent, owners);
         }
     }
+}
+
+
+void code_model::remove_entity_and_uses(entity * ent, std::vector<const source_file*> * owners) {
+    remove_entity_uses(ent, owners);
 
     if (auto ctx_ent = ent->cast<context_entity>()) {
         // removing context entity from parent context
@@ -413,20 +507,14 @@ void code_model::remove_entity_and_uses(entity * ent) {
 }
 
 
-void code_model::remove_namespace_entities(namespace_ * ns) {
-    // removing all entities frmo this namespace
-    auto entities = ns->entities();
-    while (!std::ranges::empty(entities)) {
-        remove_entity_and_uses(*std::ranges::begin(entities));
-    }
-
-    // removing all nested namespaces
+void code_model::destroy_namespace_entities(namespace_ * ns) {
+    // nested namespaces destroy their entities when destroyed
     auto nss = ns->namespaces();
     while (!std::ranges::empty(nss)) {
-        auto nested_ns = *std::ranges::begin(nss);
-        remove_namespace_entities(nested_ns);
-        ns->remove_namespace(nested_ns);
+        ns->remove_namespace(*std::ranges::begin(nss));
     }
+
+    ns->clear();
 }
 
 
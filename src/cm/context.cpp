@@ -12,6 +12,7 @@
 #include "cm/decltype_type.hpp"
 #include "cm/dependent_type.hpp"
 #include "cm/function.hpp"
+#include "cm/namespace.hpp"
 #include "cm/record_type.hpp"
 #include "cm/template_function.hpp"
 #include "cm/template_instantiation.hpp"
@@ -19,34 +20,84 @@
 #include <ranges>
 #include <sstream>
 #include <iostream>
+#include <utility>
 
 
 namespace cm {
 
 
 void context::remove_entity(context_entity * ent) {
+    assert(!is_frozen() && "can't modify frozen context");
+
     // checking that type context_entity has no uses
     assert(std::ranges::empty(ent->uses()) && "can't remove entity with uses");
 
-    // removing entity from map of named decls if it has name
-    if (auto named_ent = dynamic_cast<named_context_entity*>(ent)) {
+    // removing entity from map of named decls and from index of qualified
+    // names if it has name
+    if (auto named_ent = entity_cast<named_context_entity>(ent)) {
+        remove_qualified_name(named_ent, named_ent->name_symbol());
         remove_named_entity_from_map(named_ent);
     }
 
-    // removing entity
-    // TODO: refactor and optimize with iterators
-    auto it = std::ranges::find_if(entities_, [ent](auto && t) { return t.get() == ent; });
-    assert(it != std::ranges::end(entities_) && "context_entity not found in decl context");
-    entities_.erase(it);
+    // removing entity from index of entities by kind
+    kind_index_.erase(ent);
+
+    // removing and destroying entity
+    entities_.erase(ent);
+}
+
+
+void context::set_entity_owner(context_entity * ent, const source_file * src) {
+    assert(ent->ctx() == this && "entity is not in context");
+    assert(src_index_ && "context doesn't belong to code model");
+    assert(!entity_cast<namespace_>(ent) && "namespace can't be owned by source file");
+
+    if (ent->owner_src_) {
+        src_index_->erase(ent->owner_src_, ent);
+    }
+
+    ent->owner_src_ = src;
+    if (src) {
+        src_index_->insert(src, ent);
+    }
+}
+
+
+void context::load_contents() const {
+    // contents are not loaded while code model is destroyed
+    if (entity_teardown_scope::active()) {
+        return;
+    }
+
+    auto loader = std::exchange(loader_, nullptr);
+    loader->load(const_cast<context*>(this));
 }
 
 
-const named_type * context::find_named_type(const std::string & name) const {
+void context::clear() {
+    // checking that entities have no uses, entities may be destroyed with
+    // uses only inside teardown scope
+    assert((entity_teardown_scope::active() ||
+            std::ranges::all_of(entities_.entities(),
+                                [](auto && ent) { return std::ranges::empty(ent->uses()); })) &&
+           "can't remove entities with uses");
+
+    for (auto && [name, ent] : named_entities_) {
+        remove_qualified_name(ent, name);
+    }
+
+    named_entities_.clear();
+    kind_index_.clear();
+    entities_.clear();
+}
+
+
+const named_type * context::find_named_type(std::string_view name) const {
     return find_named_entity<named_type>(name);
 }
 
 
-named_type * context::find_named_type(const std::string & name) {
+named_type * context::find_named_type(std::string_view name) {
     return find_named_entity<named_type>(name);
 }
 
@@ -56,12 +107,12 @@ record_type * context::create_record(record_kind knd) {
 }
 
 
-named_record_type * context::find_named_record(const std::string & name) {
+named_record_type * context::find_named_record(std::string_view name) {
     return find_named_entity<named_record_type>(name);
 }
 
 
-const named_record_type * context::find_named_record(const std::string & name) const {
+const named_record_type * context::find_named_record(std::string_view name) const {
     return find_named_entity<named_record_type>(name);
 }
 
@@ -71,12 +122,12 @@ named_record_type * context::create_named_record(const std::string & name, recor
 }
 
 
-const typedef_type * context::find_typedef(const std::string & name) const {
+const typedef_type * context::find_typedef(std::string_view name) const {
     return find_named_entity<typedef_type>(name);
 }
 
 
-typedef_type * context::find_typedef(const std::string & name) {
+typedef_type * context::find_typedef(std::string_view name) {
     return find_named_entity<typedef_type>(name);
 }
 
@@ -86,12 +137,12 @@ typedef_type * context::create_typedef(const std::string & name, const qual_type
 }
 
 
-const enum_type * context::find_enum(const std::string & name) const {
+const enum_type * context::find_enum(std::string_view name) const {
     return find_named_entity<enum_type>(name);
 }
 
 
-enum_type * context::find_enum(const std::string & name) {
+enum_type * context::find_enum(std::string_view name) {
     return find_named_entity<enum_type>(name);
 }
 
@@ -101,7 +152,12 @@ enum_type * context::create_enum(const std::string & name, builtin_type * base)
 }
 
 
-variable * context::find_var(const std::string & name) {
+const variable * context::find_var(std::string_view name) const {
+    return find_named_entity<variable>(name);
+}
+
+
+variable * context::find_var(std::string_view name) {
     return find_named_entity<variable>(name);
 }
 
@@ -111,12 +167,12 @@ variable * context::create_var(const std::string & name, const qual_type & type)
 }
 
 
-const named_function * context::find_function(const std::string & nm) const {
+const named_function * context::find_function(std::string_view nm) const {
     return find_named_entity<named_function>(nm);
 }
 
 
-named_function * context::find_function(const std::string & nm) {
+named_function * context::find_function(std::string_view nm) {
     return find_named_entity<named_function>(nm);
 }
 
@@ -126,22 +182,22 @@ named_function * context::create_function(const std::string & name) {
 }
 
 
-const template_ * context::find_template(const std::string & name) const {
+const template_ * context::find_template(std::string_view name) const {
     return find_named_entity<template_>(name);
 }
 
 
-template_ * context::find_template(const std::string & name) {
+template_ * context::find_template(std::string_view name) {
     return find_named_entity<template_>(name);
 }
 
 
-const template_function * context::find_template_function(const std::string & name) const {
+const template_function * context::find_template_function(std::string_view name) const {
     return find_named_entity<template_function>(name);
 }
 
 
-template_function * context::find_template_function(const std::string & name) {
+template_function * context::find_template_function(std::string_view name) {
     return find_named_entity<template_function>(name);
 }
 
@@ -151,18 +207,84 @@ template_function * context::create_template_function(const std::string & name)
 }
 
 
-const template_record * context::find_template_record(const std::string & name) const {
+const template_record * context::find_template_record(std::string_view name) const {
     return find_named_entity<template_record>(name);
 }
 
 
-template_record * context::find_template_record(const std::string & name) {
+template_record * context::find_template_record(std::string_view name) {
     return find_named_entity<template_record>(name);
 }
 
 
+void context::rename_entity(named_context_entity * ent, std::string_view str) {
+    auto sym = names_->intern(str);
+    if (ent->name_symbol() == sym) {
+        return;
+    }
+
+    remove_qualified_name(ent, ent->name_symbol());
+    remove_named_entity_from_map(ent);
+    named_entities_.emplace(sym, ent);
+    ent->set_name_impl(sym);
+    add_qualified_name(ent, sym);
+}
+
+
+void context::add_qualified_name(context_entity * ent, symbol name) {
+    // index is not maintained for entities without qualified names and
+    // while destroying code model
+    if (!qname_index_ || qname_key_ == 0 || entity_teardown_scope::active()) {
+        return;
+    }
+
+    // entity with empty name shares key with this context
+    auto key = qualified_name_index::child_key(qname_key_, name);
+    if (!name.empty()) {
+        qname_index_->insert(key, ent, name);
+    }
+
+    if (auto ctx = entity_cast<context>(ent)) {
+        ctx->qname_key_ = key;
+        ctx->qname_name_ = name;
+        ctx->add_nested_qualified_names();
+    }
+}
+
+
+void context::remove_qualified_name(context_entity * ent, symbol name) {
+    if (!qname_index_ || qname_key_ == 0 || entity_teardown_scope::active()) {
+        return;
+    }
+
+    if (!name.empty()) {
+        qname_index_->erase(qualified_name_index::child_key(qname_key_, name), ent);
+    }
+
+    if (auto ctx = entity_cast<context>(ent)) {
+        ctx->remove_nested_qualified_names();
+        ctx->qname_key_ = 0;
+        ctx->qname_name_ = {};
+    }
+}
+
+
+void context::add_nested_qualified_names() {
+    for (auto && [name, ent] : named_entities_) {
+        add_qualified_name(ent, name);
+    }
+}
+
+
+void context::remove_nested_qualified_names() {
+    for (auto && [name, ent] : named_entities_) {
+        remove_qualified_name(ent, name);
+    }
+}
+
+
 void context::remove_named_entity_from_map(named_context_entity * ent) {
-    auto [first, last] = named_entities_.equal_range(ent->name());
+    auto [first, last] = named_entities_.equal_range(ent->name_symbol());
     auto it = std::find_if(first, last, [ent](auto && p) { return p.second == ent; });
     assert(it != last && "named type not found in map");
     named_entities_.erase(it);
@@ -171,7 +293,7 @@ void context::remove_named_entity_from_map(named_context_entity * ent) {
 
 template_record_instantiation_type *
 context::dynamic_cast_template_record_instantiation_type(template_instantiation * inst) {
-    return dynamic_cast<template_record_instantiation_type*>(inst);
+    return entity_cast<template_record_instantiation_type>(inst);
 }
 
 
@@ -188,18 +310,18 @@ void context::dump_entities(std::ostream & str,
         }
 
         // skipping dependent_type and decltype types
-        if (dynamic_cast<const dependent_type*>(ent) ||
-            dynamic_cast<const decltype_type*>(ent)) {
+        if (entity_cast<const dependent_type>(ent) ||
+            entity_cast<const decltype_type>(ent)) {
             continue;
         }
 
         // skipping template parameters
-        if (dynamic_cast<const template_parameter*>(ent)) {
+        if (entity_cast<const template_parameter>(ent)) {
             continue;
         }
 
-        bool entity_is_context = dynamic_cast<const context*>(ent) != nullptr &&
-                                 dynamic_cast<const function*>(ent) == nullptr;
+        bool entity_is_context = entity_cast<const context>(ent) != nullptr &&
+                                 entity_cast<const function>(ent) == nullptr;
 
         // printing separator line between context entities (records, namespaces, etc)
         if (prev_entity_is_context || (entity_is_context && !first)) {
@@ -23,6 +23,13 @@ context_entity{ctx, access_level::public_} {
 }
 
 
+context_entity::~context_entity() {
+    if (owner_src_ && !entity_teardown_scope::active()) {
+        entity_ctx_->src_index_->erase(owner_src_, this);
+    }
+}
+
+
 void context_entity::dump_loc(std::ostream & str, const dump_options & opts) const {
     if (!opts.locations) {
         return;
@@ -32,9 +39,10 @@ void context_entity::dump_loc(std::ostream & str, const dump_options & opts) con
         return;
     }
 
-    str << " [" << loc().file()->path().filename()
-        << ':' << loc().line()
-        << ':' << loc().column()
+    auto dloc = loc().decode();
+    str << " [" << dloc.file->path().filename()
+        << ':' << dloc.line
+        << ':' << dloc.column
         << ']';
 }
 
@@ -21,6 +21,7 @@
 #include <clang/Basic/Specifiers.h>
 #include <clang/Basic/SourceManager.h>
 #include <llvm/Support/raw_ostream.h>
+#include <algorithm>
 #include <ranges>
 
 
@@ -72,17 +73,44 @@ static std::string dump_decl_to_string(const ::clang::Decl * decl) {
 }
 
 
+/// Returns number of declarations in declaration context and its nested
+/// namespaces and linkage specifications. Counts declarations in nested
+/// records if with_records is true
+static std::size_t count_decls(const ::clang::DeclContext * clang_ctx, bool with_records) {
+    std::size_t res = 0;
+    for (auto && decl : clang_ctx->decls()) {
+        ++res;
+        if (::clang::isa<::clang::NamespaceDecl, ::clang::LinkageSpecDecl>(decl) ||
+            (with_records && ::clang::isa<::clang::RecordDecl>(decl))) {
+            res += count_decls(::clang::cast<::clang::DeclContext>(decl), with_records);
+        }
+    }
+
+    return res;
+}
+
+
 void ast_converter::convert(const ::clang::ASTContext & ctx) {
     clang_ast_ctx_ = &ctx;
+    locs_.reset(&ctx.getSourceManager());
 
     // traversing over all top level declarations in translation unit
     auto tu_decl = ctx.getTranslationUnitDecl();
 
+    // reserving map of declarations for declarations converted eagerly.
+    // Members of records are not counted in lazy mode, counting them would
+    // deserialize them from precompiled preamble
+    decls_.reserve(count_decls(tu_decl, !lazy_));
+
     context_setter csetter{*this, &mdl_, tu_decl};
 
     CM_CLANG_LOG_TRACE << "converting translation unit:\n" << dump_decl_to_string(tu_decl);
 
     for (auto && decl : tu_decl->decls()) {
+        if (skip_converted_decl(decl)) {
+            continue;
+        }
+
         CM_CLANG_LOG_TRACE << "converting top level declaration:\n" << dump_decl_to_string(decl);
 
         // converting namespaces separately from other declarations
@@ -93,7 +121,94 @@ void ast_converter::convert(const ::clang::ASTContext & ctx) {
         }
     }
 
-    clang_ast_ctx_ = nullptr;
+    // headers are marked as converted only after all their declarations
+    // in translation unit are converted
+    if (headers_) {
+        for (auto && [file, content_hash] : new_headers_) {
+            headers_->insert(file, content_hash);
+        }
+    }
+
+    new_headers_.clear();
+
+    // AST context is used for converting contents of contexts on demand,
+    // declarations from skipped headers are resolved while converting them
+    if (!lazy_) {
+        clang_ast_ctx_ = nullptr;
+        locs_.reset(nullptr);
+        skipped_files_.clear();
+    }
+}
+
+
+ast_converter::~ast_converter() {
+    for (auto && [ctx, decls] : pending_) {
+        ctx->set_loader(nullptr);
+    }
+
+    if (lazy_) {
+        mdl_.remove_loader(this);
+    }
+}
+
+
+void ast_converter::load(context * ctx) {
+    auto it = pending_.find(ctx);
+    assert(it != pending_.end() && "contents of context are not converted by this converter");
+    auto decls = it->second;
+    pending_.erase(it);
+
+    // converting record contents or function return type and parameters
+    if (auto clang_rec_decl = ::clang::dyn_cast_or_null<::clang::RecordDecl>(decls.contents)) {
+        CM_CLANG_LOG_DEBUG << "loading contents of record for clang decl: " << clang_rec_decl;
+        auto rec = entity_cast<record>(ctx);
+        assert(rec && "context must be a record for record declaration");
+        convert_record_contents(rec, clang_rec_decl);
+    } else if (auto clang_func = ::clang::dyn_cast_or_null<::clang::FunctionDecl>(decls.contents)) {
+        CM_CLANG_LOG_DEBUG << "loading signature of function for clang decl: " << clang_func;
+        auto func = entity_cast<function>(ctx);
+        assert(func && "context must be a function for function declaration");
+        context_setter csetter{*this, func, clang_func};
+        convert_function_ret_type_and_params(func, clang_func);
+    }
+
+    // converting template specializations
+    if (auto clang_templ = ::clang::dyn_cast_or_null<::clang::ClassTemplateDecl>(decls.specs)) {
+        CM_CLANG_LOG_DEBUG << "loading specializations of template for clang decl: " << clang_templ;
+        auto templ = entity_cast<template_record>(ctx);
+        assert(templ && "context must be a template record for class template declaration");
+        context_setter csetter{*this, templ, clang_templ->getTemplatedDecl()};
+        for (auto && spec : clang_templ->specializations()) {
+            convert_template_class_spec(templ, spec);
+        }
+    } else if (auto clang_templ = ::clang::dyn_cast_or_null<::clang::FunctionTemplateDecl>(decls.specs)) {
+        CM_CLANG_LOG_DEBUG << "loading specializations of template for clang decl: " << clang_templ;
+        auto templ = entity_cast<template_function>(ctx);
+        assert(templ && "context must be a template function for function template declaration");
+        context_setter csetter{*this, templ, clang_templ->getTemplatedDecl()};
+        for (auto && spec : clang_templ->specializations()) {
+            convert_template_function_inst(templ, spec);
+        }
+    }
+}
+
+
+void ast_converter::cancel(context * ctx) {
+    pending_.erase(ctx);
+}
+
+
+bool ast_converter::load_all() {
+    bool res = !pending_.empty();
+
+    // converting contents may add new contexts with contents not converted yet
+    while (!pending_.empty()) {
+        auto ctx = pending_.begin()->first;
+        ctx->set_loader(nullptr);
+        load(ctx);
+    }
+
+    return res;
 }
 
 
@@ -689,11 +804,19 @@ namespace_ * ast_converter::convert_ns(const ::clang::NamespaceDecl * clang_ns)
     // setting new decl context
     context_setter csetter{*this, ns, clang_ns};
 
-    // adding namespace into map of entitites
-    add_cm_entity(clang_ns, ns);
+    // adding namespace into map of entitites. Reopened namespace is already
+    // associated with namespace or it's associated on lookup of namespace
+    // from skipped header
+    if (!decls_.find(clang_ns->getCanonicalDecl())) {
+        add_cm_entity(clang_ns, ns);
+    }
 
     // converting top level declarations in namespace
     for (auto && decl : clang_ns->decls()) {
+        if (skip_converted_decl(decl)) {
+            continue;
+        }
+
         if (auto decl_ns = ::clang::dyn_cast<::clang::NamespaceDecl>(decl)) {
             convert_ns(decl_ns);
         } else {
@@ -769,6 +892,12 @@ function * ast_converter::convert_function(const ::clang::FunctionDecl * clang_f
     // adding function entity mapping
     add_cm_entity(clang_func_decl, func);
 
+    // converting function return type and parameters on first access in lazy mode
+    if (lazy_) {
+        defer_contents(func, clang_func_decl, nullptr);
+        return func;
+    }
+
     // setting function as current decl context
     context_setter csetter{*this, func, clang_func_decl};
 
@@ -867,8 +996,12 @@ ast_converter::convert_template_class(const ::clang::ClassTemplateDecl * clang_t
     // converting template specializations only for canonical decl
     // (canonical decl is only one in all translation unit)
     if (clang_templ_decl->isCanonicalDecl()) {
-        for (auto && spec : clang_templ_decl->specializations()) {
-            convert_template_class_spec(rec, spec);
+        if (lazy_) {
+            defer_contents(rec, nullptr, clang_templ_decl);
+        } else {
+            for (auto && spec : clang_templ_decl->specializations()) {
+                convert_template_class_spec(rec, spec);
+            }
         }
     }
 
@@ -1011,6 +1144,13 @@ ast_converter::convert_template_function(const ::clang::FunctionTemplateDecl * c
     // converting template parameters
     convert_template_params(func, clang_templ_pars);
 
+    // converting function return type, parameters and specializations on
+    // first access in lazy mode
+    if (lazy_) {
+        defer_contents(func, clang_func_decl, clang_func_decl->isCanonicalDecl() ? clang_decl : nullptr);
+        return func;
+    }
+
     // converting function return type and parameters
     convert_function_ret_type_and_params(func, clang_func_decl);
 
@@ -1069,14 +1209,266 @@ void ast_converter::convert_linkage_spec(const ::clang::LinkageSpecDecl * decl)
 }
 
 
-source_location ast_converter::convert_loc(const ::clang::SourceLocation & loc) const {
-    auto ploc = clang_ast_ctx_->getSourceManager().getPresumedLoc(loc);
-    if (!ploc.isValid()) {
-        return {};
+source_location ast_converter::convert_loc(const ::clang::SourceLocation & loc) {
+    return locs_.convert(loc);
+}
+
+
+const source_file * ast_converter::decl_source(const ::clang::Decl * clang_decl) {
+    auto & sm = clang_ast_ctx_->getSourceManager();
+    return locs_.file(sm.getFileID(sm.getExpansionLoc(clang_decl->getLocation())));
+}
+
+
+bool ast_converter::skip_converted_decl(const ::clang::Decl * clang_decl) {
+    // declarations from skipped headers are associated with existing code
+    // model entities when they are looked up
+    if (is_skipped_decl(clang_decl)) {
+        ++skipped_decls_;
+        return true;
+    }
+
+    ++converted_decls_;
+    return false;
+}
+
+
+bool ast_converter::is_skipped_decl(const ::clang::Decl * clang_decl) {
+    if (!headers_) {
+        return false;
+    }
+
+    // getting file containing declaration or expansion of macro with declaration
+    auto & sm = clang_ast_ctx_->getSourceManager();
+    auto fid = sm.getFileID(sm.getExpansionLoc(clang_decl->getLocation()));
+
+    auto it = skipped_files_.find(fid.getHashValue());
+    if (it == skipped_files_.end()) {
+        // declarations from main file and from buffers without files are
+        // always converted. Headers are identified by paths and hashes of
+        // contents, so changed headers are converted again
+        bool skip = false;
+        auto entry = sm.getFileEntryRefForID(fid);
+        if (fid.isValid() && fid != sm.getMainFileID() && entry) {
+            auto file = locs_.file(fid);
+            auto data = sm.getBufferData(fid);
+            auto content_hash = std::hash<std::string_view>{}(std::string_view{data.data(), data.size()});
+
+            if (std::ranges::find(included_headers_, file) == included_headers_.end()) {
+                included_headers_.push_back(file);
+            }
+
+            skip = headers_->contains(file, content_hash);
+            if (skip) {
+                CM_CLANG_LOG_DEBUG << "skipping declarations from converted header " << file->path();
+            } else if (std::ranges::find(new_headers_, file, &header::first) == new_headers_.end()) {
+                // entities converted from previous content of changed header
+                // are owned by header, they are removed before converting
+                // new content of header
+                if (headers_->changed(file, content_hash)) {
+                    CM_CLANG_LOG_DEBUG << "removing entities of changed header " << file->path();
+                    removed_sources_.push_back(file);
+
+                    // other headers which entities are removed with entities of
+                    // changed header are converted again when they are included
+                    for (auto src : mdl_.remove_source_entities(file)) {
+                        headers_->erase(src);
+                        removed_sources_.push_back(src);
+                    }
+                }
+
+                new_headers_.emplace_back(file, content_hash);
+            }
+        }
+
+        it = skipped_files_.emplace(fid.getHashValue(), skip).first;
     }
 
-    auto file = mdl_.source(ploc.getFilename());
-    return source_location{file, ploc.getLine(), ploc.getColumn()};
+    return it->second;
+}
+
+
+context_entity * ast_converter::resolve_skipped_decl(const ::clang::Decl * clang_decl) {
+    // instantiations of class templates are found by template arguments
+    if (auto spec = ::clang::dyn_cast<::clang::ClassTemplateSpecializationDecl>(clang_decl)) {
+        if (auto p_spec = ::clang::dyn_cast<::clang::ClassTemplatePartialSpecializationDecl>(spec)) {
+            return resolve_skipped_partial_specialization(p_spec);
+        }
+
+        auto clang_templ_decl = spec->getSpecializedTemplate()->getTemplatedDecl();
+        auto templ = get_cm_entity_as<template_record>(clang_templ_decl);
+        if (!templ) {
+            return nullptr;
+        }
+
+        // template arguments may depend on template context
+        context_setter csetter{*this, templ, clang_templ_decl};
+        auto args = convert_template_arguments(spec->getTemplateArgs().asArray());
+
+        templ->load();
+        if (auto inst = templ->find_instantiation(args)) {
+            return inst;
+        }
+
+        // instantiation used only in this translation unit is converted
+        record * rec = nullptr;
+        if (spec->isExplicitSpecialization()) {
+            rec = templ->create_specialization(args);
+        } else {
+            rec = templ->create_instantiation(args);
+        }
+
+        rec->set_loc(convert_loc(spec->getSpecializedTemplate()->getLocation()));
+        add_cm_entity(spec, rec);
+        fill_record_contents(rec, spec);
+        return rec;
+    }
+
+    // instantiations of function templates are found by template arguments
+    auto clang_func = ::clang::dyn_cast<::clang::FunctionDecl>(clang_decl);
+    if (clang_func && clang_func->getPrimaryTemplate()) {
+        auto clang_templ_decl = clang_func->getPrimaryTemplate()->getTemplatedDecl();
+        auto templ = get_cm_entity_as<template_function>(clang_templ_decl);
+        auto clang_args = clang_func->getTemplateSpecializationArgs();
+        if (!templ || !clang_args) {
+            return nullptr;
+        }
+
+        context_setter csetter{*this, templ, clang_templ_decl};
+        auto args = convert_template_arguments(clang_args->asArray());
+
+        templ->load();
+        if (auto inst = templ->find_instantiation(args)) {
+            return inst;
+        }
+
+        // instantiation used only in this translation unit is converted
+        auto inst = templ->create_instantiation(args);
+        convert_function_ret_type_and_params(inst, clang_func);
+        add_cm_entity(clang_func, inst);
+        return inst;
+    }
+
+    // other entities are found by names in parent contexts, anonymous
+    // entities can't be found
+    auto clang_named_decl = ::clang::dyn_cast<::clang::NamedDecl>(clang_decl);
+    if (!clang_named_decl) {
+        return nullptr;
+    }
+
+    auto nm = clang_named_decl->getNameAsString();
+    if (nm.empty()) {
+        return nullptr;
+    }
+
+    // getting parent context skipping linkage specifications
+    context * parent = &mdl_;
+    auto clang_parent = clang_decl->getDeclContext()->getRedeclContext();
+    if (!clang_parent->isTranslationUnit()) {
+        parent = entity_cast<context>(get_cm_entity(::clang::cast<::clang::Decl>(clang_parent)));
+        if (!parent) {
+            return nullptr;
+        }
+    }
+
+    if (::clang::isa<::clang::NamespaceDecl>(clang_decl)) {
+        auto parent_ns = entity_cast<namespace_>(parent);
+        return parent_ns ? parent_ns->find_namespace(nm) : nullptr;
+    } else if (auto clang_rec = ::clang::dyn_cast<::clang::CXXRecordDecl>(clang_decl);
+               clang_rec && clang_rec->getDescribedClassTemplate()) {
+        return parent->find_named_entity<template_record>(nm);
+    } else if (::clang::isa<::clang::RecordDecl>(clang_decl)) {
+        return parent->find_named_entity<named_record_type>(nm);
+    } else if (::clang::isa<::clang::TypedefNameDecl>(clang_decl)) {
+        return parent->find_named_entity<typedef_type>(nm);
+    } else if (::clang::isa<::clang::FieldDecl>(clang_decl)) {
+        return parent->find_named_entity<field>(nm);
+    } else if (::clang::isa<::clang::VarDecl>(clang_decl)) {
+        return parent->find_named_entity<variable>(nm);
+    } else if (clang_func && clang_func->getDescribedFunctionTemplate()) {
+        return parent->find_named_entity_if<template_function>(nm, [&](template_function * func) {
+            return function_params_match(func, clang_func);
+        });
+    } else if (clang_func) {
+        return parent->find_named_entity_if<named_function>(nm, [&](named_function * func) {
+            return !entity_isa<template_function>(func) && function_params_match(func, clang_func);
+        });
+    }
+
+    return nullptr;
+}
+
+
+template_record_partial_specialization * ast_converter::resolve_skipped_partial_specialization(
+        const ::clang::ClassTemplatePartialSpecializationDecl * clang_decl) {
+    auto clang_templ_decl = clang_decl->getSpecializedTemplate()->getTemplatedDecl();
+    auto templ = get_cm_entity_as<template_record>(clang_templ_decl);
+    if (!templ) {
+        return nullptr;
+    }
+
+    // partial specializations are in the same context as template. Converting
+    // arguments may create entities in that context, so candidates are
+    // collected before
+    auto clang_params = clang_decl->getTemplateParameters();
+    auto clang_args = clang_decl->getTemplateArgs().asArray();
+    std::vector<template_record_partial_specialization*> specs;
+    for (auto && spec : templ->ctx()->entities<template_record_partial_specialization>()) {
+        if (spec->templ() == templ &&
+            static_cast<std::size_t>(std::ranges::distance(spec->template_params())) == clang_params->size() &&
+            static_cast<std::size_t>(std::ranges::distance(spec->args())) == clang_args.size()) {
+            specs.push_back(spec);
+        }
+    }
+
+    // arguments of partial specialization depend on its own template
+    // parameters, so they are converted with declaration and parameters
+    // associated with each candidate and compared with arguments of candidate
+    for (auto && spec : specs) {
+        add_cm_entity(clang_decl, spec);
+        auto par_it = std::ranges::begin(spec->template_params());
+        for (auto && par : *clang_params) {
+            add_cm_entity(par, *par_it++);
+        }
+
+        context_setter csetter{*this, spec, clang_decl};
+        if (spec->args_equal(convert_template_arguments(clang_args))) {
+            return spec;
+        }
+
+        decls_.erase(clang_decl->getCanonicalDecl());
+        for (auto && par : *clang_params) {
+            decls_.erase(par->getCanonicalDecl());
+        }
+    }
+
+    return nullptr;
+}
+
+
+bool ast_converter::function_params_match(function * func,
+                                          const ::clang::FunctionDecl * clang_func) {
+    auto params = func->params();
+    if (static_cast<std::size_t>(std::ranges::distance(params)) != clang_func->getNumParams()) {
+        return false;
+    }
+
+    // types of parameters of templates are not compared, they depend on
+    // template parameters
+    if (clang_func->isDependentContext()) {
+        return true;
+    }
+
+    auto par_it = std::ranges::begin(params);
+    for (auto && clang_par : clang_func->parameters()) {
+        if ((*par_it)->type() != convert_type(clang_par->getType())) {
+            return false;
+        }
+
+        ++par_it;
+    }
+
+    return true;
 }
 
 
@@ -1087,6 +1479,16 @@ void ast_converter::fill_record_contents(cm::record * rec,
         return;
     }
 
+    if (lazy_) {
+        defer_contents(rec, clang_record_decl, nullptr);
+    } else {
+        convert_record_contents(rec, clang_record_decl);
+    }
+}
+
+
+void ast_converter::convert_record_contents(cm::record * rec,
+                                            const ::clang::RecordDecl * clang_record_decl) {
     // setting current declaration context
     context_setter csetter{*this, rec, clang_record_decl};
 
@@ -1244,19 +1646,90 @@ template_argument_desc_vector ast_converter::convert_template_arguments(
 context_entity * ast_converter::get_cm_entity(const ::clang::Decl * clang_decl) {
     auto canon_decl = clang_decl->getCanonicalDecl();
 
-    auto it = decls_.find(canon_decl);
-    if (it == decls_.end()) {
-        return nullptr;
+    auto ent = decls_.find(canon_decl);
+    if (!ent && lazy_ && load_decl_context(canon_decl)) {
+        // declaration is in context which contents were not converted yet
+        ent = decls_.find(canon_decl);
     }
 
-    return it->second;
+    // declaration from header converted by another converter is associated
+    // with entity converted by that converter
+    if (!ent && is_skipped_decl(canon_decl)) {
+        ent = resolve_skipped_decl(canon_decl);
+        if (ent && !decls_.find(canon_decl)) {
+            add_cm_entity(canon_decl, ent);
+        }
+    }
+
+    return ent;
 }
 
 
 void ast_converter::add_cm_entity(const ::clang::Decl * clang_decl, context_entity * cm_ent) {
     auto canon_decl = clang_decl->getCanonicalDecl();
-    auto [it, inserted] = decls_.emplace(canon_decl, cm_ent);
+    [[maybe_unused]] auto inserted = decls_.insert(canon_decl, cm_ent);
     assert(inserted && "code model context_entity is already associated with clang declaration");
+
+    // namespace level entities are owned by source file introducing them,
+    // so they are removed when source file is parsed again. Nested entities
+    // are removed with their parents
+    if (!cm_ent->owner_source() && entity_isa<namespace_>(cm_ent->ctx()) &&
+        !entity_isa<namespace_>(cm_ent)) {
+        if (auto src = decl_source(clang_decl)) {
+            cm_ent->ctx()->set_entity_owner(cm_ent, src);
+        }
+    }
+}
+
+
+void ast_converter::defer_contents(context * ctx,
+                                   const ::clang::Decl * contents,
+                                   const ::clang::Decl * specs) {
+    // contents of context created by another converter are converted by it
+    // before adding contents from this translation unit
+    if (!ctx->is_loaded() && !pending_.contains(ctx)) {
+        ctx->load();
+    }
+
+    auto & decls = pending_[ctx];
+    if (contents) {
+        decls.contents = contents;
+    }
+
+    if (specs) {
+        decls.specs = specs;
+    }
+
+    ctx->set_loader(this);
+}
+
+
+bool ast_converter::load_decl_context(const ::clang::Decl * clang_decl) {
+    // instantiations of templates are converted with specializations of
+    // templates, other declarations with contents of parent contexts
+    const ::clang::Decl * parent = nullptr;
+    auto func = ::clang::dyn_cast<::clang::FunctionDecl>(clang_decl);
+    auto spec = ::clang::dyn_cast<::clang::ClassTemplateSpecializationDecl>(clang_decl);
+    if (spec && !::clang::isa<::clang::ClassTemplatePartialSpecializationDecl>(spec)) {
+        parent = spec->getSpecializedTemplate()->getTemplatedDecl();
+    } else if (func && func->getPrimaryTemplate()) {
+        parent = func->getPrimaryTemplate()->getTemplatedDecl();
+    } else {
+        parent = ::clang::dyn_cast_or_null<::clang::Decl>(clang_decl->getDeclContext());
+    }
+
+    if (!parent) {
+        return false;
+    }
+
+    // parent context may be in context which contents are not converted too
+    auto ctx = entity_cast<context>(get_cm_entity(parent));
+    if (!ctx || ctx->is_loaded()) {
+        return false;
+    }
+
+    ctx->load();
+    return true;
 }
 
 
@@ -9,11 +9,22 @@
 
 #include "cm/cxx/clang/cmclang.hpp"
 #include "cm/cxx/clang/ast_converter.hpp"
+#include "log.hpp"
 #include <clang-c/Index.h>
 //#include <clang/tools/libclang/CXTranslationUnit.h>
 #include <clang/Frontend/ASTUnit.h>
 #include <clang/AST/ASTContext.h>
 #include <clang/AST/Decl.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 
 
 namespace cm::clang {
@@ -26,27 +37,40 @@ struct CXTranslationUnitImpl {
 };
 
 
-void parse_source_file(code_model & mdl,
-                       const std::filesystem::path & path,
-                       const std::vector<std::string> & args) {
-    // creating clang index
-    auto clang_idx = ::clang_createIndex(0, 1);
+/// Deleter of clang index
+struct index_deleter {
+    void operator()(CXIndex idx) const { ::clang_disposeIndex(idx); }
+};
+
+
+/// Owning pointer to clang index
+using index_ptr = std::unique_ptr<void, index_deleter>;
 
-    // converting command line arguments
-    std::vector<const char*> c_args;
-    for (auto && arg : args) {
-        c_args.push_back(arg.c_str());
-    }
-    
 
-    // parsing source file
+/// Deleter of translation unit
+struct translation_unit_deleter {
+    void operator()(CXTranslationUnit tu) const { ::clang_disposeTranslationUnit(tu); }
+};
+
+
+/// Owning pointer to translation unit
+using translation_unit_ptr =
+    std::unique_ptr<std::remove_pointer_t<CXTranslationUnit>, translation_unit_deleter>;
+
+
+/// Parses translation unit from source file using specified clang index and
+/// translation unit options. Throws exception if source file can't be parsed
+static CXTranslationUnit parse_translation_unit(CXIndex clang_idx,
+                                                const std::filesystem::path & path,
+                                                const std::vector<const char*> & c_args,
+                                                unsigned int options = 0) {
     auto tu = ::clang_parseTranslationUnit(clang_idx,
                                            path.string().c_str(),
                                            c_args.data(),
                                            c_args.size(),
                                            nullptr,     // unsaved files
                                            0,           // number of unsaved files
-                                           0);          // options
+                                           options);
 
     // checking for parse errors
     if (!tu) {
@@ -55,21 +79,395 @@ void parse_source_file(code_model & mdl,
         throw std::runtime_error(msg.str());
     }
 
-    // creating AST converter and converting AST to code model
-    {
-        // getting AST contetx from translation unit
-        // TODO: try avoid this hack
-        auto & ctx = reinterpret_cast<CXTranslationUnitImpl*>(tu)->TheASTUnit->getASTContext();
+    return tu;
+}
+
+
+/// Returns AST context of translation unit
+static const ::clang::ASTContext & get_ast_context(CXTranslationUnit tu) {
+    // TODO: try avoid this hack
+    return reinterpret_cast<CXTranslationUnitImpl*>(tu)->TheASTUnit->getASTContext();
+}
+
+
+/// Converts AST of translation unit to code model skipping declarations
+/// from specified converted headers if headers is not null. Stores numbers
+/// of converted and skipped declarations in timing if it's not null
+static void convert_translation_unit(code_model & mdl,
+                                     CXTranslationUnit tu,
+                                     converted_headers * headers = nullptr,
+                                     parse_timing * timing = nullptr) {
+    ast_converter ast_conv{mdl, headers};
+    ast_conv.convert(get_ast_context(tu));
+
+    if (timing) {
+        timing->converted_decls = ast_conv.converted_decls();
+        timing->skipped_decls = ast_conv.skipped_decls();
+    }
+}
+
+
+/// Converts command line arguments to vector of C strings
+static std::vector<const char*> make_c_args(const std::vector<std::string> & args) {
+    std::vector<const char*> c_args;
+    for (auto && arg : args) {
+        c_args.push_back(arg.c_str());
+    }
+
+    return c_args;
+}
+
+
+/// Returns true if command line argument is option removed from compile
+/// commands with value in the next argument
+static bool is_removed_option_with_value(std::string_view arg) {
+    return arg == "-o" || arg == "-MF" || arg == "-MT" || arg == "-MQ";
+}
+
+
+/// Returns true if command line argument is option removed from compile
+/// commands without value or with joined value
+static bool is_removed_option(std::string_view arg) {
+    // compilation mode and dependency files
+    if (arg == "-c" || arg == "-M" || arg == "-MM" || arg == "-MD" ||
+        arg == "-MMD" || arg == "-MP" || arg == "-MG") {
+        return true;
+    }
+
+    // joined output file, -obj... options are not output files
+    if (arg.starts_with("-o") && !arg.starts_with("-obj")) {
+        return true;
+    }
+
+    // joined dependency file and targets
+    return arg.starts_with("-MF") || arg.starts_with("-MT") || arg.starts_with("-MQ");
+}
+
+
+parse_command make_parse_command(const std::filesystem::path & dir,
+                                 const std::filesystem::path & file,
+                                 const std::vector<std::string> & cmd_line) {
+    auto abs_file = (dir / file).lexically_normal();
+    parse_command res{abs_file, {"-working-directory", dir.string()}};
+
+    // skipping compiler name
+    for (std::size_t i = 1; i < cmd_line.size(); ++i) {
+        auto & arg = cmd_line[i];
+        if (is_removed_option_with_value(arg)) {
+            ++i;
+        } else if (is_removed_option(arg) || (dir / arg).lexically_normal() == abs_file) {
+            continue;
+        } else {
+            res.args.push_back(arg);
+        }
+    }
+
+    return res;
+}
+
+
+void parse_source_file(code_model & mdl,
+                       const std::filesystem::path & path,
+                       const std::vector<std::string> & args) {
+    // translation unit is destroyed before clang index
+    index_ptr clang_idx{::clang_createIndex(0, 1)};
+    translation_unit_ptr tu{parse_translation_unit(clang_idx.get(), path, make_c_args(args))};
+
+    // converting AST to code model
+    convert_translation_unit(mdl, tu.get());
+}
+
+
+void parse_source_files(code_model & mdl,
+                        const std::vector<parse_command> & cmds,
+                        unsigned int threads,
+                        std::vector<parse_timing> * timings) {
+    if (threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    threads = static_cast<unsigned int>(std::min<std::size_t>(threads, cmds.size()));
+
+    if (timings) {
+        timings->assign(cmds.size(), {});
+    }
+
+    std::atomic<std::size_t> next_idx = 0;      // index of next source file to parse
+    std::atomic<bool> failed = false;           // some source file is not converted
+    std::mutex conv_mtx;                        // mutex for converting to code model
+    std::condition_variable conv_cv;            // notified after converting source file
+    std::size_t conv_idx = 0;                   // index of next source file to convert
+    std::exception_ptr err;                     // first error
+    converted_headers headers;                  // headers converted to code model
+
+    // returns milliseconds elapsed since specified time
+    auto elapsed_ms = [](auto start) {
+        std::chrono::duration<double, std::milli> dur = std::chrono::steady_clock::now() - start;
+        return dur.count();
+    };
+
+    auto worker = [&] {
+        // translation units parsed with the same index can't be parsed
+        // concurrently, each thread uses its own index
+        index_ptr clang_idx{::clang_createIndex(0, 1)};
+
+        for (auto idx = next_idx++; idx < cmds.size(); idx = next_idx++) {
+            auto & cmd = cmds[idx];
+
+            // parsing translation unit in parallel with other threads, remaining
+            // source files are skipped after error
+            translation_unit_ptr tu;
+            std::exception_ptr parse_err;
+            if (!failed) {
+                auto parse_start = std::chrono::steady_clock::now();
+                try {
+                    tu.reset(parse_translation_unit(clang_idx.get(), cmd.path, make_c_args(cmd.args)));
+                } catch (...) {
+                    parse_err = std::current_exception();
+                }
+
+                if (timings) {
+                    (*timings)[idx].path = cmd.path;
+                    (*timings)[idx].parse_ms = elapsed_ms(parse_start);
+                }
+            }
+
+            // converting translation units in order of commands
+            {
+                std::unique_lock lock{conv_mtx};
+                conv_cv.wait(lock, [&] { return conv_idx == idx; });
+
+                if (!err) {
+                    if (parse_err) {
+                        err = parse_err;
+                    } else {
+                        auto conv_start = std::chrono::steady_clock::now();
+                        try {
+                            convert_translation_unit(mdl, tu.get(), &headers,
+                                                     timings ? &(*timings)[idx] : nullptr);
+                        } catch (...) {
+                            err = std::current_exception();
+                        }
+
+                        if (timings) {
+                            (*timings)[idx].convert_ms = elapsed_ms(conv_start);
+                        }
+                    }
+
+                    failed = err != nullptr;
+                }
+
+                ++conv_idx;
+            }
+
+            conv_cv.notify_all();
+        }
+    };
+
+    // current thread is one of worker threads
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < threads; ++i) {
+        workers.emplace_back(worker);
+    }
+
+    worker();
 
-        ast_converter ast_conv{mdl};
-        ast_conv.convert(ctx);
+    for (auto && w : workers) {
+        w.join();
     }
 
-    // removing translation unit
-    ::clang_disposeTranslationUnit(tu);
+    if (err) {
+        std::rethrow_exception(err);
+    }
+}
+
+
+void parse_source_files(code_model & mdl,
+                        const std::vector<std::filesystem::path> & paths,
+                        const std::vector<std::string> & args,
+                        unsigned int threads) {
+    std::vector<parse_command> cmds;
+    for (auto && path : paths) {
+        cmds.push_back({path, args});
+    }
+
+    parse_source_files(mdl, cmds, threads);
+}
+
+
+parser_session::parser_session(code_model & mdl, const parse_options & opts):
+mdl_{mdl}, opts_{opts}, index_{::clang_createIndex(0, 1)},
+headers_{std::make_unique<converted_headers>()} {}
+
+
+parser_session::~parser_session() {
+    // converters use translation units, so they are destroyed first
+    for (auto && [path, conv] : converters_) {
+        conv->load_all();
+    }
+
+    converters_.clear();
+
+    for (auto && [path, tu] : tus_) {
+        ::clang_disposeTranslationUnit(tu);
+    }
+
+    ::clang_disposeIndex(index_);
+}
+
+
+void parser_session::parse(const std::filesystem::path & path,
+                           const std::vector<std::string> & args) {
+    // parsing source file again with new arguments
+    remove(path);
+
+    auto tu = parse_translation_unit(index_, path, make_c_args(args), tu_options());
+    tus_.emplace(path.string(), tu);
+
+    std::vector<std::string> updated;
+    update(path.string(), tu, updated);
+}
+
+
+void parser_session::reparse(const std::filesystem::path & path) {
+    if (!is_parsed(path)) {
+        std::ostringstream msg;
+        msg << "source file '" << path.string() << "' is not parsed";
+        throw std::runtime_error(msg.str());
+    }
+
+    // AST of translation unit is replaced by reparse
+    finish_conversion(path.string());
+
+    std::vector<std::string> updated;
+    reparse_tu(path.string(), updated);
+}
+
+
+void parser_session::remove(const std::filesystem::path & path) {
+    finish_conversion(path.string());
+    included_headers_.erase(path.string());
+
+    auto it = tus_.find(path.string());
+    if (it != tus_.end()) {
+        ::clang_disposeTranslationUnit(it->second);
+        tus_.erase(it);
+    }
+}
+
+
+void parser_session::reparse_tu(const std::string & path, std::vector<std::string> & updated) {
+    auto it = tus_.find(path);
+    assert(it != tus_.end() && "source file is not parsed");
+
+    auto tu = it->second;
+    auto err = ::clang_reparseTranslationUnit(tu,
+                                              0,            // number of unsaved files
+                                              nullptr,      // unsaved files
+                                              ::clang_defaultReparseOptions(tu));
+
+    // translation unit can't be used after reparse error
+    if (err != 0) {
+        ::clang_disposeTranslationUnit(tu);
+        tus_.erase(it);
+        included_headers_.erase(path);
+
+        std::ostringstream msg;
+        msg << "can't reparse source file '" << path << "'";
+        throw std::runtime_error(msg.str());
+    }
+
+    update(path, tu, updated);
+}
+
+
+void parser_session::update(const std::string & path,
+                            CXTranslationUnit tu,
+                            std::vector<std::string> & updated) {
+    updated.push_back(path);
+
+    // contents converted on demand by other translation units may refer to
+    // entities removed below, and headers converted with them are skipped by
+    // other converters, so their contents are converted before removing
+    for (auto && [tu_path, conv] : converters_) {
+        if (tu_path != path) {
+            conv->load_all();
+        }
+    }
+
+    // removing entities converted from previous version of source file.
+    // Entities of other source files using them are removed too
+    std::vector<const source_file*> removed;
+    if (auto src = mdl_.find_source(path)) {
+        removed = mdl_.remove_source_entities(src);
+    }
+
+    auto changed = convert(path, tu);
+    removed.insert(removed.end(), changed.begin(), changed.end());
+
+    // source files which entities were removed and source files including
+    // headers which entities were removed are converted again
+    std::vector<std::string> paths;
+    for (auto && [tu_path, headers] : included_headers_) {
+        bool affected = std::ranges::any_of(removed, [&](const source_file * src) {
+            return src == mdl_.find_source(tu_path) || std::ranges::find(headers, src) != headers.end();
+        });
+
+        if (affected && std::ranges::find(updated, tu_path) == updated.end()) {
+            paths.push_back(tu_path);
+        }
+    }
+
+    for (auto && tu_path : paths) {
+        // contents of affected translation unit are already converted,
+        // its converter refers to AST replaced by reparse
+        converters_.erase(tu_path);
+
+        if (std::ranges::find(updated, tu_path) == updated.end()) {
+            CM_CLANG_LOG_DEBUG << "reparsing source file with removed entities " << tu_path;
+            reparse_tu(tu_path, updated);
+        }
+    }
+}
+
+
+std::vector<const source_file*> parser_session::convert(const std::string & path,
+                                                         CXTranslationUnit tu) {
+    auto conv = std::make_unique<ast_converter>(mdl_, headers_.get(), opts_.lazy_conversion);
+    conv->convert(get_ast_context(tu));
+
+    included_headers_.insert_or_assign(path, conv->included_headers());
+    auto res = conv->removed_sources();
+
+    // lazy converter converts contents of translation unit on demand
+    if (opts_.lazy_conversion) {
+        converters_.insert_or_assign(path, std::move(conv));
+    }
+
+    return res;
+}
+
+
+void parser_session::finish_conversion(const std::string & path) {
+    auto it = converters_.find(path);
+    if (it != converters_.end()) {
+        it->second->load_all();
+        converters_.erase(it);
+    }
+}
+
+
+unsigned int parser_session::tu_options() const {
+    unsigned int res = 0;
+    if (opts_.precompiled_preamble) {
+        res |= CXTranslationUnit_PrecompiledPreamble | CXTranslationUnit_CreatePreambleOnFirstParse;
+    }
+
+    if (opts_.skip_function_bodies) {
+        res |= CXTranslationUnit_SkipFunctionBodies;
+    }
 
-    // removing clang index
-    ::clang_disposeIndex(clang_idx);
+    return res;
 }
 
 
@@ -0,0 +1,191 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file cmclangbatch.cpp
+/// Contains code for the cmclangbatch utility for parsing code model from
+/// all source files of compilation database.
+
+#include "pch.hpp"
+#include "cm/cxx/clang/cmclang.hpp"
+#include "cm/log/log_init.hpp"
+#include <clang-c/CXCompilationDatabase.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <boost/program_options.hpp>
+
+
+namespace fs = std::filesystem;
+namespace po = boost::program_options;
+
+
+/// Converts clang string to std::string and disposes clang string
+static std::string take_string(CXString str) {
+    std::string res = ::clang_getCString(str);
+    ::clang_disposeString(str);
+    return res;
+}
+
+
+/// Reads commands for parsing source files from compilation database in
+/// specified build directory. Removes compiler name, source file name,
+/// output and dependency file options from command lines, adds working
+/// directory of command. Skips duplicate commands for the same source file
+/// with the same arguments.
+static std::vector<cm::clang::parse_command> read_compile_commands(const fs::path & build_dir) {
+    CXCompilationDatabase_Error db_err;
+    auto db = ::clang_CompilationDatabase_fromDirectory(build_dir.string().c_str(), &db_err);
+    if (db_err != CXCompilationDatabase_NoError) {
+        std::ostringstream msg;
+        msg << "can't load compilation database from " << build_dir;
+        throw std::runtime_error{msg.str()};
+    }
+
+    std::vector<cm::clang::parse_command> res;
+    std::set<std::pair<fs::path, std::vector<std::string>>> parsed;
+
+    auto db_cmds = ::clang_CompilationDatabase_getAllCompileCommands(db);
+    auto num_cmds = ::clang_CompileCommands_getSize(db_cmds);
+    for (unsigned int i = 0; i < num_cmds; ++i) {
+        auto db_cmd = ::clang_CompileCommands_getCommand(db_cmds, i);
+        fs::path dir = take_string(::clang_CompileCommand_getDirectory(db_cmd));
+        fs::path file = take_string(::clang_CompileCommand_getFilename(db_cmd));
+
+        std::vector<std::string> cmd_line;
+        auto num_args = ::clang_CompileCommand_getNumArgs(db_cmd);
+        for (unsigned int j = 0; j < num_args; ++j) {
+            cmd_line.push_back(take_string(::clang_CompileCommand_getArg(db_cmd, j)));
+        }
+
+        auto cmd = cm::clang::make_parse_command(dir, file, cmd_line);
+        if (parsed.emplace(cmd.path, cmd.args).second) {
+            res.push_back(std::move(cmd));
+        }
+    }
+
+    ::clang_CompileCommands_dispose(db_cmds);
+    ::clang_CompilationDatabase_dispose(db);
+
+    return res;
+}
+
+
+/// Prints times of parsing and converting source files and numbers of
+/// converted and skipped declarations starting from the slowest source files
+static void print_timings(std::ostream & str, std::vector<cm::clang::parse_timing> timings) {
+    auto total_ms = [](auto && t) { return t.parse_ms + t.convert_ms; };
+    std::ranges::sort(timings, [&](auto && t1, auto && t2) { return total_ms(t1) > total_ms(t2); });
+
+    double parse_ms = 0;
+    double convert_ms = 0;
+    std::size_t converted_decls = 0;
+    std::size_t skipped_decls = 0;
+
+    str << std::setw(12) << "parse ms" << std::setw(12) << "convert ms"
+        << std::setw(12) << "decls" << std::setw(12) << "skipped" << "  source file" << std::endl;
+    str << std::fixed << std::setprecision(2);
+    for (auto && t : timings) {
+        str << std::setw(12) << t.parse_ms << std::setw(12) << t.convert_ms
+            << std::setw(12) << t.converted_decls << std::setw(12) << t.skipped_decls
+            << "  " << t.path.string() << std::endl;
+        parse_ms += t.parse_ms;
+        convert_ms += t.convert_ms;
+        converted_decls += t.converted_decls;
+        skipped_decls += t.skipped_decls;
+    }
+
+    str << std::setw(12) << parse_ms << std::setw(12) << convert_ms
+        << std::setw(12) << converted_decls << std::setw(12) << skipped_decls << "  total" << std::endl;
+}
+
+
+int main(int argc, char * argv[]) {
+    try {
+        po::options_description opt_desc("Common options");
+        opt_desc.add_options()
+            ("help", "produce help message and exit")
+            ("build-dir,p", po::value<fs::path>(), "build directory containing compile_commands.json")
+            ("output,o", po::value<fs::path>(), "write dump of code model to file instead of stdout")
+            ("threads,j", po::value<unsigned int>()->default_value(0),
+             "number of parsing threads, 0 for number of hardware threads")
+            ("timings", "print times of parsing and converting source files to stderr")
+            ("dump-builtins", "dump builtins")
+            ("dump-locations", "dump definition locations");
+
+        opt_desc.add(cm::log::log_options());
+
+        po::positional_options_description pos_opt_desc;
+        pos_opt_desc.add("build-dir", 1);
+
+        po::variables_map var_map;
+        po::store(
+            po::command_line_parser(argc, argv).options(opt_desc).positional(pos_opt_desc).run(),
+            var_map);
+
+        // checking for help option
+        if (var_map.count("help") > 0) {
+            opt_desc.print(std::cout);
+            return 1;
+        }
+
+        // checking that build directory is specified in command line
+        if (var_map.count("build-dir") == 0) {
+            throw std::runtime_error("no build directory specified in command line");
+        }
+
+        // configuring log
+        cm::log::log_init(var_map);
+
+        auto cmds = read_compile_commands(var_map["build-dir"].as<fs::path>());
+
+        // creating and parsing code model
+        cm::code_model mdl;
+        std::vector<cm::clang::parse_timing> timings;
+        auto start = std::chrono::steady_clock::now();
+        cm::clang::parse_source_files(mdl, cmds, var_map["threads"].as<unsigned int>(), &timings);
+        std::chrono::duration<double, std::milli> wall_ms = std::chrono::steady_clock::now() - start;
+
+        if (var_map.count("timings") != 0) {
+            print_timings(std::cerr, std::move(timings));
+            std::cerr << "parsed " << cmds.size() << " source files in "
+                      << wall_ms.count() << " ms" << std::endl;
+        }
+
+        cm::dump_options dump_opts;
+        dump_opts.builtins = var_map.count("dump-builtins") > 0;
+        dump_opts.locations = var_map.count("dump-locations") > 0;
+
+        if (var_map.count("output") != 0) {
+            // dumping code model to file
+            auto out_path = var_map["output"].as<fs::path>();
+            std::ofstream out{out_path};
+            if (!out.is_open()) {
+                std::ostringstream msg;
+                msg << "can't open output file " << out_path;
+                throw std::runtime_error{msg.str()};
+            }
+
+            mdl.dump(out, dump_opts);
+        } else {
+            // dumping code model to stdout
+            mdl.dump(std::cout, dump_opts);
+        }
+    }
+    catch (std::exception & err) {
+        std::cerr << "ERROR: " << err.what() << std::endl;
+        return 2;
+    }
+    catch (...) {
+        std::cerr << "ERROR: unknown error" << std::endl;
+        return 2;
+    }
+
+    return 0;
+}
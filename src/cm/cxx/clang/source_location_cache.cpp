@@ -0,0 +1,95 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file source_location_cache.cpp
+/// Contains implementation of the source_location_cache class.
+
+#include "cm/cxx/clang/source_location_cache.hpp"
+#include <string_view>
+
+
+namespace cm::clang {
+
+
+decoded_source_location source_location_cache::presumed(::clang::SourceLocation loc) {
+    if (loc.isInvalid()) {
+        return {};
+    }
+
+    // locations in macro expansions are converted to expansion locations
+    // like presumed locations
+    auto [fid, offset] = sm_->getDecomposedExpansionLoc(loc);
+    if (fid.isInvalid()) {
+        return {};
+    }
+
+    if (fid != last_fid_ || !last_file_) {
+        last_file_ = &info(fid);
+        last_fid_ = fid;
+    }
+
+    auto & f = *last_file_;
+    if (f.line_directives) [[unlikely]] {
+        return convert_presumed(loc);
+    }
+
+    if (!f.has_lines) {
+        bool invalid = false;
+        auto data = sm_->getBufferData(fid, &invalid);
+        if (invalid) {
+            return convert_presumed(loc);
+        }
+
+        f.lines = line_table{std::string_view{data.data(), data.size()}};
+        f.has_lines = true;
+    }
+
+    auto [line, col] = f.lines.position(offset);
+    return {f.presumed, line, col};
+}
+
+
+const source_file * source_location_cache::file(::clang::FileID fid) {
+    if (fid.isInvalid()) {
+        return nullptr;
+    }
+
+    return info(fid).file;
+}
+
+
+source_location_cache::file_info & source_location_cache::info(::clang::FileID fid) {
+    assert(sm_ && "no source manager in source location cache");
+
+    auto [it, inserted] = files_.try_emplace(fid.getHashValue());
+    auto & f = it->second;
+    if (inserted) {
+        if (auto entry = sm_->getFileEntryRefForID(fid)) {
+            f.file = mdl_.source(std::string_view{entry->getName()});
+            f.presumed = f.file;
+        } else {
+            auto name = sm_->getBufferName(sm_->getLocForStartOfFile(fid));
+            f.presumed = mdl_.source(std::string_view{name});
+        }
+
+        f.line_directives = sm_->getSLocEntry(fid).getFile().hasLineDirectives();
+    }
+
+    return f;
+}
+
+
+decoded_source_location source_location_cache::convert_presumed(::clang::SourceLocation loc) {
+    auto ploc = sm_->getPresumedLoc(loc);
+    if (!ploc.isValid()) {
+        return {};
+    }
+
+    return {mdl_.source(ploc.getFilename()), ploc.getLine(), ploc.getColumn()};
+}
+
+
+}
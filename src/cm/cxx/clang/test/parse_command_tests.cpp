@@ -0,0 +1,55 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file parse_command_tests.cpp
+/// Contains unit tests for making parse commands from compile commands
+
+#include "cm/cxx/clang/cmclang.hpp"
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+
+
+namespace cm::clang::test {
+
+
+BOOST_AUTO_TEST_SUITE(parse_command_tests)
+
+
+/// Tests removing compiler name, source file and output options
+BOOST_AUTO_TEST_CASE(output_options) {
+    auto cmd = make_parse_command("/build", "../src/a.cpp",
+                                  {"/usr/bin/c++", "-DA=1", "-o", "a.o", "-c", "../src/a.cpp"});
+
+    BOOST_CHECK(cmd.path == "/src/a.cpp");
+    std::vector<std::string> expected{"-working-directory", "/build", "-DA=1"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(cmd.args.begin(), cmd.args.end(), expected.begin(), expected.end());
+
+    // joined output file and source file with absolute path
+    cmd = make_parse_command("/build", "/src/a.cpp",
+                             {"c++", "-oa.o", "-I/inc", "/src/a.cpp", "-objcmt-migrate-literals"});
+
+    expected = {"-working-directory", "/build", "-I/inc", "-objcmt-migrate-literals"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(cmd.args.begin(), cmd.args.end(), expected.begin(), expected.end());
+}
+
+
+/// Tests removing options of dependency files
+BOOST_AUTO_TEST_CASE(dependency_options) {
+    auto cmd = make_parse_command("/build", "a.cpp",
+                                  {"c++", "-MD", "-MT", "a.o", "-MF", "a.o.d", "-std=c++20",
+                                   "-MMD", "-MP", "-MFb.d", "-MTb.o", "-MQ", "c.o", "-c", "a.cpp"});
+
+    BOOST_CHECK(cmd.path == "/build/a.cpp");
+    std::vector<std::string> expected{"-working-directory", "/build", "-std=c++20"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(cmd.args.begin(), cmd.args.end(), expected.begin(), expected.end());
+}
+
+
+BOOST_AUTO_TEST_SUITE_END();
+
+
+}
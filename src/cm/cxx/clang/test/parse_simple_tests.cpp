@@ -11,6 +11,7 @@
 #include "cm/cxx/clang/cmclang.hpp"
 #include <boost/test/unit_test.hpp>
 #include <ranges>
+#include <sstream>
 
 
 namespace fs = std::filesystem;
@@ -56,6 +57,244 @@ BOOST_AUTO_TEST_CASE(var) {
 }
 
 
+/// Tests parsing multiple source files in parallel
+BOOST_AUTO_TEST_CASE(multiple_files) {
+    parse_source_files(mdl, {test_src_path() / "func.cpp", test_src_path() / "var.cpp"}, {}, 2);
+
+    BOOST_CHECK(dynamic_cast<named_function*>(mdl.find_named_entity("foo")));
+    BOOST_CHECK(mdl.find_var("my_var"));
+
+    BOOST_CHECK_THROW(parse_source_files(mdl, {test_src_path() / "missing.cpp"}, {}, 2),
+                      std::runtime_error);
+}
+
+
+/// Tests skipping declarations from header included by multiple source files
+BOOST_AUTO_TEST_CASE(multiple_files_common_header) {
+    std::vector<std::string> args{"-include", (test_src_path() / "common_header.hpp").string()};
+    std::vector<parse_command> cmds{{test_src_path() / "func.cpp", args},
+                                    {test_src_path() / "common_header_use.cpp", args}};
+
+    std::vector<parse_timing> timings;
+    parse_source_files(mdl, cmds, 2, &timings);
+
+    BOOST_REQUIRE_EQUAL(timings.size(), 2);
+    BOOST_CHECK_EQUAL(timings[0].skipped_decls, 0);
+    BOOST_CHECK_EQUAL(timings[1].skipped_decls, 3);
+    BOOST_CHECK(mdl.find_function("common_func"));
+    BOOST_CHECK(mdl.find_var("common_var"));
+
+    // entities from header are converted once
+    BOOST_CHECK_EQUAL(std::ranges::distance(mdl.named_records()), 1);
+    BOOST_CHECK_EQUAL(std::ranges::distance(mdl.typedefs()), 1);
+
+    // declarations of common_header_use.cpp use entities converted with func.cpp
+    auto rec = mdl.find_named_record("common_rec");
+    BOOST_REQUIRE(rec);
+    auto td = mdl.find_typedef("common_int");
+    BOOST_REQUIRE(td);
+
+    auto fn = mdl.find_function("common_rec_x");
+    BOOST_REQUIRE(fn);
+    BOOST_CHECK(fn->ret_type().type() == td);
+
+    auto params = fn->params();
+    BOOST_REQUIRE_EQUAL(std::ranges::distance(params), 1);
+    auto par_type = entity_cast<pointer_type>((*std::ranges::begin(params))->type().type());
+    BOOST_REQUIRE(par_type);
+    BOOST_CHECK(par_type->base().type() == rec);
+}
+
+
+/// Tests resolving partial specializations from header included by
+/// multiple source files
+BOOST_AUTO_TEST_CASE(multiple_files_partial_specialization) {
+    auto dir = fs::temp_directory_path() / "cm_multiple_files_partial_specialization";
+    fs::create_directories(dir);
+
+    std::ofstream{dir / "hdr.hpp"} << "template <typename T, typename U> struct pair_rec { int size(); };\n"
+                                      "template <typename T> struct pair_rec<T, int> { int size(); };\n"
+                                      "template <typename T> struct pair_rec<T *, int> { int size(); };\n";
+    std::ofstream{dir / "a.cpp"} << "#include \"hdr.hpp\"\n";
+    std::ofstream{dir / "b.cpp"} << "#include \"hdr.hpp\"\n"
+                                    "template <typename T> int pair_rec<T *, int>::size() { return 0; }\n";
+
+    std::vector<parse_command> cmds{{dir / "a.cpp", {}}, {dir / "b.cpp", {}}};
+    std::vector<parse_timing> timings;
+    parse_source_files(mdl, cmds, 2, &timings);
+
+    BOOST_REQUIRE_EQUAL(timings.size(), 2);
+    BOOST_CHECK_EQUAL(timings[1].skipped_decls, 3);
+
+    // method defined in b.cpp belongs to partial specialization converted
+    // with a.cpp, partial specializations are not duplicated
+    auto specs = mdl.entities<template_record_partial_specialization>();
+    BOOST_REQUIRE_EQUAL(std::ranges::distance(specs), 2);
+    for (auto && spec : specs) {
+        BOOST_CHECK_EQUAL(std::ranges::distance(spec->functions()), 1);
+    }
+
+    BOOST_CHECK_EQUAL(std::ranges::distance(mdl.functions()), 0);
+
+    fs::remove_all(dir);
+}
+
+
+/// Tests parsing and reparsing source file in parser session
+BOOST_AUTO_TEST_CASE(session_reparse) {
+    parser_session session{mdl, {.precompiled_preamble = true, .skip_function_bodies = true}};
+    auto path = test_src_path() / "common_header_use.cpp";
+
+    // entities of source file and included header exist once after each parse
+    auto check_entities = [&]() {
+        BOOST_CHECK_EQUAL(std::ranges::distance(mdl.named_records()), 1);
+        BOOST_CHECK_EQUAL(std::ranges::distance(mdl.typedefs()), 1);
+        BOOST_CHECK_EQUAL(std::ranges::distance(mdl.named_functions()), 2);
+        BOOST_CHECK_EQUAL(std::ranges::distance(mdl.vars()), 1);
+
+        auto rec = mdl.find_named_record("common_rec");
+        auto fn = mdl.find_function("common_rec_x");
+        BOOST_REQUIRE(rec);
+        BOOST_REQUIRE(fn);
+
+        auto params = fn->params();
+        BOOST_REQUIRE_EQUAL(std::ranges::distance(params), 1);
+        auto par_type = entity_cast<pointer_type>((*std::ranges::begin(params))->type().type());
+        BOOST_REQUIRE(par_type);
+        BOOST_CHECK(par_type->base().type() == rec);
+    };
+
+    BOOST_CHECK_THROW(session.reparse(path), std::runtime_error);
+
+    session.parse(path, {});
+    BOOST_CHECK(session.is_parsed(path));
+    check_entities();
+
+    session.reparse(path);
+    check_entities();
+
+    session.parse(path, {});
+    check_entities();
+
+    session.remove(path);
+    BOOST_CHECK(!session.is_parsed(path));
+}
+
+
+/// Tests reparsing source file after change of header included by other
+/// source file
+BOOST_AUTO_TEST_CASE(session_changed_header) {
+    auto dir = fs::temp_directory_path() / "cm_session_changed_header";
+    fs::create_directories(dir);
+
+    std::ofstream{dir / "hdr.hpp"} << "struct rec { int x; };\n";
+    std::ofstream{dir / "a.cpp"} << "#include \"hdr.hpp\"\nrec * a_var;\n";
+    std::ofstream{dir / "b.cpp"} << "#include \"hdr.hpp\"\nrec * b_var;\n";
+
+    parser_session session{mdl};
+    session.parse(dir / "a.cpp", {});
+    session.parse(dir / "b.cpp", {});
+
+    auto rec = mdl.find_named_record("rec");
+    BOOST_REQUIRE(rec);
+    BOOST_CHECK_EQUAL(std::ranges::distance(rec->fields()), 1);
+
+    // variable of b.cpp is removed with record of changed header, so b.cpp
+    // is reparsed with a.cpp
+    std::ofstream{dir / "hdr.hpp"} << "struct rec { int x; int y; };\n";
+    session.reparse(dir / "a.cpp");
+
+    BOOST_CHECK_EQUAL(std::ranges::distance(mdl.named_records()), 1);
+    rec = mdl.find_named_record("rec");
+    BOOST_REQUIRE(rec);
+    BOOST_CHECK_EQUAL(std::ranges::distance(rec->fields()), 2);
+
+    for (auto && name : {"a_var", "b_var"}) {
+        auto var = mdl.find_var(name);
+        BOOST_REQUIRE(var);
+        auto var_type = entity_cast<pointer_type>(var->type().type());
+        BOOST_REQUIRE(var_type);
+        BOOST_CHECK(var_type->base().type() == rec);
+    }
+
+    fs::remove_all(dir);
+}
+
+
+/// Tests converting contents of records and functions on demand
+BOOST_AUTO_TEST_CASE(session_lazy_conversion) {
+    parser_session session{mdl, {.lazy_conversion = true}};
+    auto path = test_src_path() / "template_class_specialization.cpp";
+    session.parse(path, {});
+
+    auto rtype = mdl.find_template_record("str");
+    BOOST_REQUIRE(rtype);
+    BOOST_CHECK(!rtype->is_loaded());
+
+    // contents are converted on first access
+    auto func = rtype->find_function("foo");
+    BOOST_REQUIRE(func);
+    BOOST_CHECK(rtype->is_loaded());
+    BOOST_CHECK(!func->is_loaded());
+    BOOST_CHECK_EQUAL(std::ranges::distance(func->params()), 2);
+    BOOST_CHECK(func->is_loaded());
+
+    // code model converted on demand is the same as converted eagerly
+    code_model eager_mdl;
+    parse_source_file(eager_mdl, path, {});
+
+    std::ostringstream str;
+    mdl.dump(str);
+    std::ostringstream eager_str;
+    eager_mdl.dump(eager_str);
+    BOOST_CHECK_EQUAL(str.str(), eager_str.str());
+}
+
+
+/// Tests reparsing source file with changed header while contents of
+/// header converted with other source file are not converted yet
+BOOST_AUTO_TEST_CASE(session_lazy_changed_header) {
+    auto dir = fs::temp_directory_path() / "cm_session_lazy_changed_header";
+    fs::create_directories(dir);
+
+    std::ofstream{dir / "hdr.hpp"} << "struct rec { int x; };\n";
+    std::ofstream{dir / "lazy.hpp"} << "struct lazy_rec { int x; int y; };\n";
+    std::ofstream{dir / "a.cpp"} << "#include \"hdr.hpp\"\nrec * a_var;\n";
+    std::ofstream{dir / "b.cpp"} << "#include \"hdr.hpp\"\n#include \"lazy.hpp\"\n"
+                                    "rec * b_var;\nlazy_rec * b_lazy_var;\n";
+
+    parser_session session{mdl, {.lazy_conversion = true}};
+    session.parse(dir / "a.cpp", {});
+    session.parse(dir / "b.cpp", {});
+
+    auto lazy_rec = mdl.find_named_record("lazy_rec");
+    BOOST_REQUIRE(lazy_rec);
+    BOOST_CHECK(!lazy_rec->is_loaded());
+
+    // b.cpp is reparsed with a.cpp because its variable is removed with
+    // record of changed header. Contents of lazy.hpp converted with previous
+    // translation unit of b.cpp are not lost, lazy.hpp is not converted again
+    std::ofstream{dir / "hdr.hpp"} << "struct rec { int x; int y; };\n";
+    session.reparse(dir / "a.cpp");
+
+    BOOST_CHECK_EQUAL(std::ranges::distance(mdl.named_records()), 2);
+    BOOST_CHECK(mdl.find_named_record("lazy_rec") == lazy_rec);
+    BOOST_CHECK_EQUAL(std::ranges::distance(lazy_rec->fields()), 2);
+
+    auto rec = mdl.find_named_record("rec");
+    BOOST_REQUIRE(rec);
+    BOOST_CHECK_EQUAL(std::ranges::distance(rec->fields()), 2);
+
+    auto var = mdl.find_var("b_lazy_var");
+    BOOST_REQUIRE(var);
+    auto var_type = entity_cast<pointer_type>(var->type().type());
+    BOOST_REQUIRE(var_type);
+    BOOST_CHECK(var_type->base().type() == lazy_rec);
+
+    fs::remove_all(dir);
+}
+
+
 /// Tests parsing namespace
 BOOST_AUTO_TEST_CASE(parse_namespace) {
     parse_source_file(mdl, test_src_path() / "namespace.cpp", {});
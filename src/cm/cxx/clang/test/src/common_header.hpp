@@ -0,0 +1,12 @@
+// Header included into multiple source files in tests for parsing
+// multiple source files
+
+#pragma once
+
+struct common_rec {
+    int x;
+};
+
+int common_func(common_rec * rec);
+
+typedef int common_int;
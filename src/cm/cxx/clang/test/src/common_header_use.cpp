@@ -0,0 +1,9 @@
+
+// Test for parsing declarations using entities of header included by
+// multiple source files
+
+#include "common_header.hpp"
+
+const int common_var = 10;
+
+common_int common_rec_x(common_rec * rec);
@@ -42,15 +42,15 @@ void print_template_instantiation_name(std::ostream & str, const template_instan
             first = false;
         }
 
-        if (auto type_arg = dynamic_cast<const type_template_argument*>(arg)) {
+        if (auto type_arg = entity_cast<const type_template_argument>(arg)) {
             print_type(str, type_arg->type());
 
-            if (dynamic_cast<const template_instantiation*>(type_arg->type().type())) {
+            if (entity_cast<const template_instantiation>(type_arg->type().type())) {
                 last_rangle = true;
             } else {
                 last_rangle = false;
             }
-        } else if (auto val_arg = dynamic_cast<const value_template_argument*>(arg)) {
+        } else if (auto val_arg = entity_cast<const value_template_argument>(arg)) {
             str << val_arg->val().str();
         } else {
             assert(false && "unknown template argument type");
@@ -76,19 +76,19 @@ static void print_context_entity_name(std::ostream & str, const context_entity *
     }
 
     // printing named context entity
-    if (auto n_ent = dynamic_cast<const named_entity*>(ent)) {
+    if (auto n_ent = entity_cast<const named_entity>(ent)) {
         str << n_ent->name();
         return;
     }
 
     // printing template instantiation entity
-    if (auto t_inst = dynamic_cast<const template_instantiation*>(ent)) {
+    if (auto t_inst = entity_cast<const template_instantiation>(ent)) {
         print_template_instantiation_name(str, t_inst);
         return;
     }
 
     // printing anonymous record entity
-    if (auto rec = dynamic_cast<const record_type*>(ent)) {
+    if (auto rec = entity_cast<const record_type>(ent)) {
         str << "(anonymous record)";
         return;
     }
@@ -99,22 +99,22 @@ static void print_context_entity_name(std::ostream & str, const context_entity *
 
 /// Prints type declaration result
 static void print_type_decl_result(std::ostream & str, const type_t * t) {
-    if (auto a_t = dynamic_cast<const array_type*>(t)) {
+    if (auto a_t = entity_cast<const array_type>(t)) {
         print_type_decl_result(str, a_t->base());
-    } else if (auto v_t = dynamic_cast<const vector_type*>(t)) {
+    } else if (auto v_t = entity_cast<const vector_type>(t)) {
         print_type_decl_result(str, v_t->base());
         str << " __attribute__((vector_size(" << v_t->size() << ")))";
-    } else if (auto b_t = dynamic_cast<const builtin_type*>(t)) {
+    } else if (auto b_t = entity_cast<const builtin_type>(t)) {
         str << b_t->name();
-    } else if (auto f_t = dynamic_cast<const function_type*>(t)) {
+    } else if (auto f_t = entity_cast<const function_type>(t)) {
         print_qual_type_decl_result(str, f_t->ret_type());
-    } else if (auto m_t = dynamic_cast<const mem_ptr_type*>(t)) {
+    } else if (auto m_t = entity_cast<const mem_ptr_type>(t)) {
         print_qual_type_decl_result(str, m_t->mem_type());
-    } else if (auto p_t = dynamic_cast<const ptr_or_ref_type*>(t)) {
+    } else if (auto p_t = entity_cast<const ptr_or_ref_type>(t)) {
         print_qual_type_decl_result(str, p_t->base());
-    } else if (auto t_t_p = dynamic_cast<const type_template_parameter*>(t)) {
+    } else if (auto t_t_p = entity_cast<const type_template_parameter>(t)) {
         str << t_t_p->name();
-    } else if (const context_type * c_t = dynamic_cast<const context_type*>(t)) {
+    } else if (const context_type * c_t = entity_cast<const context_type>(t)) {
         print_context_entity_name(str, c_t, true);
     } else {
         assert(false && "uknown type for printing decl result");
@@ -124,16 +124,16 @@ static void print_type_decl_result(std::ostream & str, const type_t * t) {
 
 /// Prints type declaration prefix
 static void print_type_decl_prefix(std::ostream & str, const type_t * t, bool end_sp) {
-    if (dynamic_cast<const builtin_type*>(t)) {
+    if (entity_cast<const builtin_type>(t)) {
         // doing nothing for builtin type name execpt of writing space if asked
         if (end_sp) {
             str << ' ';
         }
-    } else if (auto a_t = dynamic_cast<const array_or_vector_type*>(t)) {
+    } else if (auto a_t = entity_cast<const array_or_vector_type>(t)) {
         print_type_decl_prefix(str, a_t->base(), end_sp);
-    } else if (auto f_t = dynamic_cast<const function_type*>(t)) {
+    } else if (auto f_t = entity_cast<const function_type>(t)) {
         print_qual_type_decl_prefix(str, f_t->ret_type(), end_sp);
-    } else if (auto m_t = dynamic_cast<const mem_ptr_type*>(t)) {
+    } else if (auto m_t = entity_cast<const mem_ptr_type>(t)) {
         print_qual_type_decl_prefix(str, m_t->mem_type(), false);
 
         // writing ( parens if child is suffix op
@@ -145,7 +145,7 @@ static void print_type_decl_prefix(std::ostream & str, const type_t * t, bool en
 
         print_type(str, m_t->obj_type());
         str << "::*";
-    } else if (auto p_t = dynamic_cast<const ptr_or_ref_type*>(t)) {
+    } else if (auto p_t = entity_cast<const ptr_or_ref_type>(t)) {
         print_qual_type_decl_prefix(str, p_t->base(), false);
 
         // writing ( parens if child is suffix op
@@ -154,11 +154,11 @@ static void print_type_decl_prefix(std::ostream & str, const type_t * t, bool en
         }
         
         str << (p_t->is_ref() ? '&' : '*');
-    } else if(dynamic_cast<const record_type*>(t)) {
+    } else if(entity_cast<const record_type>(t)) {
         // nothing to do here
-    } else if (dynamic_cast<const typedef_type*>(t)) {
+    } else if (entity_cast<const typedef_type>(t)) {
         // nothing to do here
-    } else if (dynamic_cast<const enum_type*>(t)) {
+    } else if (entity_cast<const enum_type>(t)) {
         // nothing to do here
     } else {
         assert(false && "don't know how to print type decl prefix");
@@ -168,9 +168,9 @@ static void print_type_decl_prefix(std::ostream & str, const type_t * t, bool en
 
 /// Prints type declartion suffix
 static void print_type_decl_suffix(std::ostream & str, const type_t * t, bool p_s) {
-    if (dynamic_cast<const builtin_type*>(t)) {
+    if (entity_cast<const builtin_type>(t)) {
         // nothing to do here
-    } else if (auto a_t = dynamic_cast<const array_type*>(t)) {
+    } else if (auto a_t = entity_cast<const array_type>(t)) {
         // printing space before array size if parent op did not write suffix
         if (!p_s)
             str << ' ';
@@ -189,10 +189,10 @@ static void print_type_decl_suffix(std::ostream & str, const type_t * t, bool p_
 
         // printing element suffix
         print_type_decl_suffix(str, a_t->base(), true);
-    } else if (auto v_t = dynamic_cast<const vector_type*>(t)) {
+    } else if (auto v_t = entity_cast<const vector_type>(t)) {
         // printing element suffix
         print_type_decl_suffix(str, v_t->base(), true);
-    } else if (auto f_t = dynamic_cast<const function_type*>(t)) {
+    } else if (auto f_t = entity_cast<const function_type>(t)) {
         str << '(';
         bool first = true;
         for (const auto & p : f_t->params()) {
@@ -207,7 +207,7 @@ static void print_type_decl_suffix(std::ostream & str, const type_t * t, bool p_
         str << ')';
 
         print_qual_type_decl_suffix(str, f_t->ret_type(), true);
-    } else if (auto p_t = dynamic_cast<const ptr_or_ref_type*>(t)) {
+    } else if (auto p_t = entity_cast<const ptr_or_ref_type>(t)) {
         // writing ) parens if child is suffix op
         bool suf = false;
         if (p_t->base().cast<array_type>() || p_t->base().cast<function_type>()) {
@@ -216,7 +216,7 @@ static void print_type_decl_suffix(std::ostream & str, const type_t * t, bool p_
         }
 
         print_qual_type_decl_suffix(str, p_t->base(), suf);
-    } else if (auto m_t = dynamic_cast<const mem_ptr_type*>(t)) {
+    } else if (auto m_t = entity_cast<const mem_ptr_type>(t)) {
         // writing ) parens if child is suffix op
         bool suf = m_t->mem_type().cast<array_type>() || m_t->mem_type().cast<function_type>();
         if (suf) {
@@ -224,11 +224,11 @@ static void print_type_decl_suffix(std::ostream & str, const type_t * t, bool p_
         }
 
         print_qual_type_decl_suffix(str, m_t->mem_type(), suf);
-    } else if (dynamic_cast<const record_type*>(t)) {
+    } else if (entity_cast<const record_type>(t)) {
         // nothing to do here
-    } else if (dynamic_cast<const typedef_type*>(t)) {
+    } else if (entity_cast<const typedef_type>(t)) {
         // nothing to do here
-    } else if (dynamic_cast<const enum_type*>(t)) {
+    } else if (entity_cast<const enum_type>(t)) {
         // nothing to do here
     } else {
         assert(false && "don't know how to print type suffix");
@@ -397,15 +397,15 @@ static void print_named_function_parameter(std::ostream & str,
 
 
 void print_entity(std::ostream & str, const entity * ent, bool full_name) {
-    if (auto func = dynamic_cast<const function*>(ent)) {
+    if (auto func = entity_cast<const function>(ent)) {
         print_function(str, func, full_name);
-    } else if (auto var = dynamic_cast<const variable*>(ent)) {
+    } else if (auto var = entity_cast<const variable>(ent)) {
         print_variable(str, var, full_name);
-    } else if (auto templ = dynamic_cast<const templated_entity*>(ent)) {
+    } else if (auto templ = entity_cast<const templated_entity>(ent)) {
         print_context_entity_name(str, templ, full_name);
-    } else if (auto n_par = dynamic_cast<const named_function_parameter*>(ent)) {
+    } else if (auto n_par = entity_cast<const named_function_parameter>(ent)) {
         print_named_function_parameter(str, n_par);
-    } else if (auto par = dynamic_cast<const function_parameter*>(ent)) {
+    } else if (auto par = entity_cast<const function_parameter>(ent)) {
         // unnamed function parameter
         print_type(str, par->type());
     } else {
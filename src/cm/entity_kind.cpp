@@ -0,0 +1,128 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file entity_kind.cpp
+/// Contains compile time checks of sets of entity kinds.
+
+#include "pch.hpp"
+#include "cm/code_model.hpp"
+#include <concepts>
+
+
+namespace cm {
+namespace {
+
+
+/// List of entity classes
+template <typename ... Classes>
+struct class_list {};
+
+
+/// List of concrete entity classes in order of entity kinds
+using concrete_classes = class_list<
+    builtin_type,
+    function_type,
+    mem_ptr_type,
+    pointer_type,
+    lvalue_reference_type,
+    rvalue_reference_type,
+    array_type,
+    vector_type,
+    decltype_type,
+    dependent_type,
+    typedef_type,
+    enum_type,
+    record_type,
+    named_record_type,
+    template_record_type,
+    template_record_instantiation_type,
+    template_record_specialization_type,
+    template_record_dependent_instantiation_type,
+    type_template_parameter,
+    value_template_parameter,
+    variable,
+    field,
+    static_record_variable,
+    function_parameter,
+    named_function_parameter,
+    named_function,
+    named_method,
+    template_function,
+    template_method,
+    template_function_instantiation,
+    template_method_instantiation,
+    template_record,
+    template_record_partial_specialization,
+    type_template_argument,
+    value_template_argument,
+    namespace_,
+    code_model
+>;
+
+
+/// Returns number of classes in list
+template <typename ... Classes>
+constexpr unsigned int class_count(class_list<Classes...>) {
+    return sizeof...(Classes);
+}
+
+
+/// Checks that set of kinds of class T contains kinds of exactly those
+/// concrete classes that are derived from T
+template <typename T, typename ... Concrete>
+constexpr bool check_kinds(class_list<Concrete...>) {
+    if (!entity_kind_traits<T>::has_kinds) {
+        return false;
+    }
+
+    unsigned int knd = 0;
+    return ((entity_kind_traits<T>::kinds.contains(static_cast<entity_kind>(++knd)) ==
+             std::derived_from<Concrete, T>) && ...);
+}
+
+
+/// Checks sets of kinds of all specified classes
+template <typename ... Classes>
+constexpr bool check_all_kinds(class_list<Classes...>) {
+    return (check_kinds<Classes>(concrete_classes{}) && ...);
+}
+
+
+static_assert(class_count(concrete_classes{}) == static_cast<unsigned int>(entity_kind::last_),
+              "list of concrete classes does not match entity kinds");
+
+static_assert(check_all_kinds(concrete_classes{}),
+              "invalid set of kinds of concrete entity class");
+
+static_assert(check_all_kinds(class_list<type_t,
+                                         ptr_or_ref_type,
+                                         array_or_vector_type,
+                                         context_type,
+                                         named_type,
+                                         context_entity,
+                                         named_entity,
+                                         named_context_entity,
+                                         context,
+                                         record,
+                                         single_type_use,
+                                         function,
+                                         method,
+                                         static_record_function,
+                                         template_name,
+                                         template_,
+                                         templated_entity,
+                                         template_parameter,
+                                         template_argument,
+                                         template_substitution,
+                                         template_instantiation,
+                                         template_specialization,
+                                         template_dependent_instantiation,
+                                         template_record_substitution>{}),
+              "invalid set of kinds of abstract entity class");
+
+
+}
+}
@@ -31,17 +31,22 @@ const function * function_parameter::func() const {
 
 
 named_function_parameter::named_function_parameter(function * f, const std::string & nm, const qual_type & t):
-function_parameter{f, t}, single_type_use{t}, name_{nm} {
+function_parameter{f, t}, single_type_use{t}, name_{f->names().intern(nm)} {
+}
+
+
+void named_function_parameter::set_name(std::string_view str) {
+    name_ = func()->names().intern(str);
 }
 
 
 void function::add_param(const qual_type & t) {
-    params_.push_back(std::make_unique<function_parameter>(this, t));
+    params_.push_back(make_entity<function_parameter>(entity_resource(), this, t));
 }
 
 
 void function::add_param(const std::string & name, const qual_type & t) {
-    params_.push_back(std::make_unique<named_function_parameter>(this, name, t));
+    params_.push_back(make_entity<named_function_parameter>(entity_resource(), this, name, t));
 }
 
 
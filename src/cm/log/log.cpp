@@ -0,0 +1,85 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file log.cpp
+/// Contains implementation of log categories.
+
+#include "cm/log/log.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+
+namespace cm::log {
+
+
+/// Registry of log categories and configured levels of categories
+struct category_registry {
+    /// Returns minimum severity level of records of category passing log
+    /// filter. Subcategories named "category/subcategory" inherit level of
+    /// category if their levels are not specified
+    severity_t category_level(std::string_view name) const {
+        if (!global_level) {
+            return boost::log::trivial::trace;
+        }
+
+        if (auto it = levels.find(std::string{name}); it != levels.end()) {
+            return it->second;
+        }
+
+        if (auto pos = name.find('/'); pos != std::string_view::npos) {
+            if (auto it = levels.find(std::string{name.substr(0, pos)}); it != levels.end()) {
+                return it->second;
+            }
+        }
+
+        return *global_level;
+    }
+
+    std::mutex mutex;                                   ///< Protects registry
+    std::map<std::string, std::unique_ptr<category>, std::less<>> categories;   ///< Categories by names
+    std::optional<severity_t> global_level;             ///< Global level or empty if levels are not set
+    std::unordered_map<std::string, severity_t> levels; ///< Levels of categories and subcategories
+};
+
+
+/// Returns registry of log categories
+static category_registry & get_registry() {
+    static category_registry registry;
+    return registry;
+}
+
+
+category & get_category(std::string_view name) {
+    auto & reg = get_registry();
+    std::lock_guard lock{reg.mutex};
+
+    auto it = reg.categories.find(name);
+    if (it == reg.categories.end()) {
+        auto cat = std::make_unique<category>(std::string{name}, reg.category_level(name));
+        it = reg.categories.emplace(cat->name(), std::move(cat)).first;
+    }
+
+    return *it->second;
+}
+
+
+void set_category_levels(severity_t global_level,
+                         const std::unordered_map<std::string, severity_t> & levels) {
+    auto & reg = get_registry();
+    std::lock_guard lock{reg.mutex};
+
+    reg.global_level = global_level;
+    reg.levels = levels;
+
+    for (auto && [name, cat] : reg.categories) {
+        cat->set_level(reg.category_level(name));
+    }
+}
+
+
+}
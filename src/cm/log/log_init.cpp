@@ -8,14 +8,23 @@
 /// Contains implementation of common log initialization functions.
 
 #include "cm/log/log_init.hpp"
+#include "cm/log/log.hpp"
+#include "cm/log/record_queue.hpp"
 #include <boost/log/attributes/timer.hpp>
 #include <boost/log/attributes/value_extraction.hpp>
 #include <boost/log/sinks/text_file_backend.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
 #include <boost/log/sinks/sync_frontend.hpp>
 #include <boost/log/sinks/text_ostream_backend.hpp>
 #include <boost/log/utility/setup.hpp>
 #include <boost/program_options.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 
 namespace bl = boost::log;
@@ -26,6 +35,17 @@ namespace po = boost::program_options;
 namespace cm::log {
 
 
+/// Functions stopping asynchronous sinks added by log_init
+static std::vector<std::function<void()>> & async_sink_stops() {
+    static std::vector<std::function<void()>> stops;
+    return stops;
+}
+
+
+/// Mutex protecting functions stopping asynchronous sinks
+static std::mutex async_sink_mutex;
+
+
 template <typename T>
 static auto make_sink(const boost::shared_ptr<T> & backend) {
     using sink_t = bl::sinks::synchronous_sink<T>;
@@ -35,22 +55,74 @@ static auto make_sink(const boost::shared_ptr<T> & backend) {
 }
 
 
-void log_init(bool log_console, const fs::path & log_file) {
+/// Creates asynchronous sink writing records from background thread,
+/// registers sink for stopping by log_shutdown
+template <typename T>
+static auto make_async_sink(const boost::shared_ptr<T> & backend, const async_options & async) {
+    using sink_t = bl::sinks::asynchronous_sink<T, record_queue>;
+    auto sink = boost::make_shared<sink_t>(backend);
+    sink->set_limits(async.queue_size, async.overflow);
+    setup_sink_formatting(*sink);
+
+    std::lock_guard lock{async_sink_mutex};
+    if (async_sink_stops().empty()) {
+        std::atexit(log_shutdown);
+    }
+
+    async_sink_stops().push_back([sink] {
+        bl::core::get()->remove_sink(sink);
+        sink->close();
+        sink->stop();
+        sink->flush();
+
+        if (auto dropped = sink->dropped(); dropped != 0) {
+            std::cerr << "WARNING: " << dropped << " log records dropped" << std::endl;
+        }
+    });
+
+    return sink;
+}
+
+
+void log_init(bool log_console, const fs::path & log_file, const async_options & async) {
+    auto add_sink = [&](auto && backend) {
+        if (async.enabled) {
+            bl::core::get()->add_sink(make_async_sink(backend, async));
+        } else {
+            bl::core::get()->add_sink(make_sink(backend));
+        }
+    };
 
     if (!log_file.empty()) {
+        // asynchronous sink flushes file when stopped instead of flushing
+        // after each record
         fs::create_directories(log_file.parent_path());
         auto backend = boost::make_shared<bl::sinks::text_file_backend>(bl::keywords::file_name = log_file,
-                                                                        bl::keywords::auto_flush = true);
-        bl::core::get()->add_sink(make_sink(backend));
+                                                                        bl::keywords::auto_flush = !async.enabled);
+        add_sink(backend);
     }
     
     if (log_console) {
         auto backend = boost::make_shared<bl::sinks::text_ostream_backend>();
         backend->add_stream(boost::shared_ptr<std::ostream>(&std::cerr, boost::null_deleter()));
-        bl::core::get()->add_sink(make_sink(backend));
+        add_sink(backend);
     }
 
     bl::core::get()->set_filter(bl::trivial::severity >= bl::trivial::info);
+    set_category_levels(bl::trivial::info, {});
+}
+
+
+void log_shutdown() {
+    std::vector<std::function<void()>> stops;
+    {
+        std::lock_guard lock{async_sink_mutex};
+        stops.swap(async_sink_stops());
+    }
+
+    for (auto && stop : stops) {
+        stop();
+    }
 }
 
 
@@ -71,7 +143,27 @@ void log_init(const po::variables_map & vars,
               bool log_console,
               const fs::path & def_log_file) {
     fs::path log_file = vars.count("log-file") ? vars["log-file"].as<fs::path>() : def_log_file;
-    log_init(log_console, log_file);
+
+    async_options async;
+    async.enabled = vars.count("log-async") != 0;
+    if (vars.count("log-queue-size") != 0) {
+        async.queue_size = vars["log-queue-size"].as<std::size_t>();
+    }
+
+    if (vars.count("log-overflow") != 0) {
+        auto overflow = vars["log-overflow"].as<std::string>();
+        if (overflow == "block") {
+            async.overflow = overflow_policy::block;
+        } else if (overflow == "drop") {
+            async.overflow = overflow_policy::drop;
+        } else {
+            std::ostringstream msg;
+            msg << "invalid log overflow policy: '" << overflow << "'";
+            throw std::runtime_error(msg.str());
+        }
+    }
+
+    log_init(log_console, log_file, async);
 
     if (vars.count("log-level") == 0) {
         return;
@@ -109,39 +201,17 @@ void log_init(const po::variables_map & vars,
     }
 
 
-    // setting custom log filter
-
-    auto filter = [global_sev, cat_sev_map](const bl::attribute_value_set & attrs) -> bool {
-        // extracting severity
-        bl::trivial::severity_level sev = bl::trivial::severity_level::info;
-        auto sev_attr = attrs[bl::trivial::severity];
-        if (!sev_attr.empty()) {
-            sev = *sev_attr;
-        }
-
-        // extracting category and subcategory
-        auto cat = attrs["Category"].extract_or_default<std::string, void, std::string>(std::string{});
-        auto subcat = attrs["Subcategory"].extract_or_default<std::string, void, std::string>(std::string{});
-
-        // first trying get level for subcategory
-        if (!subcat.empty()) {
-            auto it = cat_sev_map.find(cat + "/" + subcat);
-            if (it != cat_sev_map.end()) {
-                return sev >= it->second;
-            }
-        }
-
-        // next truing get level for category
-        auto it = cat_sev_map.find(cat);
-        if (it != cat_sev_map.end()) {
-            return sev >= it->second;
-        }
+    // setting levels of categories checked by log statements before creating
+    // log records. Category attributes are added to records after filtering,
+    // so log filter checks only the lowest severity level of all categories
+    set_category_levels(global_sev, cat_sev_map);
 
-        // checking global level
-        return sev >= global_sev;
-    };
+    auto min_sev = global_sev;
+    for (auto && [cat, sev] : cat_sev_map) {
+        min_sev = std::min(min_sev, sev);
+    }
 
-    bl::core::get()->set_filter(filter);
+    bl::core::get()->set_filter(bl::trivial::severity >= min_sev);
 }
 
 
@@ -151,7 +221,12 @@ po::options_description log_options() {
     desc.add_options()
             ("log-level", po::value<std::string>(),
                 "Logging level (trace, debug, info, warning, error, fatal)")
-            ("log-file", po::value<fs::path>(), "Path to log file");
+            ("log-file", po::value<fs::path>(), "Path to log file")
+            ("log-async", "Write log records from background thread")
+            ("log-queue-size", po::value<std::size_t>()->default_value(async_options{}.queue_size),
+                "Maximum number of log records queued for background thread")
+            ("log-overflow", po::value<std::string>()->default_value("block"),
+                "Policy for full log queue (block, drop)");
 
     return desc;
 }
@@ -0,0 +1,25 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file named_context_entity.cpp
+/// Contains implementation of the named_context_entity class.
+
+#include "pch.hpp"
+#include "cm/named_context_entity.hpp"
+#include "cm/context.hpp"
+
+
+namespace cm {
+
+
+named_context_entity::named_context_entity(context * ctx, const std::string & nm):
+context_entity{ctx},
+name_{ctx ? ctx->names().intern(nm) : symbol{}} {
+    assert((ctx || nm.empty()) && "named entity without context can't have name");
+}
+
+
+}
@@ -16,9 +16,14 @@ namespace cm {
 
 
 namespace_ *namespace_::create_namespace(const std::string & name) {
-    auto & ns_ptr = namespaces_[name];
+    assert(!is_frozen() && "can't modify frozen namespace");
+
+    auto key = names().intern(name);
+    auto & ns_ptr = namespaces_[key];
     assert(!ns_ptr && "namespace with specified name already exists");
-    ns_ptr = std::make_shared<namespace_>(this, name);
+    ns_ptr = std::shared_ptr<namespace_>(new (entity_resource()) namespace_(this, name));
+    ns_ptr->key_ = key;
+    add_qualified_name(ns_ptr.get(), key);
     return ns_ptr.get();
 }
 
@@ -27,31 +32,47 @@ namespace_ * namespace_::get_or_create_namespace(const std::string & name) {
 
     assert(!name.empty() && "namespace name should not be empty");
 
-    auto & nsps_ptr = namespaces_[name];
+    auto key = names().intern(name);
+    auto & nsps_ptr = namespaces_[key];
     if (nsps_ptr)
         return nsps_ptr.get();
 
-    nsps_ptr = std::make_shared<namespace_>(this, name);
+    assert(!is_frozen() && "can't modify frozen namespace");
+    nsps_ptr = std::shared_ptr<namespace_>(new (entity_resource()) namespace_(this, name));
+    nsps_ptr->key_ = key;
+    add_qualified_name(nsps_ptr.get(), key);
     return nsps_ptr.get();
 }
 
 
 namespace_ * namespace_::create_anon_namespace() {
+    assert(!is_frozen() && "can't modify frozen namespace");
+
     // creating key for anonymous namespace
     ++num_anon_ns_;
     std::ostringstream str;
     str << "<##anon_namespace_" << num_anon_ns_ << ">";
 
     // creating anonymous namespace and adding it into map
-    auto ns = std::make_shared<namespace_>(this, "");
-    auto res = namespaces_.insert(std::make_pair(str.str(), ns));
+    auto ns = std::shared_ptr<namespace_>(new (entity_resource()) namespace_(this, ""));
+    ns->key_ = names().intern(str.str());
+    auto res = namespaces_.insert(std::make_pair(ns->key_, ns));
     assert(res.second && "anon namespace with same key already exists");
+
+    // anonymous namespace shares qualified name with this namespace
+    add_qualified_name(ns.get(), ns->name_);
     return ns.get();
 }
 
 
-const namespace_ * namespace_::find_namespace(const std::string & name) const {
-    auto it = namespaces_.find(name);
+const namespace_ * namespace_::find_namespace(std::string_view name) const {
+    // name that is not in table is not a name of any namespace
+    auto key = names().find(name);
+    if (!key) {
+        return nullptr;
+    }
+
+    auto it = namespaces_.find(*key);
     if (it == namespaces_.end()) {
         return nullptr;
     }
@@ -60,6 +81,24 @@ const namespace_ * namespace_::find_namespace(const std::string & name) const {
 }
 
 
+void namespace_::add_nested_qualified_names() {
+    context::add_nested_qualified_names();
+
+    for (auto && [key, ns] : namespaces_) {
+        add_qualified_name(ns.get(), ns->name_);
+    }
+}
+
+
+void namespace_::remove_nested_qualified_names() {
+    context::remove_nested_qualified_names();
+
+    for (auto && [key, ns] : namespaces_) {
+        remove_qualified_name(ns.get(), ns->name_);
+    }
+}
+
+
 void namespace_::dump_entities(std::ostream & str,
                                const dump_options & opts,
                                unsigned int indent) const {
@@ -47,11 +47,9 @@ void qual_type_base::print_qual(std::ostream &str, bool first_space, bool last_s
 }
 
 
-void qual_type_base::print_desc(std::ostream & str) const {
-    bool first = true;
-
+void qual_type_base::print_desc_impl(std::ostream & str, const type_t * t) const {
     // printing type description
-    ctype()->print_desc(str);
+    t->print_desc(str);
 
     // printing qualifiers
 
@@ -0,0 +1,159 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file qualified_name_index.cpp
+/// Contains implementation of the qualified_name_index class.
+
+#include "pch.hpp"
+#include "cm/qualified_name_index.hpp"
+#include "cm/context.hpp"
+#include <cassert>
+
+
+namespace cm {
+
+
+/// Returns the first component of qualified name and removes it with following
+/// separator from name. Separators inside template arguments are skipped
+static std::string_view next_qualified_name_component(std::string_view & qname) {
+    int depth = 0;
+    for (std::size_t i = 0; i < qname.size(); ++i) {
+        auto c = qname[i];
+        if (c == '<') {
+            ++depth;
+        } else if (c == '>' && depth > 0) {
+            --depth;
+        } else if (c == ':' && depth == 0 && i + 1 < qname.size() && qname[i + 1] == ':') {
+            auto res = qname.substr(0, i);
+            qname.remove_prefix(i + 2);
+            return res;
+        }
+    }
+
+    auto res = qname;
+    qname = {};
+    return res;
+}
+
+
+void qualified_name_index::insert(std::size_t key, context_entity * ent, symbol name) {
+    assert(key != 0 && "invalid qualified name key");
+
+    // keeping load factor of table not greater than 3/4
+    if ((size_ + 1) * 4 > slots_.size() * 3) {
+        grow();
+    }
+
+    auto mask = slots_.size() - 1;
+    auto i = key & mask;
+    while (slots_[i].key != 0) {
+        i = (i + 1) & mask;
+    }
+
+    slots_[i] = {key, ent, name};
+    ++size_;
+}
+
+
+void qualified_name_index::erase(std::size_t key, context_entity * ent) {
+    assert(!slots_.empty() && "entity not found in qualified name index");
+
+    auto mask = slots_.size() - 1;
+    auto i = key & mask;
+    while (slots_[i].key != key || slots_[i].ent != ent) {
+        assert(slots_[i].key != 0 && "entity not found in qualified name index");
+        i = (i + 1) & mask;
+    }
+
+    // moving back following slots that can't be found after emptying slot
+    for (auto j = (i + 1) & mask; slots_[j].key != 0; j = (j + 1) & mask) {
+        auto home = slots_[j].key & mask;
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            slots_[i] = slots_[j];
+            i = j;
+        }
+    }
+
+    slots_[i] = {};
+    --size_;
+}
+
+
+void qualified_name_index::grow() {
+    std::pmr::vector<slot> old{slots_.get_allocator()};
+    old.swap(slots_);
+    slots_.resize(old.empty() ? 64 : old.size() * 2);
+
+    auto mask = slots_.size() - 1;
+    for (auto && s : old) {
+        if (s.key != 0) {
+            auto i = s.key & mask;
+            while (slots_[i].key != 0) {
+                i = (i + 1) & mask;
+            }
+
+            slots_[i] = s;
+        }
+    }
+}
+
+
+bool qualified_name_index::split_qualified_name(const name_table & names,
+                                                std::string_view qname,
+                                                std::pmr::vector<symbol> & comps) {
+    // skipping global scope qualifier
+    if (qname.starts_with("::")) {
+        qname.remove_prefix(2);
+    }
+
+    while (!qname.empty()) {
+        // name that is not in table is not a name of any entity
+        auto sym = names.find(next_qualified_name_component(qname));
+        if (!sym) {
+            return false;
+        }
+
+        comps.push_back(*sym);
+    }
+
+    return true;
+}
+
+
+std::size_t qualified_name_index::qualified_key(const std::pmr::vector<symbol> & comps) {
+    auto key = root_key;
+    for (auto && sym : comps) {
+        key = child_key(key, sym);
+    }
+
+    return key;
+}
+
+
+bool qualified_name_index::has_qualified_name(const slot & s, const std::pmr::vector<symbol> & comps) {
+    if (comps.empty() || comps.back() != s.name) {
+        return false;
+    }
+
+    // comparing names of parent contexts with remaining components starting
+    // from the last one, anonymous contexts share qualified name with their parents
+    auto comp = comps.rbegin() + 1;
+    for (auto ctx = s.ent->ctx(); ctx->ctx(); ctx = ctx->ctx()) {
+        if (ctx->qname_name_.empty()) {
+            continue;
+        }
+
+        if (comp == comps.rend() || *comp != ctx->qname_name_) {
+            return false;
+        }
+
+        ++comp;
+    }
+
+    return comp == comps.rend();
+}
+
+}
@@ -0,0 +1,233 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file source_location_table.cpp
+/// Contains implementation of the source_location_table class.
+
+#include "pch.hpp"
+#include "cm/source_location_table.hpp"
+#include "cm/hash.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+
+namespace cm {
+
+
+constinit std::array<std::atomic<const source_location_table::slab*>,
+                     source_location_table::num_slabs> source_location_table::slabs_{};
+
+constinit std::atomic<std::size_t> source_location_table::next_slab_{1};
+
+
+source_location_table::~source_location_table() {
+    for (auto && sl : own_slabs_) {
+        slabs_[sl->index].store(nullptr, std::memory_order_release);
+    }
+}
+
+
+std::uint32_t source_location_table::encode(const source_file * file,
+                                            unsigned int line,
+                                            unsigned int column) {
+    if (!file) {
+        return 0;
+    }
+
+    // columns are stored incremented, so missing column UINT_MAX is stored
+    // as 0. Columns too large for wide spans are stored as missing columns
+    std::uint32_t col = column + 1;
+    if (std::bit_width(col) > max_column_bits) {
+        col = 0;
+    }
+
+    auto sp = last_encoded_.load(std::memory_order_acquire);
+    if (!sp || !sp->contains(file, line, col)) {
+        sp = find_or_add_span(file, line, col);
+        if (!sp) {
+            num_dropped_.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        }
+
+        last_encoded_.store(sp, std::memory_order_release);
+    }
+
+    return sp->base + ((line - sp->first_line) << sp->column_bits) + col;
+}
+
+
+decoded_source_location source_location_table::decode(std::uint32_t id) {
+    if (id == 0) {
+        return {};
+    }
+
+    // slab is empty or taken by other table if table is destroyed
+    auto sl = slabs_[id >> slab_bits].load(std::memory_order_acquire);
+    if (!sl) {
+        return {};
+    }
+
+    auto & tbl = *sl->table;
+    auto sp = tbl.last_decoded_.load(std::memory_order_acquire);
+    if (!sp || !sp->contains(id)) {
+        // spans of slab are ordered by base identifiers
+        auto lo = sl->first_span;
+        auto hi = lo + sl->num_spans.load(std::memory_order_acquire);
+        if (hi == lo) {
+            return {};
+        }
+
+        while (hi - lo > 1) {
+            auto mid = lo + (hi - lo) / 2;
+            if (tbl.span_at(mid).base <= id) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+
+        sp = &tbl.span_at(lo);
+        if (!sp->contains(id)) {
+            return {};
+        }
+
+        tbl.last_decoded_.store(sp, std::memory_order_release);
+    }
+
+    auto offset = id - sp->base;
+    auto line = sp->first_line + (offset >> sp->column_bits);
+    auto col = offset & ((std::uint32_t{1} << sp->column_bits) - 1);
+    return {sp->file, line, col - 1};
+}
+
+
+std::size_t source_location_table::span_key_hash::operator()(const span_key & key) const {
+    auto res = hash_mix(reinterpret_cast<std::uintptr_t>(key.file));
+    res = hash_combine(res, key.line);
+    return hash_combine(res, key.column_bits);
+}
+
+
+const source_location_table::span *
+source_location_table::find_or_add_span(const source_file * file,
+                                        unsigned int line,
+                                        std::uint32_t col) {
+    std::lock_guard lock{mutex_};
+
+    // locations with large columns are encoded in wide spans of single lines
+    if (col >= (std::uint32_t{1} << block_column_bits)) {
+        auto bits = static_cast<std::uint32_t>(std::bit_width(col));
+        auto [it, inserted] = wide_spans_.try_emplace({file, line, bits});
+        if (!inserted) {
+            return &span_at(it->second);
+        }
+
+        auto sp = add_span(file, line, 1, bits);
+        if (!sp) {
+            wide_spans_.erase(it);
+            return nullptr;
+        }
+
+        it->second = num_spans_.load(std::memory_order_relaxed) - 1;
+        return sp;
+    }
+
+    // searching for block of lines containing line
+    auto & blocks = blocks_[file];
+    auto next = blocks.upper_bound(line);
+    std::uint32_t start = 0;
+    if (next != blocks.begin()) {
+        auto & prev = span_at(std::prev(next)->second);
+        std::uint64_t prev_end = std::uint64_t{prev.first_line} + prev.num_lines;
+        if (line < prev_end) {
+            return &prev;
+        }
+
+        start = static_cast<std::uint32_t>(prev_end);
+    }
+
+    // blocks of source file grow with number of blocks, so source files with
+    // few locations don't take large blocks. Block is aligned to its size
+    // and clipped by neighbour blocks, so each line is in a single block
+    auto size = std::min<std::uint32_t>(block_lines, std::bit_ceil(blocks.size() + 1));
+    auto aligned = line / size * size;
+    start = std::max(start, aligned);
+    auto end = std::uint64_t{aligned} + size;
+    if (next != blocks.end()) {
+        end = std::min<std::uint64_t>(end, next->first);
+    }
+
+    auto sp = add_span(file, start, static_cast<std::uint32_t>(end - start), block_column_bits);
+    if (sp) {
+        blocks.emplace(start, num_spans_.load(std::memory_order_relaxed) - 1);
+    }
+
+    return sp;
+}
+
+
+const source_location_table::span *
+source_location_table::add_span(const source_file * file,
+                                std::uint32_t first_line,
+                                std::uint32_t num_lines,
+                                std::uint32_t column_bits) {
+    // locations in source files of frozen code model are encoded by its
+    // forks in their own tables
+    if (frozen_.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+
+    auto size = std::uint64_t{num_lines} << column_bits;
+    auto idx = num_spans_.load(std::memory_order_relaxed);
+
+    // allocating new slab if span doesn't fit into the last slab, the rest
+    // of the last slab is not used
+    if (next_id_ + size > slab_end_) {
+        // searching for free slab from slab following the last taken slab,
+        // so slabs of destroyed tables are not reused immediately
+        auto sl = std::make_unique<slab>(this, 0, idx);
+        auto start = next_slab_.load(std::memory_order_relaxed);
+        for (std::size_t n = 0; n != num_slabs - 1; ++n) {
+            auto i = (start - 1 + n) % (num_slabs - 1) + 1;
+            const slab * expected = nullptr;
+            if (slabs_[i].compare_exchange_strong(expected, sl.get(), std::memory_order_acq_rel)) {
+                sl->index = i;
+                next_slab_.store(i % (num_slabs - 1) + 1, std::memory_order_relaxed);
+                break;
+            }
+        }
+
+        if (sl->index == 0) {
+            return nullptr;
+        }
+
+        next_id_ = std::uint64_t{sl->index} << slab_bits;
+        slab_end_ = next_id_ + (std::uint64_t{1} << slab_bits);
+        own_slabs_.push_back(std::move(sl));
+    }
+
+    auto c = static_cast<std::size_t>(std::bit_width(idx / first_chunk_size + 1) - 1);
+    assert(c < max_chunks && "too many source location spans");
+
+    auto & chunk = chunks_[c];
+    if (!chunk) {
+        chunk = std::make_unique<span[]>(first_chunk_size << c);
+    }
+
+    auto & sp = chunk[idx - first_chunk_size * ((std::size_t{1} << c) - 1)];
+    sp = {static_cast<std::uint32_t>(next_id_), first_line, num_lines, column_bits, file};
+    next_id_ += size;
+
+    // publishing span to threads decoding locations without lock
+    auto & sl = *own_slabs_.back();
+    num_spans_.store(idx + 1, std::memory_order_release);
+    sl.num_spans.store(idx + 1 - sl.first_span, std::memory_order_release);
+    return &sp;
+}
+
+
+}
@@ -28,6 +28,7 @@ namespace cm::src::clang {
 
 void ast_converter::convert(::clang::ASTContext & ctx) {
     clang_ast_ctx_ = &ctx;
+    locs_.reset(&ctx.getSourceManager());
 
     // auto tu_decl = ctx.getTranslationUnitDecl();
     // tu_decl->dump();
@@ -1308,8 +1309,8 @@ void ast_converter::convert_template_and_arguments(
 
 
 source_position ast_converter::convert_source_pos(const ::clang::SourceLocation & loc) {
-    auto start_ploc = clang_ast_ctx_->getSourceManager().getPresumedLoc(loc);
-    return source_position{start_ploc.getLine(), start_ploc.getColumn()};
+    auto ploc = locs_.presumed(loc);
+    return source_position{ploc.line, ploc.column};
 }
 
 
@@ -1317,20 +1318,17 @@ source_file_range ast_converter::convert_source_range(const ::clang::SourceLocat
                                                       const ::clang::SourceLocation & end) {
     // TODO: macros support
 
-    // converting start location
-    auto start_ploc = clang_ast_ctx_->getSourceManager().getPresumedLoc(start);
-    source_position start_pos{start_ploc.getLine(), start_ploc.getColumn()};
-    auto start_file = scm_.code_mdl().source(start_ploc.getFilename());
-
-    // converting end location
-    auto end_ploc = clang_ast_ctx_->getSourceManager().getPresumedLoc(end);
-    source_position end_pos{end_ploc.getLine(), end_ploc.getColumn()};
-    auto end_file = scm_.code_mdl().source(end_ploc.getFilename());
+    // converting start and end locations
+    auto start_ploc = locs_.presumed(start);
+    auto end_ploc = locs_.presumed(end);
 
     // TODO: support this case
-    assert(start_file == end_file && "AST nodes splitted between source files are not supported");
+    assert(start_ploc.file == end_ploc.file &&
+           "AST nodes splitted between source files are not supported");
 
-    return source_file_range{start_file, source_range{start_pos, end_pos}};
+    return source_file_range{start_ploc.file,
+                             source_range{source_position{start_ploc.line, start_ploc.column},
+                                          source_position{end_ploc.line, end_ploc.column}}};
 }
 
 
@@ -24,14 +24,14 @@ context_entity{ctx} {
 
 
 template_record * template_record_type::templ() {
-    auto res = dynamic_cast<template_record*>(ctx());
+    auto res = entity_cast<template_record>(ctx());
     assert(res && "parent context of template record type is not a template record");
     return res;
 }
 
 
 const template_record * template_record_type::templ() const {
-    auto res = dynamic_cast<const template_record*>(ctx());
+    auto res = entity_cast<const template_record>(ctx());
     assert(res && "parent context of template record type is not a template record");
     return res;
 }
@@ -135,6 +135,48 @@ BOOST_AUTO_TEST_CASE(test_create_ptr_const) {
 }
 
 
+/// Tests kinds and names of builtin types
+BOOST_AUTO_TEST_CASE(builtin_types) {
+    for (std::size_t i = 0; i < builtin_type::num_kinds; ++i) {
+        auto knd = static_cast<builtin_type::kind_t>(i);
+        BOOST_CHECK(cm.bt_type(knd)->kind() == knd);
+    }
+
+    BOOST_CHECK(cm.bt_arm_sve_int8x3()->kind() == builtin_type::kind_t::arm_sve_int8x3_);
+    BOOST_CHECK_EQUAL(cm.bt_arm_sve_int8x3()->name(), "svint8x3");
+    BOOST_CHECK_EQUAL(cm.bt_nullptr_t()->name(), "nullptr_t");
+    BOOST_CHECK_EQUAL(cm.bt_complex_long_double()->name(), "long double complex");
+    BOOST_CHECK_EQUAL(cm.bt_arm_sve_count()->name(), "svcount");
+}
+
+
+/// Tests qualifiers packed into qual type
+BOOST_AUTO_TEST_CASE(qual_type_qualifiers) {
+    auto rec = cm.create_named_record("rec");
+    qual_type qt{rec, true, false};
+    BOOST_CHECK(qt.type() == rec);
+    BOOST_CHECK(qt.is_const());
+    BOOST_CHECK(!qt.is_volatile());
+
+    qt.set_volatile(true);
+    qt.set_const(false);
+    BOOST_CHECK(qt.type() == rec);
+    BOOST_CHECK(!qt.is_const());
+    BOOST_CHECK(qt.is_volatile());
+
+    auto rec_qt = qt.cast<record_type>();
+    BOOST_CHECK(rec_qt.type() == rec);
+    BOOST_CHECK(rec_qt.is_volatile());
+    BOOST_CHECK(!qt.cast<builtin_type>());
+
+    auto int_qt = qt.replaced_type(rec, cm.bt_int());
+    BOOST_CHECK(int_qt.type() == cm.bt_int());
+    BOOST_CHECK(int_qt.is_volatile());
+    BOOST_CHECK(int_qt != qual_type{cm.bt_int()});
+    BOOST_CHECK(const_qual_type{int_qt} == (const_qual_type{cm.bt_int(), false, true}));
+}
+
+
 /// Tests creating typedef in global namespace
 BOOST_AUTO_TEST_CASE(test_create_typedef_global) {
     auto tt = cm.create_typedef("my_int", cm.bt_int());
@@ -212,6 +254,37 @@ BOOST_AUTO_TEST_CASE(create_func_diff_cv) {
 }
 
 
+/// Tests creating function types with same parameters in different order
+BOOST_AUTO_TEST_CASE(create_func_param_order) {
+    auto ftype = cm.get_or_create_func_type(cm.bt_void(), cm.bt_int(), cm.bt_char());
+    auto ftype2 = cm.get_or_create_func_type(cm.bt_void(), cm.bt_char(), cm.bt_int());
+    BOOST_CHECK(ftype != ftype2);
+
+    std::vector<qual_type> params{cm.bt_char(), cm.bt_int()};
+    BOOST_CHECK(cm.get_or_create_func_type_r(cm.bt_void(), params) == ftype2);
+
+    function_type_id_hash hash;
+    BOOST_CHECK(hash(ftype->type_id()) != hash(ftype2->type_id()));
+    BOOST_CHECK(hash(ftype2->type_id()) == hash(function_type_key{qual_type{cm.bt_void()}, params}));
+}
+
+
+/// Tests tracking of several uses of same type by function type
+BOOST_AUTO_TEST_CASE(func_type_uses) {
+    auto ftype = cm.get_or_create_func_type(cm.bt_int(), cm.bt_int(), cm.bt_char());
+    BOOST_CHECK_EQUAL(cm.bt_int()->uses_count(), 2);
+    BOOST_CHECK_EQUAL(cm.bt_char()->uses_count(), 1);
+
+    for (auto && use : cm.bt_int()->uses()) {
+        BOOST_CHECK(use == ftype);
+    }
+
+    cm.remove_unused_composite_types();
+    BOOST_CHECK(cm.bt_int()->uses().empty());
+    BOOST_CHECK(cm.bt_char()->uses().empty());
+}
+
+
 /// Tests creating pointer to function type
 BOOST_AUTO_TEST_CASE(create_func_ptr_type) {
     auto ftype = cm.get_or_create_func_type(cm.bt_void());
@@ -234,6 +307,35 @@ BOOST_AUTO_TEST_CASE(create_templ_inst) {
 }
 
 
+/// Tests searching for template substitutions by arguments
+BOOST_AUTO_TEST_CASE(find_templ_substitution) {
+    auto templ = cm.create_named_entity<template_record>("my_templ", record_kind::struct_);
+    templ->add_type_template_param("T");
+    templ->add_type_template_param("U");
+    auto inst1 = templ->create_instantiation(cm.bt_int(), cm.bt_float());
+    auto inst2 = templ->create_instantiation(cm.bt_float(), cm.bt_int());
+    auto inst3 = templ->create_instantiation(cm.bt_int(), cm::value{1});
+    auto spec = templ->create_specialization(cm.bt_int(), cm.bt_int());
+
+    BOOST_CHECK(templ->find_instantiation(cm.bt_int(), cm.bt_float()) == inst1);
+    BOOST_CHECK(templ->find_instantiation(cm.bt_float(), cm.bt_int()) == inst2);
+    BOOST_CHECK(templ->find_instantiation(cm.bt_int(), cm::value{1}) == inst3);
+    BOOST_CHECK(templ->find_specialization(cm.bt_int(), cm.bt_int()) == spec);
+    BOOST_CHECK(templ->find_substitution(cm.bt_int(), cm::value{2}) == nullptr);
+    BOOST_CHECK(templ->find_substitution(cm.bt_int()) == nullptr);
+
+    // partial specialization is found after adding arguments
+    auto part_spec = templ->create_partial_specialization();
+    part_spec->add_arg(cm.bt_char());
+    part_spec->add_arg(cm.bt_char());
+    BOOST_CHECK(templ->find_substitution(cm.bt_char(), cm.bt_char()) == part_spec);
+
+    cm.remove_entity(inst1);
+    BOOST_CHECK(templ->find_instantiation(cm.bt_int(), cm.bt_float()) == nullptr);
+    BOOST_CHECK(templ->find_instantiation(cm.bt_float(), cm.bt_int()) == inst2);
+}
+
+
 /// Tests creating base-recursive template instantiations
 BOOST_AUTO_TEST_CASE(create_templ_inst_recursive) {
     auto rec = cm.create_named_record("my_record");
@@ -283,11 +385,204 @@ BOOST_AUTO_TEST_CASE(replace_type) {
 }
 
 
+/// Tests searching for template instantiations after replacing types of arguments
+BOOST_AUTO_TEST_CASE(replace_type_templ_arg) {
+    auto rec1 = cm.create_named_record("rec1");
+    auto rec2 = cm.create_named_record("rec2");
+    auto templ = cm.create_named_entity<template_record>("templ", record_kind::struct_);
+    templ->add_type_template_param("T");
+    templ->add_type_template_param("U");
+    auto inst = templ->create_instantiation(rec1, cm::value{1});
+
+    cm.replace_type(rec1, rec2);
+    BOOST_CHECK(templ->find_instantiation(rec1, cm::value{1}) == nullptr);
+    BOOST_CHECK(templ->find_instantiation(rec2, cm::value{1}) == inst);
+
+    // changing value of argument
+    auto v_arg = entity_cast<value_template_argument>(inst->args()[1]);
+    BOOST_REQUIRE(v_arg);
+    v_arg->set_value(cm::value{2});
+    BOOST_CHECK(templ->find_instantiation(rec2, cm::value{1}) == nullptr);
+    BOOST_CHECK(templ->find_instantiation(rec2, cm::value{2}) == inst);
+}
+
+
 /// Tests creating record with base
 BOOST_AUTO_TEST_CASE(record_base) {
     auto rec = cm.create_named_record("rec");
     auto base = cm.create_named_record("base");
     rec->add_base(base);
+    BOOST_CHECK_EQUAL(base->uses_count(), 1);
+
+    auto base2 = cm.create_named_record("base2");
+    rec->replace_base(base, base2);
+    BOOST_CHECK(base->uses().empty());
+    BOOST_CHECK_EQUAL(base2->uses_count(), 1);
+}
+
+
+/// Tests checking kinds of entities and casting entities by kind
+BOOST_AUTO_TEST_CASE(entity_kind_cast) {
+    auto rec = cm.create_named_record("rec");
+    auto fld = rec->create_field("x", cm.bt_int());
+    type_t * ptr = cm.get_or_create_ptr_type(rec);
+    entity * ent = fld;
+
+    BOOST_CHECK(rec->ent_kind() == entity_kind::named_record_type);
+    BOOST_CHECK(fld->ent_kind() == entity_kind::field);
+    BOOST_CHECK(ptr->ent_kind() == entity_kind::pointer_type);
+    BOOST_CHECK(cm.ent_kind() == entity_kind::code_model);
+
+    BOOST_CHECK(rec->is<record_type>());
+    BOOST_CHECK(rec->is<context>());
+    BOOST_CHECK(!rec->is<ptr_or_ref_type>());
+    BOOST_CHECK(ent->cast<variable>() == fld);
+    BOOST_CHECK(ent->cast<field>() == fld);
+    BOOST_CHECK(ent->cast<type_t>() == nullptr);
+    BOOST_CHECK(ptr->cast<pointer_type>() == ptr);
+    BOOST_CHECK(ptr->cast<ptr_or_ref_type>() == ptr);
+    BOOST_CHECK(ptr->cast<lvalue_reference_type>() == nullptr);
+}
+
+
+/// Tests destroying code model with entities using each other across namespaces
+BOOST_AUTO_TEST_CASE(teardown_with_uses) {
+    auto model = std::make_unique<code_model>();
+    auto ns1 = model->create_namespace("ns1");
+    auto ns2 = ns1->create_namespace("ns2");
+
+    auto rec1 = ns1->create_named_record("rec1");
+    auto rec2 = ns2->create_named_record("rec2");
+    rec1->create_field("p", model->get_or_create_ptr_type(rec2));
+    rec2->add_base(rec1);
+    rec2->create_method("get")->set_ret_type(model->get_or_create_lvalue_ref_type(rec1));
+    model->create_typedef("fn", model->get_or_create_func_type(rec1, rec2));
+    ns2->create_typedef("td", rec1);
+
+    BOOST_CHECK(rec1->uses_count() != 0);
+    model.reset();
+    BOOST_CHECK(!model);
+}
+
+
+/// Tests allocating entities from memory resource of code model
+BOOST_AUTO_TEST_CASE(entity_resource) {
+    // all entities must fit into buffer, upstream resource throws on allocation
+    std::vector<char> buf(1 << 20);
+    std::pmr::monotonic_buffer_resource res{buf.data(), buf.size(), std::pmr::null_memory_resource()};
+    auto in_buf = [&](const void * ptr) {
+        auto p = static_cast<const char*>(ptr);
+        return p >= buf.data() && p < buf.data() + buf.size();
+    };
+
+    auto model = std::make_unique<code_model>(&res);
+    auto ns = model->create_namespace("ns");
+    auto rec = ns->create_named_record("record_with_name_longer_than_small_string");
+    auto meth = rec->create_method("get");
+    meth->add_param(model->bt_int());
+    auto ptr = model->get_or_create_ptr_type(rec);
+
+    BOOST_CHECK(rec->entity_resource() == &res);
+    BOOST_CHECK(in_buf(ns));
+    BOOST_CHECK(in_buf(rec));
+    BOOST_CHECK(in_buf(meth));
+    for (auto && par : meth->params()) {
+        BOOST_CHECK(in_buf(par));
+    }
+    BOOST_CHECK(in_buf(ptr));
+    BOOST_CHECK(in_buf(rec->name().data()));
+    BOOST_CHECK(in_buf(ns->name().data()));
+
+    model.reset();
+}
+
+
+/// Tests sharing interned names between entities of code model
+BOOST_AUTO_TEST_CASE(interned_names) {
+    auto ns1 = cm.create_namespace("ns1");
+    auto ns2 = ns1->create_namespace("ns2");
+    auto anon_ns = ns1->create_anon_namespace();
+    auto rec1 = ns1->create_named_record("value_type");
+    auto rec2 = ns2->create_named_record("value_type");
+
+    BOOST_CHECK(rec1->name_symbol() == rec2->name_symbol());
+    BOOST_CHECK(rec1->name().data() == rec2->name().data());
+    BOOST_CHECK(cm.names().find("value_type").has_value());
+    BOOST_CHECK(ns1->find_namespace("ns2") == ns2);
+    BOOST_CHECK(ns1->find_named_record("missing") == nullptr);
+
+    ns1->remove_namespace(anon_ns);
+    ns1->remove_namespace(ns2);
+    BOOST_CHECK(std::ranges::empty(ns1->namespaces()));
+}
+
+
+/// Tests searching for source files by path and by file name
+BOOST_AUTO_TEST_CASE(find_source) {
+    auto src = cm.source("/src/dir/file.cpp");
+    BOOST_CHECK(cm.source(std::filesystem::path{"/src/dir/file.cpp"}) == src);
+
+    std::string_view path = "/src/dir/file.cpp:10";
+    BOOST_CHECK(cm.find_source(path.substr(0, path.find(':'))) == src);
+    BOOST_CHECK(cm.find_source(std::filesystem::path{"/src/dir/file.cpp"}) == src);
+    BOOST_CHECK(cm.find_source("file.cpp") == nullptr);
+    BOOST_CHECK(cm.find_source("file.cpp", true) == src);
+    BOOST_CHECK(cm.find_source("dir/file.cpp", true) == nullptr);
+}
+
+
+/// Tests resolving qualified names after creating, renaming and removing entities
+BOOST_AUTO_TEST_CASE(resolve_qualified_names) {
+    auto ns1 = cm.create_namespace("ns1");
+    auto ns2 = ns1->create_namespace("ns2");
+    auto rec = ns2->create_named_record("rec");
+    auto nested = rec->create_named_record("nested");
+    auto fld = nested->create_field("x", cm.bt_int());
+    auto inst = ns1->create_named_record("vec<a::b>");
+    auto anon_td = ns1->create_anon_namespace()->create_typedef("td", cm.bt_int());
+
+    BOOST_CHECK(cm.resolve("ns1") == ns1);
+    BOOST_CHECK(cm.resolve("ns1::ns2") == ns2);
+    BOOST_CHECK(cm.resolve("ns1::ns2::rec") == rec);
+    BOOST_CHECK(cm.resolve("::ns1::ns2::rec::nested") == nested);
+    BOOST_CHECK(cm.resolve<field>("ns1::ns2::rec::nested::x") == fld);
+    BOOST_CHECK(cm.resolve<typedef_type>("ns1::ns2::rec::nested::x") == nullptr);
+    BOOST_CHECK(cm.resolve("ns1::vec<a::b>") == inst);
+    BOOST_CHECK(cm.resolve("ns1::td") == anon_td);
+    BOOST_CHECK(cm.resolve("ns2::rec") == nullptr);
+    BOOST_CHECK(cm.resolve("ns1::ns2::missing") == nullptr);
+
+    // renaming record changes qualified names of nested entities
+    ns2->rename_entity(rec, "rec2");
+    BOOST_CHECK(cm.resolve("ns1::ns2::rec::nested::x") == nullptr);
+    BOOST_CHECK(cm.resolve("ns1::ns2::rec2::nested::x") == fld);
+
+    // removing record removes nested entities from index
+    ns2->remove_entity(rec);
+    BOOST_CHECK(cm.resolve("ns1::ns2::rec2") == nullptr);
+    BOOST_CHECK(cm.resolve("ns1::ns2::rec2::nested") == nullptr);
+
+    ns1->remove_namespace(ns2);
+    BOOST_CHECK(cm.resolve("ns1::ns2") == nullptr);
+}
+
+
+/// Tests finding one of named entities with the same name
+BOOST_AUTO_TEST_CASE(find_overloaded_function) {
+    auto int_func = cm.create_function("f");
+    int_func->add_param(cm.bt_int());
+    auto float_func = cm.create_function("f");
+    float_func->add_param(cm.bt_float());
+
+    auto has_float_param = [&](named_function * func) {
+        auto params = func->params();
+        return std::ranges::distance(params) == 1 &&
+               (*std::ranges::begin(params))->type().type() == cm.bt_float();
+    };
+
+    BOOST_CHECK(cm.find_named_entity_if<named_function>("f", has_float_param) == float_func);
+    BOOST_CHECK(cm.find_named_entity_if<named_function>("g", has_float_param) == nullptr);
+    BOOST_CHECK(cm.find_named_entity_if<variable>("f", [](auto &&) { return true; }) == nullptr);
 }
 
 
@@ -300,6 +595,360 @@ BOOST_AUTO_TEST_CASE(reb_base_namespace) {
 }
 
 
+/// Tests removing entities owned by source file
+BOOST_AUTO_TEST_CASE(remove_source_entities) {
+    auto src_a = cm.source("a.hpp");
+    auto src_b = cm.source("b.cpp");
+
+    auto ns = cm.create_namespace("ns");
+    auto rec_a = ns->create_named_record("a");
+    auto td_a = ns->create_typedef("td", rec_a);
+    auto rec_b = ns->create_named_record("b");
+    rec_b->create_field("x", cm.bt_int());
+    rec_b->create_field("p", cm.get_or_create_ptr_type(td_a));
+
+    ns->set_entity_owner(rec_a, src_a);
+    ns->set_entity_owner(td_a, src_a);
+    ns->set_entity_owner(rec_b, src_b);
+    BOOST_CHECK(rec_a->owner_source() == src_a);
+    BOOST_CHECK_EQUAL(cm.source_entities().count(src_a), 2);
+    BOOST_CHECK_EQUAL(cm.source_entities().count(src_b), 1);
+
+    // entities using removed entities are removed too, source files owning
+    // them are returned
+    auto owners = cm.remove_source_entities(src_a);
+    BOOST_REQUIRE_EQUAL(owners.size(), 1);
+    BOOST_CHECK(owners.front() == src_b);
+    BOOST_CHECK_EQUAL(cm.source_entities().count(src_a), 0);
+    BOOST_CHECK(cm.resolve("ns::a") == nullptr);
+    BOOST_CHECK(cm.resolve("ns::td") == nullptr);
+    BOOST_CHECK(cm.resolve("ns::b") == rec_b);
+    BOOST_CHECK(cm.resolve("ns::b::x") != nullptr);
+    BOOST_CHECK(cm.resolve("ns::b::p") == nullptr);
+
+    // removed entities are removed from index
+    ns->remove_entity(rec_b);
+    BOOST_CHECK_EQUAL(cm.source_entities().count(src_b), 0);
+}
+
+
+/// Tests forking code model
+BOOST_AUTO_TEST_CASE(fork_model) {
+    auto ns = cm.create_namespace("ns");
+    auto rec = ns->create_named_record("rec");
+    auto fld = rec->create_field("x", cm.bt_int());
+    auto rec_ptr = cm.get_or_create_ptr_type(rec);
+    auto old = ns->create_named_record("old");
+
+    auto fork = cm.fork();
+    BOOST_CHECK(cm.frozen());
+    BOOST_CHECK(fork->base() == &cm);
+    BOOST_CHECK(fork->bt_int() == cm.bt_int());
+    BOOST_CHECK(fork->resolve("ns::rec::x") == fld);
+
+    // existing composite types are shared, uses of frozen entities are not tracked
+    auto fork_ns = fork->fork_namespace(ns);
+    auto new_rec = fork_ns->create_named_record("new_rec");
+    auto new_fld = new_rec->create_field("p", fork->get_or_create_ptr_type(rec));
+    BOOST_CHECK(new_fld->type().type() == rec_ptr);
+    BOOST_CHECK(fork->get_or_create_ptr_type(new_rec) != nullptr);
+    BOOST_CHECK_EQUAL(rec_ptr->uses_count(), 0);
+    BOOST_CHECK(fork->resolve("ns::new_rec") == new_rec);
+    BOOST_CHECK(cm.resolve("ns::new_rec") == nullptr);
+
+    // entities of fork shadow entities of base code model
+    auto new_old = fork_ns->create_named_record("old");
+    BOOST_CHECK(fork->resolve("ns::old") == new_old);
+    BOOST_CHECK(cm.resolve("ns::old") == old);
+
+    // hidden entities are not resolved in fork
+    fork->hide(rec);
+    BOOST_CHECK(fork->resolve("ns::rec") == nullptr);
+    BOOST_CHECK(fork->resolve("ns::rec::x") == nullptr);
+    BOOST_CHECK(cm.resolve("ns::rec") == rec);
+
+    // forks of forks
+    auto fork2 = fork->fork();
+    BOOST_CHECK(fork2->resolve("ns::new_rec") == new_rec);
+    BOOST_CHECK(fork2->resolve("ns::rec") == nullptr);
+    BOOST_CHECK(fork2->bt_int() == cm.bt_int());
+
+    fork2.reset();
+    fork.reset();
+}
+
+
+/// Tests context API of fork, which sees only entities created in fork
+BOOST_AUTO_TEST_CASE(fork_context_api) {
+    auto ns = cm.create_namespace("ns");
+    auto rec = ns->create_named_record("rec");
+
+    auto fork = cm.fork();
+    BOOST_CHECK(fork->entity_resource() == cm.entity_resource());
+
+    // qualified names fall through to base code model, context API doesn't
+    BOOST_CHECK(fork->resolve("ns") == ns);
+    BOOST_CHECK(fork->resolve("ns::rec") == rec);
+    BOOST_CHECK(fork->find_namespace("ns") == nullptr);
+
+    auto fork_ns = fork->fork_namespace(ns);
+    BOOST_CHECK(fork_ns != ns);
+    BOOST_CHECK(fork->find_namespace("ns") == fork_ns);
+    BOOST_CHECK(fork_ns->find_named_entity("rec") == nullptr);
+    BOOST_CHECK(fork->resolve("ns::rec") == rec);
+
+    auto new_rec = fork_ns->create_named_record("new_rec");
+    BOOST_CHECK(fork_ns->find_named_entity("new_rec") == new_rec);
+    BOOST_CHECK(ns->find_named_entity("new_rec") == nullptr);
+}
+
+
+/// Tests forking code model with memory resource
+BOOST_AUTO_TEST_CASE(fork_memory_resource) {
+    std::pmr::monotonic_buffer_resource res;
+    code_model base{&res};
+    auto fork = base.fork();
+    BOOST_CHECK(fork->entity_resource() == &res);
+
+    auto fork2 = fork->fork();
+    BOOST_CHECK(fork2->entity_resource() == &res);
+}
+
+
+/// Tests encoding source locations in fork without modifying base code model
+BOOST_AUTO_TEST_CASE(fork_source_locations) {
+    auto a = cm.source("a.cpp");
+    source_location base_loc{a, 1, 1};
+    auto num_spans = cm.locations().num_spans();
+
+    auto fork = cm.fork();
+    BOOST_CHECK(fork->find_source("a.cpp") == a);
+
+    // fork creates its own source file for source file of base code model
+    auto fork_a = fork->source("a.cpp");
+    BOOST_CHECK(fork_a != a);
+    BOOST_CHECK(fork_a->origin() == a);
+    BOOST_CHECK(fork_a->same_file(a));
+    BOOST_CHECK(a->same_file(fork_a));
+    BOOST_CHECK(fork->find_source("a.cpp") == fork_a);
+    BOOST_CHECK(fork->source("a.cpp") == fork_a);
+
+    source_location fork_loc{fork_a, 1000, 1};
+    BOOST_CHECK(fork_loc.decode().file == fork_a);
+    BOOST_CHECK_EQUAL(fork_loc.decode().line, 1000u);
+    BOOST_CHECK_EQUAL(cm.locations().num_spans(), num_spans);
+    BOOST_CHECK(base_loc.decode().file == a);
+
+    // frozen table encodes only locations in existing spans
+    BOOST_CHECK((source_location{a, 1, 2}).is_valid());
+    BOOST_CHECK(!(source_location{a, 1000, 1}).is_valid());
+    BOOST_CHECK_EQUAL(cm.locations().num_dropped(), 1u);
+    BOOST_CHECK_EQUAL(cm.locations().num_spans(), num_spans);
+
+    // forks of forks refer to source files of root code model
+    auto fork2 = fork->fork();
+    auto fork2_a = fork2->source("a.cpp");
+    BOOST_CHECK(fork2_a != fork_a);
+    BOOST_CHECK(fork2_a->origin() == a);
+    BOOST_CHECK(fork2_a->same_file(fork_a));
+    BOOST_CHECK(!fork2_a->same_file(fork2->source("b.cpp")));
+}
+
+
+/// Tests loading contents of contexts on demand
+BOOST_AUTO_TEST_CASE(load_contents) {
+    // loader creating field in records
+    struct field_loader: public context_loader {
+        void load(context * ctx) override {
+            BOOST_REQUIRE(pending.erase(ctx) == 1);
+            dynamic_cast<record*>(ctx)->create_field("x", mdl->bt_int());
+        }
+
+        void cancel(context * ctx) override {
+            BOOST_REQUIRE(pending.erase(ctx) == 1);
+        }
+
+        bool load_all() override {
+            bool res = !pending.empty();
+            while (!pending.empty()) {
+                (*pending.begin())->load();
+            }
+
+            return res;
+        }
+
+        record * create_record(namespace_ * ns, const std::string & name) {
+            auto rec = ns->create_named_record(name);
+            rec->set_loader(this);
+            pending.insert(rec);
+            return rec;
+        }
+
+        code_model * mdl;
+        std::unordered_set<context*> pending;
+    };
+
+    field_loader loader;
+    loader.mdl = &cm;
+    cm.add_loader(&loader);
+
+    auto ns = cm.create_namespace("ns");
+    auto a = loader.create_record(ns, "a");
+    auto b = loader.create_record(ns, "b");
+    auto c = loader.create_record(ns, "c");
+    auto d = loader.create_record(ns, "d");
+    BOOST_CHECK(!a->is_loaded());
+
+    // contents are loaded when resolving nested names and accessing entities
+    BOOST_CHECK(cm.resolve("ns::a::x") != nullptr);
+    BOOST_CHECK(a->is_loaded());
+    BOOST_CHECK_EQUAL(std::ranges::distance(b->fields()), 1);
+    BOOST_CHECK(b->is_loaded());
+
+    // destroyed contexts are removed from loader. Converting to context
+    // pointer before removing, conversion reads destroyed record
+    context * c_ctx = c;
+    ns->remove_entity(c);
+    BOOST_CHECK(!loader.pending.contains(c_ctx));
+
+    // all contents are loaded before freezing code model
+    cm.freeze();
+    BOOST_CHECK(d->is_loaded());
+    BOOST_CHECK(loader.pending.empty());
+
+    cm.remove_loader(&loader);
+}
+
+
+/// Tests encoding source locations in source location table
+BOOST_AUTO_TEST_CASE(source_location_encoding) {
+    auto a = cm.source("a.cpp");
+    auto b = cm.source("b.cpp");
+
+    BOOST_CHECK(!source_location{}.is_valid());
+    BOOST_CHECK_EQUAL(source_location{}.id(), 0u);
+
+    // locations with small and large columns and without column
+    source_location loc1{a, 10, 5};
+    source_location loc2{a, 10, 1000};
+    source_location loc3{b, 100000, UINT_MAX};
+    BOOST_CHECK(loc1.is_valid());
+
+    auto dloc1 = loc1.decode();
+    BOOST_CHECK(dloc1.file == a);
+    BOOST_CHECK_EQUAL(dloc1.line, 10u);
+    BOOST_CHECK_EQUAL(dloc1.column, 5u);
+
+    auto dloc2 = loc2.decode();
+    BOOST_CHECK(dloc2.file == a);
+    BOOST_CHECK_EQUAL(dloc2.line, 10u);
+    BOOST_CHECK_EQUAL(dloc2.column, 1000u);
+
+    auto dloc3 = loc3.decode();
+    BOOST_CHECK(dloc3.file == b);
+    BOOST_CHECK_EQUAL(dloc3.line, 100000u);
+    BOOST_CHECK_EQUAL(dloc3.column, UINT_MAX);
+
+    // the same locations have the same identifiers
+    BOOST_CHECK(loc1 == (source_location{a, 10, 5}));
+    BOOST_CHECK(loc1 != (source_location{b, 10, 5}));
+    BOOST_CHECK(loc1 != loc2);
+
+    // small column encoded after wide span of the same line
+    BOOST_CHECK(loc1 == (source_location{a, 10, 5}));
+
+    // locations without file are invalid
+    BOOST_CHECK(!(source_location{nullptr, 10, 5}).is_valid());
+}
+
+
+/// Tests encoding source locations with columns too large for spans
+BOOST_AUTO_TEST_CASE(source_location_large_column) {
+    auto a = cm.source("a.cpp");
+
+    for (auto col : {UINT_MAX - 1, 1u << 31, 1u << 20, 1u << 16, (1u << 16) - 1}) {
+        source_location loc{a, 7, col};
+        BOOST_CHECK(loc.is_valid());
+
+        auto dloc = loc.decode();
+        BOOST_CHECK(dloc.file == a);
+        BOOST_CHECK_EQUAL(dloc.line, 7u);
+        BOOST_CHECK_EQUAL(dloc.column, UINT_MAX);
+    }
+
+    auto dloc = source_location{a, UINT_MAX, (1u << 16) - 2}.decode();
+    BOOST_CHECK_EQUAL(dloc.line, UINT_MAX);
+    BOOST_CHECK_EQUAL(dloc.column, (1u << 16) - 2);
+}
+
+
+/// Tests exhausting slabs of source location tables and decoding
+/// identifiers of destroyed tables
+BOOST_AUTO_TEST_CASE(source_location_exhausted) {
+    std::uint32_t stale = 0;
+    {
+        code_model cm2;
+        stale = source_location{cm2.source("b.cpp"), 1, 1}.id();
+    }
+
+    BOOST_CHECK(stale != 0);
+    BOOST_CHECK(source_location_table::decode(stale).file == nullptr);
+
+    // each table takes slab for its first location
+    std::vector<std::unique_ptr<source_location_table>> tables;
+    std::vector<std::unique_ptr<source_file>> files;
+    while (true) {
+        auto & tbl = *tables.emplace_back(std::make_unique<source_location_table>());
+        auto & file = *files.emplace_back(std::make_unique<source_file>("c.cpp", tbl));
+        if (tbl.encode(&file, 1, 1) == 0) {
+            break;
+        }
+
+        BOOST_REQUIRE(tables.size() <= 65536u);
+    }
+
+    BOOST_CHECK_EQUAL(tables.back()->num_dropped(), 1u);
+
+    // destroyed table returns its slab
+    tables.front().reset();
+    auto id = tables.back()->encode(files.back().get(), 1, 1);
+    BOOST_CHECK(id != 0);
+    BOOST_CHECK(source_location_table::decode(id).file == files.back().get());
+}
+
+
+/// Tests tables of source locations owned by code models
+BOOST_AUTO_TEST_CASE(source_location_tables) {
+    auto a = cm.source("a.cpp");
+    source_location loc1{a, 1, 1};
+
+    // single location takes single span
+    BOOST_CHECK_EQUAL(cm.locations().num_spans(), 1u);
+
+    // locations of other code model are decoded without reference to code model
+    {
+        code_model cm2;
+        auto b = cm2.source("b.cpp");
+        source_location loc2{b, 3, 4};
+        BOOST_CHECK(loc1 != loc2);
+        BOOST_CHECK(loc2.decode().file == b);
+        BOOST_CHECK_EQUAL(loc2.decode().line, 3u);
+        BOOST_CHECK_EQUAL(cm2.locations().num_spans(), 1u);
+    }
+
+    // lines of the same source file share spans
+    for (unsigned int line = 1; line <= 1000; ++line) {
+        source_location loc{a, line, line % 60};
+        auto dloc = loc.decode();
+        BOOST_CHECK_EQUAL(dloc.line, line);
+        BOOST_CHECK_EQUAL(dloc.column, line % 60);
+    }
+
+    BOOST_CHECK(cm.locations().num_spans() < 100u);
+    BOOST_CHECK(loc1.decode().file == a);
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -18,7 +18,8 @@ namespace cm::test {
 
 class mock_context: public context {
 public:
-    mock_context(): context(nullptr), context_entity(nullptr) {}
+    explicit mock_context(name_table * names):
+        context(nullptr, names, nullptr), context_entity(nullptr) {}
 
     access_level default_access_level() const override {
         return access_level::public_;
@@ -32,7 +33,8 @@ public:
 
 struct context_test_fixture {
     code_model cm;
-    mock_context ctx;
+    name_table names;
+    mock_context ctx{&names};
 };
 
 
@@ -68,6 +70,73 @@ BOOST_AUTO_TEST_CASE(create_enum) {
 }
 
 
+/// Tests filtering entities of several kinds in order of declaration
+BOOST_AUTO_TEST_CASE(filter_entities_order) {
+    auto rec = cm.create_named_record("rec");
+    auto f1 = rec->create_field("f1", cm.bt_int());
+    auto v1 = rec->create_var("v1", cm.bt_int());
+    rec->create_typedef("td", cm.bt_int());
+    auto f2 = rec->create_field("f2", cm.bt_char());
+
+    std::vector<const variable*> vars;
+    std::ranges::copy(rec->entities<variable>(), std::back_inserter(vars));
+    BOOST_CHECK((vars == std::vector<const variable*>{f1, v1, f2}));
+
+    rec->remove_entity(v1);
+
+    std::vector<const field*> fields;
+    std::ranges::copy(rec->fields(), std::back_inserter(fields));
+    BOOST_CHECK((fields == std::vector<const field*>{f1, f2}));
+    BOOST_CHECK(rec->vars().empty());
+}
+
+
+/// Tests removing entities and adding new entities after removing
+BOOST_AUTO_TEST_CASE(remove_entities) {
+    std::vector<typedef_type*> tds;
+    for (int i = 0; i < 10; ++i) {
+        tds.push_back(ctx.create_typedef("td" + std::to_string(i), cm.bt_int()));
+    }
+
+    // removing all typedefs except the last two
+    for (int i = 0; i < 8; ++i) {
+        ctx.remove_entity(tds[i]);
+    }
+
+    BOOST_CHECK(ctx.find_typedef("td0") == nullptr);
+    BOOST_CHECK(*std::ranges::begin(ctx.entities()) == tds[8]);
+
+    // adding new entities compacts removed entities
+    auto td10 = ctx.create_typedef("td10", cm.bt_int());
+    auto en = ctx.create_enum("en", cm.bt_int());
+
+    std::vector<const context_entity*> ents;
+    std::ranges::copy(ctx.entities(), std::back_inserter(ents));
+    BOOST_CHECK((ents == std::vector<const context_entity*>{tds[8], tds[9], td10, en}));
+
+    std::vector<const typedef_type*> typedefs;
+    std::ranges::copy(ctx.typedefs(), std::back_inserter(typedefs));
+    BOOST_CHECK((typedefs == std::vector<const typedef_type*>{tds[8], tds[9], td10}));
+
+    ctx.clear();
+    BOOST_CHECK(ctx.entities().empty());
+    BOOST_CHECK(ctx.typedefs().empty());
+    BOOST_CHECK(ctx.find_typedef("td9") == nullptr);
+}
+
+
+/// Tests renaming entities in context
+BOOST_AUTO_TEST_CASE(rename_entity) {
+    auto td = ctx.create_typedef("td", cm.bt_int());
+    ctx.rename_entity(td, "td2");
+
+    BOOST_CHECK_EQUAL(td->name(), "td2");
+    BOOST_CHECK(ctx.find_typedef("td") == nullptr);
+    BOOST_CHECK(ctx.find_typedef("td2") == td);
+    BOOST_CHECK(td->name_symbol() == ctx.names().intern("td2"));
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -0,0 +1,79 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file line_table_test.cpp
+/// Contains unit tests for the line_table class.
+
+#include "pch.hpp"
+#include "cm/line_table.hpp"
+#include <boost/test/unit_test.hpp>
+#include <utility>
+
+
+namespace cm::test {
+
+
+/// Pair of line and column numbers returned by line table
+using position = std::pair<unsigned int, unsigned int>;
+
+
+BOOST_AUTO_TEST_SUITE(line_table_test)
+
+
+/// Tests table of empty text
+BOOST_AUTO_TEST_CASE(empty_text) {
+    line_table tbl{""};
+    BOOST_TEST(tbl.size() == 1u);
+    BOOST_CHECK(tbl.position(0) == position(1, 1));
+}
+
+
+/// Tests table of text with multiple lines
+BOOST_AUTO_TEST_CASE(multiple_lines) {
+    line_table tbl{"ab\ncde\nf"};
+    BOOST_TEST(tbl.size() == 3u);
+    BOOST_CHECK(tbl.position(0) == position(1, 1));
+    BOOST_CHECK(tbl.position(2) == position(1, 3));
+    BOOST_CHECK(tbl.position(3) == position(2, 1));
+    BOOST_CHECK(tbl.position(6) == position(2, 4));
+    BOOST_CHECK(tbl.position(7) == position(3, 1));
+}
+
+
+/// Tests table of text ending with line separator
+BOOST_AUTO_TEST_CASE(trailing_newline) {
+    line_table tbl{"ab\n"};
+    BOOST_TEST(tbl.size() == 2u);
+    BOOST_CHECK(tbl.position(2) == position(1, 3));
+    BOOST_CHECK(tbl.position(3) == position(2, 1));
+}
+
+
+/// Tests table of text with "\r\n" line separators, '\r' is the last column
+/// of line
+BOOST_AUTO_TEST_CASE(crlf) {
+    line_table tbl{"ab\r\nc\r\n"};
+    BOOST_TEST(tbl.size() == 3u);
+    BOOST_CHECK(tbl.position(2) == position(1, 3));
+    BOOST_CHECK(tbl.position(3) == position(1, 4));
+    BOOST_CHECK(tbl.position(4) == position(2, 1));
+    BOOST_CHECK(tbl.position(5) == position(2, 2));
+    BOOST_CHECK(tbl.position(7) == position(3, 1));
+}
+
+
+/// Tests offset at the end of text without trailing line separator
+BOOST_AUTO_TEST_CASE(end_of_text) {
+    line_table tbl{"a\nbc"};
+    BOOST_TEST(tbl.size() == 2u);
+    BOOST_CHECK(tbl.position(4) == position(2, 3));
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+}
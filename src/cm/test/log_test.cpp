@@ -0,0 +1,149 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file log_test.cpp
+/// Contains unit tests for log categories and log level options.
+
+#include "pch.hpp"
+#include "cm/log/log.hpp"
+#include "cm/log/log_init.hpp"
+#include <boost/log/attributes/value_extraction.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/log/sinks/sync_frontend.hpp>
+#include <boost/program_options.hpp>
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+
+
+namespace bl = boost::log;
+
+
+namespace cm::test {
+
+
+/// Sink backend collecting categories of log records
+class category_backend: public bl::sinks::basic_sink_backend<bl::sinks::synchronized_feeding> {
+public:
+    /// Collects category of record
+    void consume(const bl::record_view & rec) {
+        categories.push_back(bl::extract_or_default<std::string>("Category", rec, std::string{}));
+    }
+
+    std::vector<std::string> categories;    ///< Categories of written records
+};
+
+
+struct log_test_fixture {
+    log_test_fixture() {
+        bl::core::get()->add_sink(sink);
+    }
+
+    ~log_test_fixture() {
+        bl::core::get()->remove_sink(sink);
+        bl::core::get()->reset_filter();
+        log::set_category_levels(bl::trivial::trace, {});
+    }
+
+    /// Configures log with specified log level option
+    static void init_levels(const char * spec) {
+        namespace po = boost::program_options;
+        const char * argv[] = {"cm-test", "--log-level", spec};
+        po::variables_map vars;
+        po::store(po::parse_command_line(3, argv, log::log_options()), vars);
+        log::log_init(vars, false);
+    }
+
+    boost::shared_ptr<category_backend> backend = boost::make_shared<category_backend>();
+    boost::shared_ptr<bl::sinks::synchronous_sink<category_backend>> sink =
+        boost::make_shared<bl::sinks::synchronous_sink<category_backend>>(backend);
+};
+
+
+BOOST_FIXTURE_TEST_SUITE(log_test, log_test_fixture)
+
+
+/// Tests setting levels of categories and subcategories from log level option
+BOOST_AUTO_TEST_CASE(category_levels) {
+    // category created before setting levels gets new level
+    auto & cat_a = log::get_category("log-test-a");
+
+    init_levels("warning,log-test-a:debug,log-test-b/sub:error");
+
+    BOOST_TEST(cat_a.enabled(bl::trivial::debug));
+    BOOST_TEST(!cat_a.enabled(bl::trivial::trace));
+
+    // subcategory inherits level of category
+    BOOST_TEST(log::get_category("log-test-a/sub").enabled(bl::trivial::debug));
+
+    // subcategory with own level
+    auto & cat_b_sub = log::get_category("log-test-b/sub");
+    BOOST_TEST(!cat_b_sub.enabled(bl::trivial::warning));
+    BOOST_TEST(cat_b_sub.enabled(bl::trivial::error));
+
+    // categories without levels use global level
+    BOOST_TEST(!log::get_category("log-test-b").enabled(bl::trivial::info));
+    BOOST_TEST(log::get_category("log-test-b").enabled(bl::trivial::warning));
+    BOOST_TEST(log::get_category("log-test-c").enabled(bl::trivial::warning));
+}
+
+
+/// Tests malformed log level options
+BOOST_AUTO_TEST_CASE(malformed_levels) {
+    BOOST_CHECK_THROW(init_levels("verbose"), std::runtime_error);
+    BOOST_CHECK_THROW(init_levels("info,log-test-a:loud"), std::runtime_error);
+    BOOST_CHECK_THROW(init_levels("info,log-test-a:"), std::runtime_error);
+    BOOST_CHECK_THROW(init_levels("info,"), std::runtime_error);
+}
+
+
+/// Tests suppressing records of disabled categories without evaluating
+/// arguments of log statements
+BOOST_AUTO_TEST_CASE(disabled_category) {
+    init_levels("info,log-test-off:error,log-test-on:debug");
+
+    int evaluated = 0;
+    auto arg = [&] { return ++evaluated; };
+
+    CM_LOG_INFO(log-test-off) << arg();
+    CM_LOG_SCAT_WARNING(log-test-off, sub) << arg();
+    BOOST_TEST(evaluated == 0);
+
+    CM_LOG_ERROR(log-test-off) << arg();
+    CM_LOG_DEBUG(log-test-on) << arg();
+    CM_LOG_TRACE(log-test-on) << arg();
+
+    // enabled statements may be compiled out by minimum level
+    std::vector<std::string> expected;
+    if (bl::trivial::error >= log::min_level) {
+        expected.push_back("log-test-off");
+    }
+
+    if (bl::trivial::debug >= log::min_level) {
+        expected.push_back("log-test-on");
+    }
+
+    BOOST_TEST(evaluated == static_cast<int>(expected.size()));
+    BOOST_TEST(backend->categories == expected, boost::test_tools::per_element());
+}
+
+
+/// Tests compiling out log statements below minimum level
+BOOST_AUTO_TEST_CASE(min_level) {
+    init_levels("trace");
+
+    for (auto level : {bl::trivial::trace, bl::trivial::debug, bl::trivial::info,
+                       bl::trivial::warning, bl::trivial::error, bl::trivial::fatal}) {
+        BOOST_TEST(CM_LOG_ENABLED("log-test-min", level) == (level >= log::min_level));
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+}
@@ -0,0 +1,134 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file pointer_map_test.cpp
+/// Contains unit tests for the pointer_map class.
+
+#include "pch.hpp"
+#include "cm/pointer_map.hpp"
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+
+namespace cm::test {
+
+
+struct pointer_map_test_fixture {
+    pointer_map_test_fixture(): keys(4096), values(4096) {}
+
+    std::vector<int> keys;          ///< Objects used as keys
+    std::vector<int> values;        ///< Objects used as values
+    pointer_map<int, int> map;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE(pointer_map_test, pointer_map_test_fixture)
+
+
+/// Tests inserting and finding entries
+BOOST_AUTO_TEST_CASE(insert_find) {
+    BOOST_TEST(map.empty());
+    BOOST_TEST(map.find(&keys[0]) == nullptr);
+
+    BOOST_TEST(map.insert(&keys[0], &values[0]));
+    BOOST_TEST(map.insert(&keys[1], &values[1]));
+    BOOST_TEST(map.size() == 2u);
+    BOOST_TEST(map.find(&keys[0]) == &values[0]);
+    BOOST_TEST(map.find(&keys[1]) == &values[1]);
+    BOOST_TEST(map.find(&keys[2]) == nullptr);
+
+    // existing key is not changed
+    BOOST_TEST(!map.insert(&keys[0], &values[2]));
+    BOOST_TEST(map.find(&keys[0]) == &values[0]);
+    BOOST_TEST(map.size() == 2u);
+}
+
+
+/// Tests growing table while inserting entries
+BOOST_AUTO_TEST_CASE(rehash) {
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        BOOST_TEST(map.insert(&keys[i], &values[i]));
+    }
+
+    BOOST_TEST(map.size() == keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        BOOST_TEST(map.find(&keys[i]) == &values[i]);
+    }
+
+    map.clear();
+    BOOST_TEST(map.empty());
+    BOOST_TEST(map.find(&keys[0]) == nullptr);
+
+    // reserved table keeps entries added after reserving
+    map.reserve(100);
+    for (std::size_t i = 0; i < 100; ++i) {
+        map.insert(&keys[i], &values[i]);
+    }
+
+    BOOST_TEST(map.find(&keys[99]) == &values[99]);
+}
+
+
+/// Tests erasing entries and inserting them again
+BOOST_AUTO_TEST_CASE(erase) {
+    BOOST_TEST(!map.erase(&keys[0]));
+
+    for (std::size_t i = 0; i < 1000; ++i) {
+        map.insert(&keys[i], &values[i]);
+    }
+
+    // erasing every other entry keeps other entries reachable
+    for (std::size_t i = 0; i < 1000; i += 2) {
+        BOOST_TEST(map.erase(&keys[i]));
+    }
+
+    BOOST_TEST(!map.erase(&keys[0]));
+    BOOST_TEST(map.size() == 500u);
+    for (std::size_t i = 0; i < 1000; ++i) {
+        BOOST_TEST(map.find(&keys[i]) == (i % 2 == 0 ? nullptr : &values[i]));
+    }
+
+    // inserting erased keys with other values
+    for (std::size_t i = 0; i < 1000; i += 2) {
+        BOOST_TEST(map.insert(&keys[i], &values[i + 1]));
+    }
+
+    BOOST_TEST(map.size() == 1000u);
+    for (std::size_t i = 0; i < 1000; ++i) {
+        BOOST_TEST(map.find(&keys[i]) == &values[i % 2 == 0 ? i + 1 : i]);
+    }
+}
+
+
+/// Tests random sequence of inserting and erasing entries against standard map
+BOOST_AUTO_TEST_CASE(random_operations) {
+    std::mt19937 rnd{42};
+    std::unordered_map<const int*, int*> expected;
+
+    for (unsigned int n = 0; n < 100000; ++n) {
+        auto i = rnd() % 300;
+        if (rnd() % 3 == 0) {
+            BOOST_REQUIRE(map.erase(&keys[i]) == (expected.erase(&keys[i]) != 0));
+        } else {
+            BOOST_REQUIRE(map.insert(&keys[i], &values[i]) ==
+                          expected.emplace(&keys[i], &values[i]).second);
+        }
+    }
+
+    BOOST_TEST(map.size() == expected.size());
+    for (std::size_t i = 0; i < 300; ++i) {
+        auto it = expected.find(&keys[i]);
+        BOOST_TEST(map.find(&keys[i]) == (it != expected.end() ? it->second : nullptr));
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+}
@@ -0,0 +1,233 @@
+// Copyright (c) 2024, Alexandr Esilevich
+// 
+// Distributed under the BSD 2-Clause License.
+// See accompanying file LICENSE for license information.
+//
+
+/// \file record_queue_test.cpp
+/// Contains unit tests for queue of asynchronous log sinks.
+
+#include "pch.hpp"
+#include "cm/log/log.hpp"
+#include "cm/log/log_init.hpp"
+#include "cm/log/record_queue.hpp"
+#include <boost/log/attributes/value_extraction.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/program_options.hpp>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace bl = boost::log;
+
+
+namespace cm::test {
+
+
+/// Sink backend collecting messages of log records. Writing records may be
+/// blocked for filling queue of sink
+class test_backend: public bl::sinks::basic_sink_backend<bl::sinks::synchronized_feeding> {
+public:
+    /// Collects message of record, waits while writing is blocked
+    void consume(const bl::record_view & rec) {
+        std::unique_lock lock{mutex_};
+        entered_ = true;
+        cond_.notify_all();
+        cond_.wait(lock, [&] { return !blocked_; });
+        messages_.push_back(bl::extract_or_default<std::string>("Message", rec, std::string{}));
+    }
+
+    /// Blocks or unblocks writing records
+    void block(bool b) {
+        std::lock_guard lock{mutex_};
+        blocked_ = b;
+        cond_.notify_all();
+    }
+
+    /// Waits until writing of record starts
+    void wait_entered() {
+        std::unique_lock lock{mutex_};
+        cond_.wait(lock, [&] { return entered_; });
+    }
+
+    /// Returns messages of written records
+    std::vector<std::string> messages() {
+        std::lock_guard lock{mutex_};
+        return messages_;
+    }
+
+private:
+    std::mutex mutex_;                      ///< Protects backend
+    std::condition_variable cond_;          ///< Signaled when backend state changes
+    bool blocked_ = false;                  ///< Writing records is blocked
+    bool entered_ = false;                  ///< Writing of record started
+    std::vector<std::string> messages_;     ///< Messages of written records
+};
+
+
+/// Asynchronous sink with test backend
+using test_sink = bl::sinks::asynchronous_sink<test_backend, log::record_queue>;
+
+
+struct record_queue_test_fixture {
+    record_queue_test_fixture() {
+        bl::core::get()->reset_filter();
+    }
+
+    ~record_queue_test_fixture() {
+        if (sink) {
+            bl::core::get()->remove_sink(sink);
+            sink->close();
+            sink->stop();
+        }
+    }
+
+    /// Creates sink with specified limits and adds it to log core
+    void make_sink(std::size_t max_size, log::overflow_policy policy, bool start_thread) {
+        sink = boost::make_shared<test_sink>(backend, start_thread);
+        sink->set_limits(max_size, policy);
+        bl::core::get()->add_sink(sink);
+    }
+
+    /// Logs specified number of records with numbered messages
+    static void log_records(unsigned int num) {
+        for (unsigned int i = 0; i < num; ++i) {
+            BOOST_LOG_SEV(log::get_logger(), bl::trivial::info) << i;
+        }
+    }
+
+    boost::shared_ptr<test_backend> backend = boost::make_shared<test_backend>();
+    boost::shared_ptr<test_sink> sink;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE(record_queue_test, record_queue_test_fixture)
+
+
+/// Tests dropping records logged when queue is full
+BOOST_AUTO_TEST_CASE(drop_full) {
+    make_sink(4, log::overflow_policy::drop, false);
+    log_records(10);
+    BOOST_TEST(sink->size() == 4u);
+    BOOST_TEST(sink->dropped() == 6u);
+
+    sink->flush();
+    BOOST_TEST(sink->size() == 0u);
+    BOOST_TEST(backend->messages() == (std::vector<std::string>{"0", "1", "2", "3"}),
+               boost::test_tools::per_element());
+}
+
+
+/// Tests writing records from several threads without dropping them. Feeding
+/// thread may pop record before logging thread counts it, which must not
+/// make queue look full
+BOOST_AUTO_TEST_CASE(threads) {
+    for (auto policy : {log::overflow_policy::block, log::overflow_policy::drop}) {
+        backend = boost::make_shared<test_backend>();
+        auto max_size = policy == log::overflow_policy::block ? 2 : 1 << 20;
+        make_sink(max_size, policy, true);
+
+        std::vector<std::thread> threads;
+        for (unsigned int t = 0; t < 4; ++t) {
+            threads.emplace_back([] { log_records(1000); });
+        }
+
+        for (auto && t : threads) {
+            t.join();
+        }
+
+        sink->flush();
+        BOOST_TEST(sink->dropped() == 0u);
+        BOOST_TEST(sink->size() == 0u);
+        BOOST_TEST(backend->messages().size() == 4000u);
+
+        bl::core::get()->remove_sink(sink);
+        sink->stop();
+        sink.reset();
+    }
+}
+
+
+/// Tests closing queue with logging thread blocked by full queue while
+/// feeding thread is writing record
+BOOST_AUTO_TEST_CASE(close_blocked) {
+    backend->block(true);
+    make_sink(2, log::overflow_policy::block, true);
+
+    std::thread producer{[] { log_records(10); }};
+
+    // feeding thread writes record 0, records 1 and 2 fill queue
+    backend->wait_entered();
+    for (int i = 0; i < 1000 && sink->size() != 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    BOOST_TEST(sink->size() == 2u);
+
+    // logging thread drops records instead of waiting for stopped sink
+    sink->close();
+    producer.join();
+    BOOST_TEST(sink->dropped() == 7u);
+
+    backend->block(false);
+    bl::core::get()->remove_sink(sink);
+    sink->stop();
+    sink->flush();
+    BOOST_TEST(backend->messages() == (std::vector<std::string>{"0", "1", "2"}),
+               boost::test_tools::per_element());
+}
+
+
+/// Tests configuring asynchronous sinks with log options
+BOOST_AUTO_TEST_CASE(async_options) {
+    namespace po = boost::program_options;
+    auto log_file = std::filesystem::temp_directory_path() / "cm-test-log" / "log.txt";
+    std::filesystem::remove(log_file);
+
+    // invalid overflow policy
+    auto parse = [](std::vector<const char *> args) {
+        args.insert(args.begin(), "cm-test");
+        po::variables_map vars;
+        po::store(po::parse_command_line(static_cast<int>(args.size()), args.data(),
+                                         log::log_options()), vars);
+        return vars;
+    };
+
+    BOOST_CHECK_THROW(log::log_init(parse({"--log-async", "--log-overflow", "wait"}), false),
+                      std::runtime_error);
+
+    auto vars = parse({"--log-async", "--log-queue-size", "8", "--log-overflow", "drop",
+                       "--log-file", log_file.c_str()});
+    BOOST_TEST(vars["log-queue-size"].as<std::size_t>() == 8u);
+
+    log::log_init(vars, false);
+    log_records(3);
+    log::log_shutdown();
+
+    // records are written by shutdown
+    std::ifstream str{log_file};
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(str, line);) {
+        lines.push_back(line);
+    }
+
+    BOOST_TEST(lines.size() == 3u);
+    BOOST_TEST(lines.back().ends_with(" 2"));
+
+    bl::core::get()->remove_all_sinks();
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+}